@@ -184,6 +184,24 @@ namespace Podd {
     return SINT((((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
   }
 
+  //___________________________________________________________________________
+  inline UInt_t LowestSetBit( ULong64_t v )
+  {
+    // Index of the lowest set bit of 64-bit integer v. v must be nonzero.
+
+    assert(v != 0);
+#if defined(__GNUC__)
+    return static_cast<UInt_t>(__builtin_ctzll(v));
+#else
+    UInt_t n = 0;
+    while( !(v & 1) ) {
+      v >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
   //_____________________________________________________________________________
   template <typename VectorElem>
   void PrintArray( const std::vector<VectorElem>& arr )
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <cstdio>
 
 using namespace std;
 
@@ -67,6 +68,29 @@ vector<string> vsplit( const string& s )
   return tokens;
 }
 
+//_____________________________________________________________________________
+string JsonString( const char* str, UInt_t len )
+{
+  // Quote and escape the first 'len' characters of 'str' for output as
+  // a JSON string
+
+  string ret = "\"";
+  for( UInt_t i = 0; str && i < len && str[i]; ++i ) {
+    char c = str[i];
+    if( c == '"' || c == '\\' ) {
+      ret += '\\';
+      ret += c;
+    } else if( static_cast<unsigned char>(c) < 0x20 ) {
+      char hex[8];
+      snprintf(hex, sizeof(hex), "\\u%04x", static_cast<unsigned char>(c));
+      ret += hex;
+    } else
+      ret += c;
+  }
+  ret += '"';
+  return ret;
+}
+
 //_____________________________________________________________________________
 static string ValStr( const vector<string>& s )
 {
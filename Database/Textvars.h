@@ -20,6 +20,8 @@ void  Tokenize( const std::string& s, const std::string& delim,
                 std::vector<std::string>& tokens );
 void  Trim( std::string& str );
 std::vector<std::string> vsplit( const std::string& s );
+// First 'len' characters of 'str', quoted and escaped as a JSON string
+std::string JsonString( const char* str, UInt_t len = kMaxUInt );
 
 //_____________________________________________________________________________
 class Textvars {
@@ -14,13 +14,15 @@ FADCData.cxx               FadcBPM.cxx                 FadcCherenkov.cxx
 FadcRaster.cxx             FadcRasteredBeam.cxx        FadcUnRasteredBeam.cxx
 FadcScintillator.cxx       FadcShower.cxx
 THaADCHelicity.cxx         THaDecData.cxx              THaG0Helicity.cxx
-THaG0HelicityReader.cxx    THaHelicity.cxx             THaHRS.cxx
+THaG0HelicityReader.cxx    THaHelicity.cxx             THaHelicitySequence.cxx
+THaHRS.cxx
 THaQWEAKHelicity.cxx       THaQWEAKHelicityReader.cxx  THaS2CoincTime.cxx
 THaVDCAnalyticTTDConv.cxx  THaVDCChamber.cxx           THaVDCCluster.cxx
-THaVDC.cxx                 THaVDCHit.cxx               THaVDCPlane.cxx
-THaVDCPoint.cxx            THaVDCPointPair.cxx         THaVDCTimeToDistConv.cxx
-THaVDCTrackID.cxx          THaVDCWire.cxx              TrigBitLoc.cxx
-VDCeff.cxx                 TwoarmVDCTimeCorrection.cxx
+THaVDCClusterFitter.cxx    THaVDC.cxx                  THaVDCHit.cxx
+THaVDCPlane.cxx            THaVDCPoint.cxx             THaVDCPointPair.cxx
+THaVDCTableTTDConv.cxx     THaVDCTimeToDistConv.cxx    THaVDCTrackID.cxx
+THaVDCWire.cxx
+TrigBitLoc.cxx             VDCeff.cxx                  TwoarmVDCTimeCorrection.cxx
 """
 
 build_library(baseenv, libname, src, useenv = False, versioned = True)
@@ -15,10 +15,14 @@
 #include "THaEvData.h"
 #include "TH1F.h"
 #include "TMath.h"
+#include "THaHelicitySequence.h"
+#include "Checkpoint.h"
 #include <iostream>
 #include <cmath>
+#include <vector>
 
 using namespace std;
+using HallA::HelicitySequence;
 
 // Default parameters
 static const Double_t kDefaultTdavg = 14050.;
@@ -231,6 +235,80 @@ Int_t THaG0Helicity::End( THaRunBase* )
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaG0Helicity::WriteCheckpoint( TDirectory* dir )
+{
+  // Save the quartet timing and helicity prediction state, so that a
+  // resumed analysis does not have to re-synchronize.
+
+  vector<Double_t> state{
+    fTdavg, fTdiff, fT0, fT9, Double_t(fT0T9), Double_t(fQuad_calibrated),
+    Double_t(fRecovery_flag), fTlastquad, Double_t(fFirstquad),
+    fLastTimestamp, fTimeLastQ1, Double_t(fT9count),
+    Double_t(fPredicted_reading), Double_t(fQ1_reading),
+    Double_t(fSaved_helicity), Double_t(fQ1_present_helicity),
+    Double_t(fNqrt), Double_t(fNB), Double_t(fIseed), Double_t(fIseed_earlier),
+    Double_t(fInquad), Double_t(fTET9Index), Double_t(fTELastEvtQrt),
+    fTELastEvtTime, fTELastTime, Double_t(fTEPresentReadingQ1),
+    Double_t(fTEStartup), fTETime, Double_t(fTEType9),
+    fTimestamp, fOldT1, fOldT2, fOldT3
+  };
+  state.insert(state.end(), fHbits, fHbits+kNbits);
+  return Podd::Checkpoint::WriteArray(dir, Form("%sstate",GetPrefix()), state);
+}
+
+//_____________________________________________________________________________
+Int_t THaG0Helicity::ReadCheckpoint( TDirectory* dir )
+{
+  // Restore the state saved by WriteCheckpoint
+
+  const Int_t nstate = 33 + kNbits;
+  vector<Double_t> state;
+  if( Podd::Checkpoint::ReadArray(dir, Form("%sstate",GetPrefix()), state)
+      != nstate ) {
+    Error( Here("ReadCheckpoint"), "Saved helicity state not found" );
+    return -1;
+  }
+  auto it = state.cbegin();
+  auto next = [&it]() { return *it++; };
+  fTdavg               = next();
+  fTdiff               = next();
+  fT0                  = next();
+  fT9                  = next();
+  fT0T9                = (next() != 0);
+  fQuad_calibrated     = (next() != 0);
+  fRecovery_flag       = (next() != 0);
+  fTlastquad           = next();
+  fFirstquad           = Int_t(next());
+  fLastTimestamp       = next();
+  fTimeLastQ1          = next();
+  fT9count             = Int_t(next());
+  fPredicted_reading   = Int_t(next());
+  fQ1_reading          = Int_t(next());
+  fSaved_helicity      = static_cast<EHelicity>(Int_t(next()));
+  fQ1_present_helicity = static_cast<EHelicity>(Int_t(next()));
+  fNqrt                = UInt_t(next());
+  fNB                  = Int_t(next());
+  fIseed               = UInt_t(next());
+  fIseed_earlier       = UInt_t(next());
+  fInquad              = Int_t(next());
+  fTET9Index           = Int_t(next());
+  fTELastEvtQrt        = Int_t(next());
+  fTELastEvtTime       = next();
+  fTELastTime          = next();
+  fTEPresentReadingQ1  = Int_t(next());
+  fTEStartup           = Int_t(next());
+  fTETime              = next();
+  fTEType9             = (next() != 0);
+  fTimestamp           = next();
+  fOldT1               = next();
+  fOldT2               = next();
+  fOldT3               = next();
+  for( auto& bit : fHbits )
+    bit = Int_t(next());
+  return 0;
+}
+
 //_____________________________________________________________________________
 void THaG0Helicity::SetDebug( Int_t level )
 {
@@ -413,16 +491,17 @@ void THaG0Helicity::QuadCalib()
 	  fT0 += fTdavg;
 	  fT0T9 = false;
 	}
-	QuadHelicity(1);
-	fNqrt++;
+      }
+      // Jump the predictor ahead over all missed quads at once
+      SkipQuads(nqmiss);
 
-	fQ1_reading = (fPredicted_reading == -1) ? 0 : 1;
+      fQ1_reading = (fPredicted_reading == -1) ? 0 : 1;
 
-	fQ1_present_helicity = fPresent_helicity;
-	if (fDebug>=1) {
-	  Info(Here(here)," %5d  M  M %1d %2d  %10.0f  %10.0f  %10.0f Missing",
-	       fNqrt,fQ1_reading,fQ1_present_helicity,fTimestamp,fT0,fTdiff);
-	}
+      fQ1_present_helicity = fPresent_helicity;
+      if (fDebug>=1) {
+	Info(Here(here)," %5d  M  M %1d %2d  %10.0f  %10.0f  %10.0f Missing %d",
+	     fNqrt,fQ1_reading,fQ1_present_helicity,fTimestamp,fT0,fTdiff,
+	     nqmiss);
       }
       fTdiff = fTimestamp - fT0;
     } else { 
@@ -629,12 +708,12 @@ void THaG0Helicity::QuadHelicity( Int_t cond )
     fNB++;
     fQuad_calibrated = false;
   } else if (fNB == kNbits) {   // Have finished loading
-    fIseed_earlier = GetSeed();
-    fIseed = fIseed_earlier;
-    for( int i = 0; i < kNbits+1; i++) {
-      fPredicted_reading = RanBit(0);
-      RanBit(1);
-    }
+    const HelicitySequence& seq = HelicitySequence::G0();
+    // The seed reproduces the kNbits loaded readings. Jump ahead to the
+    // prediction for the present quad.
+    UInt_t seed = GetSeed();
+    fPredicted_reading = seq.Predict(seed, kNbits+1) ? kPlus : kMinus;
+    fIseed_earlier = fIseed = seq.Advance(seed, kNbits+1);
 
     if( fPredicted_reading > 0 )
       fPresent_helicity = kPlus;
@@ -644,8 +723,11 @@ void THaG0Helicity::QuadHelicity( Int_t cond )
       fPresent_helicity = kUnknown;
 
     // Delay by fG0delay windows which is fG0delay/4 quads
-    for( int i = 0; i < fG0delay/4; i++)
-      fPresent_helicity = RanBit(1);
+    Int_t ndelay = fG0delay/4;
+    if( ndelay > 0 ) {
+      fPresent_helicity = seq.Predict(fIseed, ndelay) ? kPlus : kMinus;
+      fIseed = seq.Advance(fIseed, ndelay);
+    }
     fNB++;
     fSaved_helicity = fPresent_helicity;
     fQuad_calibrated = true;
@@ -667,6 +749,24 @@ void THaG0Helicity::QuadHelicity( Int_t cond )
   }
 }
 
+//_____________________________________________________________________________
+void THaG0Helicity::SkipQuads( Int_t n )
+{
+  // Advance the calibrated predictor by n quads in one go. Equivalent to
+  // n calls of QuadHelicity(1), but independent of n in cost.
+
+  if( n <= 0 )
+    return;
+  const HelicitySequence& seq = HelicitySequence::G0();
+  fTlastquad = fT0;
+  fPredicted_reading = seq.Predict(fIseed_earlier, n) ? kPlus : kMinus;
+  fIseed_earlier = seq.Advance(fIseed_earlier, n);
+  fSaved_helicity = fPresent_helicity =
+    seq.Predict(fIseed, n) ? kPlus : kMinus;
+  fIseed = seq.Advance(fIseed, n);
+  fNqrt += n;
+}
+
 //_____________________________________________________________________________
 THaHelicityDet::EHelicity THaG0Helicity::RanBit( int which )
 {
@@ -705,17 +805,11 @@ THaHelicityDet::EHelicity THaG0Helicity::RanBit( int which )
 //_____________________________________________________________________________
 UInt_t THaG0Helicity::GetSeed()
 {
-  int seedbits[kNbits];
+  // Seed of the G0 generator whose first kNbits outputs are the
+  // readings collected in fHbits
+
   UInt_t ranseed = 0;
-  for (int i = 0; i < 20; i++)
-    seedbits[23-i] = fHbits[i];
-  seedbits[3] = fHbits[20]^seedbits[23];
-  seedbits[2] = fHbits[21]^seedbits[22]^seedbits[23];
-  seedbits[1] = fHbits[22]^seedbits[21]^seedbits[22];
-  seedbits[0] = fHbits[23]^seedbits[20]^seedbits[21]^seedbits[23];
-  for (int i=kNbits-1; i >= 0; i--) 
-    ranseed = ranseed<<1|(seedbits[i]&1);
-  ranseed &= 0xFFFFFF;
+  HelicitySequence::G0().SeedFromBits(fHbits, ranseed);
   return ranseed;
 }
 
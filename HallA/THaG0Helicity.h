@@ -27,6 +27,8 @@ public:
   virtual void   Clear( Option_t* opt = "" );
   virtual Int_t  Decode( const THaEvData& evdata );
   virtual Int_t  End( THaRunBase* r=nullptr );
+  virtual Int_t  ReadCheckpoint( TDirectory* dir );
+  virtual Int_t  WriteCheckpoint( TDirectory* dir );
   virtual void   SetDebug( Int_t level );
   virtual Bool_t HelicityValid() const { return fValidHel; }
 
@@ -44,6 +46,7 @@ protected:
   void      QuadCalib();
   void      LoadHelicity();
   void      QuadHelicity(Int_t cond=0);
+  void      SkipQuads(Int_t n);
   EHelicity RanBit(Int_t i);
   UInt_t    GetSeed();
   Bool_t    CompHel();
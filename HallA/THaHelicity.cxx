@@ -8,7 +8,9 @@
 #include "THaHelicity.h"
 #include "THaEvData.h"
 #include "VarDef.h"
+#include "Checkpoint.h"
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -136,6 +138,32 @@ Int_t THaHelicity::Decode( const THaEvData& evdata )
 
   return kOK;
 }
+
+//____________________________________________________________________
+Int_t THaHelicity::WriteCheckpoint( TDirectory* dir )
+{
+  // Save the last event's G0 timestamps, used to check the next one
+
+  vector<Double_t> state{ fOldT1, fOldT2, fOldT3 };
+  return Podd::Checkpoint::WriteArray(dir, Form("%sstate",GetPrefix()), state);
+}
+
+//____________________________________________________________________
+Int_t THaHelicity::ReadCheckpoint( TDirectory* dir )
+{
+  // Restore the state saved by WriteCheckpoint
+
+  vector<Double_t> state;
+  if( Podd::Checkpoint::ReadArray(dir, Form("%sstate",GetPrefix()), state)
+      != 3 ) {
+    Error( Here("ReadCheckpoint"), "Saved helicity state not found" );
+    return -1;
+  }
+  fOldT1 = state[0];
+  fOldT2 = state[1];
+  fOldT3 = state[2];
+  return 0;
+}
  
 
 ClassImp(THaHelicity)
@@ -24,6 +24,8 @@ public:
 
   virtual void   Clear( Option_t* opt = "" );
   virtual Int_t  Decode( const THaEvData& evdata );
+  virtual Int_t  ReadCheckpoint( TDirectory* dir );
+  virtual Int_t  WriteCheckpoint( TDirectory* dir );
 
   THaHelicity();  // For ROOT RTTI
   
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaHelicitySequence                                                       //
+//                                                                           //
+// Shared engine for the pseudo-random helicity generators (G0: 24 bits,     //
+// QWEAK: 30 bits). Both are linear feedback shift registers, i.e. one step  //
+// is a linear map A over GF(2). The constructor derives A from the single-  //
+// step function and tabulates A^(2^k), k = 0..31, as byte-wise lookup       //
+// tables (4 lookups and 3 XORs per application). Advancing the register by  //
+// n steps then takes at most 32 table applications, regardless of n.        //
+//                                                                           //
+// The next 8 output bits are a linear function of the state as well and are //
+// tabulated the same way, so that long sequences are generated and verified //
+// one byte at a time. Finally, the map from a state to its next nbits       //
+// outputs is inverted once, so a seed can be computed from observed bits    //
+// directly.                                                                 //
+//                                                                           //
+// Typical uses: predict the helicity many windows ahead, resynchronize      //
+// after missed windows without re-iterating the register, and check long   //
+// stretches of delayed helicity bits against the expected sequence.         //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "THaHelicitySequence.h"
+#include <cassert>
+
+using namespace std;
+
+namespace HallA {
+
+//_____________________________________________________________________________
+HelicitySequence::HelicitySequence( UInt_t nbits, StepFunc_t step,
+                                    OutputFunc_t output )
+  : fNbits(nbits), fMask(0), fOutMask(0), fJump(kNjump), fOut8{},
+    fCanSeed(false)
+{
+  // Constructor. Builds all lookup tables from the single-step function
+  // 'step' and the output function 'output' of a generator with 'nbits'
+  // state bits.
+
+  assert( nbits > 0 && nbits <= 32 );
+  fMask = (nbits < 32) ? (1U << nbits) - 1 : ~0U;
+
+  // Columns of the one-step matrix and the output functional
+  UInt_t cols[32] = {};
+  for( UInt_t j = 0; j < fNbits; ++j ) {
+    cols[j] = step(1U << j) & fMask;
+    if( output(1U << j) & 1 )
+      fOutMask |= 1U << j;
+  }
+  // Jump tables for 2^k steps, by repeated squaring
+  for( UInt_t k = 0; k < kNjump; ++k ) {
+    FillTable(fJump[k], cols);
+    for( UInt_t j = 0; j < fNbits; ++j )
+      cols[j] = Apply(k, cols[j]);
+  }
+
+  // Output bits 0-7 and 0-(nbits-1) for each basis state
+  UInt_t out8[32] = {};
+  vector<UInt_t> rows(fNbits, 0);
+  for( UInt_t j = 0; j < fNbits; ++j ) {
+    UInt_t s = 1U << j;
+    for( UInt_t i = 0; i < fNbits || i < 8; ++i ) {
+      UInt_t bit = Output(s);
+      if( i < 8 )
+        out8[j] |= bit << i;
+      if( i < fNbits )
+        rows[i] |= bit << j;
+      s = Step(s);
+    }
+  }
+  for( UInt_t b = 0; b < 4; ++b ) {
+    for( UInt_t v = 0; v < 256; ++v ) {
+      UInt_t x = 0;
+      for( UInt_t i = 0; i < 8 && 8*b+i < 32; ++i )
+        if( v & (1U << i) )
+          x ^= out8[8*b+i];
+      fOut8[b][v] = static_cast<UChar_t>(x);
+    }
+  }
+
+  // Invert the output matrix (row i: output i as function of the state)
+  // by Gauss-Jordan elimination. fSeedRows[j] then gives state bit j as
+  // function of the observed bits.
+  vector<UInt_t> inv(fNbits);
+  for( UInt_t i = 0; i < fNbits; ++i )
+    inv[i] = 1U << i;
+  fCanSeed = true;
+  for( UInt_t c = 0; c < fNbits && fCanSeed; ++c ) {
+    UInt_t p = c;
+    while( p < fNbits && !(rows[p] & (1U << c)) )
+      ++p;
+    if( p == fNbits ) {
+      fCanSeed = false;
+      break;
+    }
+    swap(rows[p], rows[c]);
+    swap(inv[p], inv[c]);
+    for( UInt_t i = 0; i < fNbits; ++i ) {
+      if( i != c && (rows[i] & (1U << c)) ) {
+        rows[i] ^= rows[c];
+        inv[i] ^= inv[c];
+      }
+    }
+  }
+  if( fCanSeed )
+    fSeedRows.swap(inv);
+}
+
+//_____________________________________________________________________________
+UInt_t HelicitySequence::Parity( UInt_t v )
+{
+  v ^= v >> 16;
+  v ^= v >> 8;
+  v ^= v >> 4;
+  return (0x6996U >> (v & 0xf)) & 1;
+}
+
+//_____________________________________________________________________________
+void HelicitySequence::FillTable( Table_t& t, const UInt_t* cols )
+{
+  // Tabulate the linear map with the given columns (images of the basis
+  // states) for each byte of the state
+
+  for( UInt_t b = 0; b < 4; ++b ) {
+    for( UInt_t v = 0; v < 256; ++v ) {
+      UInt_t x = 0;
+      for( UInt_t i = 0; i < 8; ++i )
+        if( v & (1U << i) )
+          x ^= cols[8*b+i];
+      t.t[b][v] = x;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+UInt_t HelicitySequence::Advance( UInt_t state, UInt_t n ) const
+{
+  // State after n steps from 'state'
+
+  for( UInt_t k = 0; n; ++k, n >>= 1 )
+    if( n & 1 )
+      state = Apply(k, state);
+  return state;
+}
+
+//_____________________________________________________________________________
+UInt_t HelicitySequence::Predict( UInt_t state, UInt_t n ) const
+{
+  // Bit produced by the n-th step from 'state' (n = 1: next bit)
+
+  assert( n > 0 );
+  return Output(Advance(state, n-1));
+}
+
+//_____________________________________________________________________________
+UInt_t HelicitySequence::Generate( UInt_t state, UInt_t n,
+                                   UChar_t* packed ) const
+{
+  // Write the next n output bits into 'packed', 8 bits per byte, first bit
+  // in the least significant bit. 'packed' must hold (n+7)/8 bytes.
+  // Returns the state after n steps.
+
+  UInt_t nbytes = n / 8, rest = n % 8;
+  for( UInt_t i = 0; i < nbytes; ++i ) {
+    packed[i] = static_cast<UChar_t>(Output8(state));
+    state = Apply(3, state);
+  }
+  if( rest ) {
+    packed[nbytes] = static_cast<UChar_t>(Output8(state) & ((1U << rest) - 1));
+    state = Advance(state, rest);
+  }
+  return state;
+}
+
+//_____________________________________________________________________________
+UInt_t HelicitySequence::Verify( UInt_t state, const UChar_t* packed,
+                                 UInt_t n ) const
+{
+  // Compare n bits in 'packed' (same layout as in Generate) with the
+  // sequence generated from 'state'. Returns the number of leading bits
+  // that agree, i.e. n if all bits agree.
+
+  UInt_t nbytes = (n + 7) / 8;
+  for( UInt_t i = 0; i < nbytes; ++i ) {
+    UInt_t diff = (Output8(state) ^ packed[i]) & 0xff;
+    if( i == nbytes-1 && n % 8 )
+      diff &= (1U << (n % 8)) - 1;
+    if( diff ) {
+      UInt_t ibit = 0;
+      while( !(diff & (1U << ibit)) )
+        ++ibit;
+      return 8*i + ibit;
+    }
+    state = Apply(3, state);
+  }
+  return n;
+}
+
+//_____________________________________________________________________________
+Bool_t HelicitySequence::SeedFromBits( const Int_t* bits, UInt_t& state ) const
+{
+  // Compute the state whose next nbits outputs are bits[0..nbits-1]
+
+  if( !fCanSeed )
+    return false;
+  UInt_t b = 0;
+  for( UInt_t i = 0; i < fNbits; ++i )
+    b |= static_cast<UInt_t>(bits[i] & 1) << i;
+  state = 0;
+  for( UInt_t j = 0; j < fNbits; ++j )
+    state |= Parity(fSeedRows[j] & b) << j;
+  return true;
+}
+
+//_____________________________________________________________________________
+static UInt_t G0Step( UInt_t s )
+{
+  // G0 generator, see "G0 Helicity Digital Controls" by E. Stangland,
+  // R. Flood, H. Dong, July 2002. Same as THaG0Helicity::RanBit.
+  const UInt_t MASK = BIT(0)+BIT(2)+BIT(3)+BIT(23);
+  return ( (s & BIT(23)) ? ((s^MASK)<<1) | BIT(0) : s<<1 ) & 0xFFFFFF;
+}
+
+static UInt_t G0Output( UInt_t s )
+{
+  return (s >> 23) & 1;
+}
+
+//_____________________________________________________________________________
+static UInt_t QWEAKOutput( UInt_t s )
+{
+  // QWEAK generator, feedback from bits 30, 29, 28 and 7 (1-based).
+  // Same as THaQWEAKHelicity::RanBit30.
+  return ((s >> 29) ^ (s >> 28) ^ (s >> 27) ^ (s >> 6)) & 1;
+}
+
+static UInt_t QWEAKStep( UInt_t s )
+{
+  return ((s << 1) | QWEAKOutput(s)) & 0x3FFFFFFF;
+}
+
+//_____________________________________________________________________________
+const HelicitySequence& HelicitySequence::G0()
+{
+  static const HelicitySequence seq(24, G0Step, G0Output);
+  return seq;
+}
+
+//_____________________________________________________________________________
+const HelicitySequence& HelicitySequence::QWEAK()
+{
+  static const HelicitySequence seq(30, QWEAKStep, QWEAKOutput);
+  return seq;
+}
+
+} // namespace HallA
@@ -0,0 +1,84 @@
+#ifndef Podd_HallA_HelicitySequence_h_
+#define Podd_HallA_HelicitySequence_h_
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaHelicitySequence                                                       //
+//                                                                           //
+// Jump-ahead engine for pseudo-random helicity shift registers              //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <vector>
+
+namespace HallA {
+
+  class HelicitySequence {
+
+  public:
+    // Single step of the generator and the bit it produces (0 or 1).
+    // Both must be linear over GF(2) in the state bits.
+    typedef UInt_t (*StepFunc_t)( UInt_t state );
+    typedef UInt_t (*OutputFunc_t)( UInt_t state );
+
+    HelicitySequence( UInt_t nbits, StepFunc_t step, OutputFunc_t output );
+
+    // State after one step
+    UInt_t   Step( UInt_t state ) const { return Apply(0, state); }
+    // Bit produced by the next step from 'state'
+    UInt_t   Output( UInt_t state ) const { return Parity(state & fOutMask); }
+    // State after n steps, in O(log n)
+    UInt_t   Advance( UInt_t state, UInt_t n ) const;
+    // Bit produced by the n-th step (n >= 1) from 'state'
+    UInt_t   Predict( UInt_t state, UInt_t n ) const;
+
+    // Generate the next n bits, packed 8 per byte (LSB first).
+    // Returns the state after n steps.
+    UInt_t   Generate( UInt_t state, UInt_t n, UChar_t* packed ) const;
+    // Number of leading bits of 'packed' (n bits, 8 per byte, LSB first)
+    // that agree with the sequence generated from 'state'
+    UInt_t   Verify( UInt_t state, const UChar_t* packed, UInt_t n ) const;
+
+    // State that generates the given nbits bits (values 0/1) as its next
+    // outputs. Returns false if the output sequence does not determine
+    // the state uniquely.
+    Bool_t   SeedFromBits( const Int_t* bits, UInt_t& state ) const;
+
+    UInt_t   GetNbits() const { return fNbits; }
+    UInt_t   GetMask()  const { return fMask; }
+
+    // Generators in use at JLab
+    static const HelicitySequence& G0();     // 24-bit, G0 electronics
+    static const HelicitySequence& QWEAK();  // 30-bit, QWEAK electronics
+
+  private:
+    enum { kNjump = 32 };     // Jump tables for 2^0 ... 2^31 steps
+    struct Table_t {          // Linear map, applied byte-wise
+      UInt_t t[4][256];
+    };
+
+    UInt_t   fNbits;          // Number of bits in shift register
+    UInt_t   fMask;           // Mask of valid state bits
+    UInt_t   fOutMask;        // Output bit = parity(state & fOutMask)
+    std::vector<Table_t> fJump;  // fJump[k]: 2^k steps, byte-wise
+    UChar_t  fOut8[4][256];   // Next 8 output bits, byte-wise
+    std::vector<UInt_t> fSeedRows;  // Rows of inverse output matrix
+    Bool_t   fCanSeed;        // Output sequence determines state
+
+    UInt_t   Apply( UInt_t k, UInt_t state ) const {
+      const auto& t = fJump[k].t;
+      return t[0][state & 0xff] ^ t[1][(state >> 8) & 0xff] ^
+        t[2][(state >> 16) & 0xff] ^ t[3][state >> 24];
+    }
+    UInt_t   Output8( UInt_t state ) const {
+      return fOut8[0][state & 0xff] ^ fOut8[1][(state >> 8) & 0xff] ^
+        fOut8[2][(state >> 16) & 0xff] ^ fOut8[3][state >> 24];
+    }
+    static UInt_t Parity( UInt_t v );
+    static void   FillTable( Table_t& t, const UInt_t* cols );
+  };
+
+} // namespace HallA
+
+#endif
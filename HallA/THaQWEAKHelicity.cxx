@@ -15,9 +15,13 @@
 #include "THaEvData.h"
 #include "TH1F.h"
 #include "TMath.h"
+#include "THaHelicitySequence.h"
+#include "Checkpoint.h"
 #include <iostream>
+#include <vector>
 
 using namespace std;
+using HallA::HelicitySequence;
 
 //_____________________________________________________________________________
 THaQWEAKHelicity::THaQWEAKHelicity( const char* name, const char* description,
@@ -306,6 +310,49 @@ Int_t THaQWEAKHelicity::End( THaRunBase* )
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaQWEAKHelicity::WriteCheckpoint( TDirectory* dir )
+{
+  // Save the seed and pattern phase of the helicity predictor and the
+  // last input register readings, so that a resumed analysis does not
+  // have to gather the seed again.
+
+  vector<Double_t> state{
+    Double_t(fRing_NSeed), Double_t(fRingSeed_reported),
+    Double_t(fRingSeed_actual), Double_t(fRingPhase_reported),
+    Double_t(fRing_reported_polarity), Double_t(fRing_actual_polarity),
+    Double_t(fHelicityLastTIR), Double_t(fPatternLastTIR),
+    Double_t(fOldTimeStampTir)
+  };
+  return Podd::Checkpoint::WriteArray(dir, Form("%sstate",GetPrefix()), state);
+}
+
+//_____________________________________________________________________________
+Int_t THaQWEAKHelicity::ReadCheckpoint( TDirectory* dir )
+{
+  // Restore the state saved by WriteCheckpoint
+
+  const Int_t nstate = 9;
+  vector<Double_t> state;
+  if( Podd::Checkpoint::ReadArray(dir, Form("%sstate",GetPrefix()), state)
+      != nstate ) {
+    Error( Here("ReadCheckpoint"), "Saved helicity state not found" );
+    return -1;
+  }
+  auto it = state.cbegin();
+  auto next = [&it]() { return UInt_t(*it++); };
+  fRing_NSeed              = next();
+  fRingSeed_reported       = next();
+  fRingSeed_actual         = next();
+  fRingPhase_reported      = next();
+  fRing_reported_polarity  = next();
+  fRing_actual_polarity    = next();
+  fHelicityLastTIR         = next();
+  fPatternLastTIR          = next();
+  fOldTimeStampTir         = next();
+  return 0;
+}
+
 //_____________________________________________________________________________
 void THaQWEAKHelicity::SetDebug( Int_t level )
 {
@@ -387,16 +434,14 @@ void THaQWEAKHelicity::LoadHelicity( UInt_t eventnumber )
 	  if (fRing_NSeed==fMAXBIT)
 	    {
 	      fRingSeed_actual=fRingSeed_reported;
-	      UInt_t advance=0;
-	      //take the delay into account
-	      for(UInt_t j=0;j<fQWEAKDelay;j++)
-		{	      
-		  advance+=1;
-		  if( advance == fQWEAKNPattern)
-		    {
-		      fRing_actual_polarity=RanBit30(fRingSeed_actual);
-		      advance=0;
-		    }
+	      //take the delay into account: one step of the generator
+	      //per complete pattern
+	      UInt_t npattern = fQWEAKNPattern > 0 ? fQWEAKDelay/fQWEAKNPattern : 0;
+	      if( npattern > 0 )
+		{
+		  const HelicitySequence& seq = HelicitySequence::QWEAK();
+		  fRing_actual_polarity=seq.Predict(fRingSeed_actual,npattern);
+		  fRingSeed_actual=seq.Advance(fRingSeed_actual,npattern);
 		}
 	    }
 	}
@@ -463,18 +508,21 @@ void THaQWEAKHelicity::LoadHelicity( UInt_t eventnumber )
 	{
 	  fTSettle=0;
 	  UInt_t localfPhase=fRingPhase_reported;
-	  UInt_t localfSeed=fRingSeed_actual;
 	  UInt_t localfPolarity=fRing_actual_polarity;
-	  
+	  UInt_t nnew=0;
+
 	  for(UInt_t i=0; i<fOffsetTIRvsRing;i++)
 	    {
 	      localfPhase+=1;
 	      if( localfPhase == fQWEAKNPattern)
 		{
 		  localfPhase=0;
-		  localfPolarity=RanBit30(localfSeed);
+		  nnew++;
 		}
 	    }
+	  // Polarity of the last pattern started
+	  if( nnew > 0 )
+	    localfPolarity=HelicitySequence::QWEAK().Predict(fRingSeed_actual,nnew);
 	  fHelicity=SetHelicity(localfPolarity,localfPhase);
 	  if(fPatternTir==1)
 	    fQrt=1;
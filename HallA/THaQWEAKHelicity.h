@@ -30,6 +30,8 @@ public:
   virtual Int_t  End( THaRunBase* r=nullptr );
   virtual void   SetDebug( Int_t level );
   virtual Bool_t HelicityValid() const { return fValidHel; }
+  virtual Int_t  ReadCheckpoint( TDirectory* dir );
+  virtual Int_t  WriteCheckpoint( TDirectory* dir );
 
   void PrintEvent( UInt_t evtnum );
 
@@ -27,7 +27,9 @@
 #include "TROOT.h"
 #include "THaString.h"
 #include "TimeCorrectionModule.h"
+#include "EventArena.h"
 #include <map>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
@@ -348,6 +350,7 @@ Int_t THaVDC::ReadDatabase( const TDatime& date )
   fCoordType = kRotatingTransport;
   Int_t disable_tracking = 0, disable_finetrack = 0, only_fastest_hit = 1;
   Int_t do_tdc_hardcut = 1, do_tdc_softcut = 0, ignore_negdrift = 0;
+  Int_t fast_clustering = 0, batch_fit = 0;
 #ifdef MCDATA
   Int_t mc_data = 0;
 #endif
@@ -363,6 +366,8 @@ Int_t THaVDC::ReadDatabase( const TDatime& date )
     { "do_tdc_hardcut",    &do_tdc_hardcut,    kInt,    0, true },
     { "do_tdc_softcut",    &do_tdc_softcut,    kInt,    0, true },
     { "ignore_negdrift",   &ignore_negdrift,   kInt,    0, true },
+    { "fast_clustering",   &fast_clustering,   kInt,    0, true },
+    { "batch_fit",         &batch_fit,         kInt,    0, true },
 #ifdef MCDATA
     { "MCdata",            &mc_data,           kInt,    0, true },
 #endif
@@ -379,6 +384,9 @@ Int_t THaVDC::ReadDatabase( const TDatime& date )
   SetBit( kHardTDCcut,      do_tdc_hardcut );
   SetBit( kSoftTDCcut,      do_tdc_softcut );
   SetBit( kIgnoreNegDrift,  ignore_negdrift );
+  SetBit( kFastClust,       fast_clustering );
+  SetBit( kBatchFit,        batch_fit > 0 );
+  SetBit( kCheckFit,        batch_fit > 1 );
 #ifdef MCDATA
   SetBit( kMCdata,          mc_data );
 #endif
@@ -420,14 +428,18 @@ Int_t THaVDC::ReadDatabase( const TDatime& date )
 
   if( fDebug > 0 ) {
 #ifdef MCDATA
-    Info( Here(here), "VDC flags fastest/hardcut/softcut/noneg/mcdata/"
-          "decode/coarse = %d/%d/%d/%d/%d/%d/%d", TestBit(kOnlyFastest),
-          TestBit(kHardTDCcut), TestBit(kSoftTDCcut), TestBit(kIgnoreNegDrift),
-          TestBit(kMCdata), TestBit(kDecodeOnly), TestBit(kCoarseOnly) );
+    Info( Here(here), "VDC flags fastest/hardcut/softcut/noneg/fastclust/"
+          "batchfit/mcdata/decode/coarse = %d/%d/%d/%d/%d/%d/%d/%d/%d",
+          TestBit(kOnlyFastest), TestBit(kHardTDCcut), TestBit(kSoftTDCcut),
+          TestBit(kIgnoreNegDrift), TestBit(kFastClust),
+          TestBit(kBatchFit) + TestBit(kCheckFit), TestBit(kMCdata),
+          TestBit(kDecodeOnly), TestBit(kCoarseOnly) );
 #else
-    Info( Here(here), "VDC flags fastest/hardcut/softcut/noneg/"
-          "decode/coarse = %d/%d/%d/%d/%d/%d", TestBit(kOnlyFastest),
-          TestBit(kHardTDCcut), TestBit(kSoftTDCcut), TestBit(kIgnoreNegDrift),
+    Info( Here(here), "VDC flags fastest/hardcut/softcut/noneg/fastclust/"
+          "batchfit/decode/coarse = %d/%d/%d/%d/%d/%d/%d/%d",
+          TestBit(kOnlyFastest), TestBit(kHardTDCcut), TestBit(kSoftTDCcut),
+          TestBit(kIgnoreNegDrift), TestBit(kFastClust),
+          TestBit(kBatchFit) + TestBit(kCheckFit),
           TestBit(kDecodeOnly), TestBit(kCoarseOnly) );
 #endif
   }
@@ -446,6 +458,9 @@ Int_t THaVDC::ReadDatabase( const TDatime& date )
 
   CalcMatrix(1.,fLMatrixElems); // tensor without explicit polynomial in x_fp
 
+  // Build the flat evaluation table for the target optics
+  CompileOptics();
+
   fIsInit = true;
   return kOK;
 }
@@ -629,8 +644,10 @@ Int_t THaVDC::ConstructTracks( TClonesArray* tracks, Int_t mode )
     if (tracks) {
 
       // Decide whether this is a new track or an old track
-      // that is being updated
-      auto* thisID = new THaVDCTrackID(lowerPoint,upperPoint);
+      // that is being updated. Track IDs live in our event arena and so
+      // are released by Clear().
+      auto* thisID =
+        GetEventArena().New<THaVDCTrackID>(lowerPoint,upperPoint);
       THaTrack* theTrack = nullptr;
       bool found = false;
       int t = 0;
@@ -658,15 +675,14 @@ Int_t THaVDC::ConstructTracks( TClonesArray* tracks, Int_t mode )
         if( fDebug>1 )
           cout << "Track " << t << " modified.\n";
 #endif
-        delete thisID;
         ++n_mod;
       } else {
 #ifdef WITH_DEBUG
         if( fDebug>1 )
           cout << "Track " << tracks->GetLast()+1 << " added.\n";
 #endif
-        theTrack = AddTrack(*tracks, 0.0, 0.0, 0.0, 0.0, thisID );
-        //	theTrack->SetID( thisID );
+        theTrack = AddTrack(*tracks, 0.0, 0.0, 0.0, 0.0);
+        theTrack->SetID( thisID, false );
         //	theTrack->SetCreator( this );
         theTrack->AddCluster( lowerPoint );
         theTrack->AddCluster( upperPoint );
@@ -836,10 +852,32 @@ Int_t THaVDC::FindVertices( TClonesArray& tracks )
   // Assumes that CoarseTrack() and FineTrack() have both been called.
 
   Int_t n_exist = tracks.GetLast()+1;
-  for( Int_t t = 0; t < n_exist; t++ ) {
+  if( n_exist <= 0 )
+    return 0;
+
+  // Gather the focal plane coordinates of all tracks and evaluate the
+  // target optics for all of them in a single pass
+  const UInt_t n = n_exist;
+  fFPbuf.resize(n * OpticsTable::kNFPVAR);
+  fTGbuf.resize(n * OpticsTable::kNTGVAR);
+  for( UInt_t t = 0; t < n; t++ ) {
     auto* theTrack = static_cast<THaTrack*>( tracks.At(t) );
-    CalcTargetCoords(theTrack);
+    GetFPCoords(theTrack, &fFPbuf[t * OpticsTable::kNFPVAR]);
   }
+  fOptics.Eval(fFPbuf.data(), fTGbuf.data(), n);
+  fTrackBuf.Resize(n);
+  for( UInt_t t = 0; t < n; t++ ) {
+    auto* theTrack = static_cast<THaTrack*>( tracks.At(t) );
+    SetTargetCoords(theTrack, &fTGbuf[t * OpticsTable::kNTGVAR]);
+    fTrackBuf.p[t]  = theTrack->GetP();
+    fTrackBuf.th[t] = theTrack->GetTTheta();
+    fTrackBuf.ph[t] = theTrack->GetTPhi();
+  }
+
+  // Lab momenta of all tracks in one pass
+  auto* app = static_cast<THaSpectrometer*>(GetApparatus());
+  app->TracksToLab(fTrackBuf);
+  fTrackBuf.StorePvect(tracks);
 
   return 0;
 }
@@ -914,71 +952,215 @@ void THaVDC::CalcFocalPlaneCoords( THaTrack* track )
 }
 
 //_____________________________________________________________________________
-void THaVDC::CalcTargetCoords( THaTrack* track )
+void THaVDC::GetFPCoords( const THaTrack* track, Double_t* fp ) const
 {
-  // calculates target coordinates from focal plane coordinates
-
-  const Int_t kNUM_PRECOMP_POW = 10;
+  // Copy the focal plane coordinates that serve as input to the target
+  // optics into fp[OpticsTable::kNFPVAR]
 
-  // first select the coords to use
-  Double_t x_fp, y_fp, th_fp, ph_fp;
   if( fCoordType == kTransport ) {
-    x_fp = track->GetX();
-    y_fp = track->GetY();
-    th_fp = track->GetTheta();
-    ph_fp = track->GetPhi();
+    fp[OpticsTable::kX]    = track->GetX();
+    fp[OpticsTable::kTh]   = track->GetTheta();
+    fp[OpticsTable::kYfp]  = track->GetY();
+    fp[OpticsTable::kPh]   = track->GetPhi();
   } else {  // kRotatingTransport
-    x_fp = track->GetRX();
-    y_fp = track->GetRY();
-    th_fp = track->GetRTheta();
-    ph_fp = track->GetRPhi();
-  }
-
-  // calculate the powers we need
-  Double_t powers[kNUM_PRECOMP_POW][5];  // {(x), th, y, ph, abs(th) }
-  for(int i=0; i<kNUM_PRECOMP_POW; i++) {
-    powers[i][0] = pow(x_fp, i);
-    powers[i][1] = pow(th_fp, i);
-    powers[i][2] = pow(y_fp, i);
-    powers[i][3] = pow(ph_fp, i);
-    powers[i][4] = pow(TMath::Abs(th_fp),i);
+    fp[OpticsTable::kX]    = track->GetRX();
+    fp[OpticsTable::kTh]   = track->GetRTheta();
+    fp[OpticsTable::kYfp]  = track->GetRY();
+    fp[OpticsTable::kPh]   = track->GetRPhi();
   }
+}
 
-  // calculate the matrices we need
-  CalcMatrix(x_fp, fDMatrixElems);
-  CalcMatrix(x_fp, fTMatrixElems);
-  CalcMatrix(x_fp, fYMatrixElems);
-  CalcMatrix(x_fp, fYTAMatrixElems);
-  CalcMatrix(x_fp, fPMatrixElems);
-  CalcMatrix(x_fp, fPTAMatrixElems);
-
-  // calculate the coordinates at the target
-  Double_t theta = CalcTargetVar(fTMatrixElems, powers);
-  Double_t phi = CalcTargetVar(fPMatrixElems, powers) +
-                 CalcTargetVar(fPTAMatrixElems, powers);
-  Double_t y = CalcTargetVar(fYMatrixElems, powers) +
-               CalcTargetVar(fYTAMatrixElems, powers);
+//_____________________________________________________________________________
+void THaVDC::SetTargetCoords( THaTrack* track, const Double_t* tg ) const
+{
+  // Store the target quantities tg[OpticsTable::kNTGVAR] with the track.
+  // The lab momentum is calculated by the caller.
 
   auto* app = static_cast<THaSpectrometer*>(GetApparatus());
-  // calculate momentum
-  Double_t dp = CalcTargetVar(fDMatrixElems, powers);
-  Double_t p  = app->GetPcentral() * (1.0+dp);
 
-  // pathlength matrix is for the Transport coord plane
-  Double_t pathl = CalcTarget2FPLen(fLMatrixElems, powers);
+  Double_t theta = tg[OpticsTable::kTheta];
+  Double_t phi   = tg[OpticsTable::kPhi];
+  Double_t y     = tg[OpticsTable::kY];
+  Double_t dp    = tg[OpticsTable::kDelta];
+  Double_t p     = app->GetPcentral() * (1.0+dp);
 
   //FIXME: estimate x ??
   Double_t x = 0.0;
 
-  // Save the target quantities with the tracks
   track->SetTarget(x, y, theta, phi);
   track->SetDp(dp);
   track->SetMomentum(p);
-  track->SetPathLen(pathl);
+  // pathlength matrix is for the Transport coord plane
+  track->SetPathLen(tg[OpticsTable::kPathl]);
+}
+
+//_____________________________________________________________________________
+void THaVDC::CalcTargetCoords( THaTrack* track )
+{
+  // calculates target coordinates from focal plane coordinates
+
+  Double_t fp[OpticsTable::kNFPVAR], tg[OpticsTable::kNTGVAR];
+  GetFPCoords(track, fp);
+  fOptics.Eval(fp, tg);
+  SetTargetCoords(track, tg);
+
+  auto* app = static_cast<THaSpectrometer*>(GetApparatus());
+  app->TransportToLab( track->GetP(), track->GetTTheta(), track->GetTPhi(),
+                       track->GetPvect() );
+}
 
-  app->TransportToLab( p, theta, phi, track->GetPvect() );
+//_____________________________________________________________________________
+void THaVDC::CompileOptics()
+{
+  // Merge all target matrix elements into the flat evaluation table
+
+  fOptics.clear();
+  fOptics.Add(fDMatrixElems,   OpticsTable::kDelta);
+  fOptics.Add(fTMatrixElems,   OpticsTable::kTheta);
+  fOptics.Add(fYMatrixElems,   OpticsTable::kY);
+  fOptics.Add(fYTAMatrixElems, OpticsTable::kY);
+  fOptics.Add(fPMatrixElems,   OpticsTable::kPhi);
+  fOptics.Add(fPTAMatrixElems, OpticsTable::kPhi);
+  // The pathlength tensor has an explicit exponent for x_fp instead of
+  // a polynomial
+  fOptics.Add(fLMatrixElems,   OpticsTable::kPathl, true);
 }
 
+//_____________________________________________________________________________
+void THaVDC::OpticsTable::clear()
+{
+  // Reset the table
+
+  fPowers.clear();
+  fCoef.clear();
+  for( Int_t& pw : fMaxPw )
+    pw = 0;
+  fNterms = 0;
+}
+
+//_____________________________________________________________________________
+void THaVDC::OpticsTable::Add( const vector<THaMatrixElement>& matrix,
+                               ETgVar var, bool has_xpow )
+{
+  // Compile the given matrix elements, contributing to target variable 'var',
+  // into the table. Elements with identical exponent patterns share one
+  // table row. If has_xpow is true, the first exponent of each element
+  // applies to x_fp, and the element's x-polynomial is taken to have been
+  // evaluated already (i.e. ME.v is the coefficient); otherwise, the
+  // exponents refer to theta, y, phi (and |theta|), and the polynomial
+  // coefficients in x_fp are taken from ME.poly.
+
+  assert( var >= 0 && var < kNTGVAR );
+
+  for( const auto& ME : matrix ) {
+    if( ME.iszero || ME.order == 0 )
+      continue;
+    UChar_t pw[kNPOW] = { 0, 0, 0, 0, 0 };
+    Int_t ip = has_xpow ? kX : kTh;
+    assert( ME.pw.size() + static_cast<size_t>(ip) <=
+            static_cast<size_t>(kNPOW) );
+    for( auto it = ME.pw.begin(); it != ME.pw.end() && ip < kNPOW; ++it, ++ip ) {
+      assert( *it >= 0 && *it < kMAXPW );
+      pw[ip] = *it;
+      if( *it > fMaxPw[ip] )
+        fMaxPw[ip] = *it;
+    }
+    // Find the row for this exponent pattern, or append a new one
+    UInt_t nmono = GetNmono(), irow = 0;
+    for( ; irow < nmono; ++irow ) {
+      const UChar_t* p = &fPowers[irow*kNPOW];
+      if( equal(pw, pw+kNPOW, p) )
+        break;
+    }
+    if( irow == nmono ) {
+      fPowers.insert(fPowers.end(), pw, pw+kNPOW);
+      fCoef.resize(fCoef.size()+kNCOEF, 0.0);
+    }
+    Double_t* c = &fCoef[irow*kNCOEF + var*kPORDER];
+    if( has_xpow )
+      c[0] += ME.v;
+    else {
+      for( Int_t i = 0; i < ME.order; ++i )
+        c[i] += ME.poly[i];
+    }
+    ++fNterms;
+  }
+}
+
+//_____________________________________________________________________________
+void THaVDC::OpticsTable::Eval( const Double_t* fp, Double_t* tg,
+                                UInt_t n ) const
+{
+  // Evaluate all target variables for n tracks with focal plane coordinates
+  // fp[n][kNFPVAR]. Results are written to tg[n][kNTGVAR].
+  //
+  // For each track, the powers of the focal plane variables are tabulated
+  // once, the monomials of the table are multiplied into running sums of
+  // the x-polynomial coefficients (a fixed-length loop that vectorizes well),
+  // and each target variable is finally obtained with one Horner step in x.
+  // The results agree with the element-by-element evaluation of CalcMatrix
+  // and CalcTargetVar to within floating-point rounding.
+
+  const UInt_t nmono = GetNmono();
+  Double_t pwtab[kNPOW][kMAXPW];
+  Double_t sum[kNCOEF];
+
+  for( UInt_t it = 0; it < n; ++it, fp += kNFPVAR, tg += kNTGVAR ) {
+    const Double_t x = fp[kX];
+    const Double_t val[kNPOW] = { x, fp[kTh], fp[kYfp], fp[kPh],
+                                  TMath::Abs(fp[kTh]) };
+    for( Int_t i = 0; i < kNPOW; ++i ) {
+      Double_t* pw = pwtab[i];
+      pw[0] = 1.0;
+      for( Int_t j = 1; j <= fMaxPw[i]; ++j )
+        pw[j] = pw[j-1] * val[i];
+    }
+    for( Double_t& s : sum )
+      s = 0.0;
+
+    const UChar_t*  e = fPowers.data();
+    const Double_t* c = fCoef.data();
+    for( UInt_t m = 0; m < nmono; ++m, e += kNPOW, c += kNCOEF ) {
+      const Double_t mono = pwtab[0][e[0]] * pwtab[1][e[1]] * pwtab[2][e[2]]
+                            * pwtab[3][e[3]] * pwtab[4][e[4]];
+      for( Int_t k = 0; k < kNCOEF; ++k )
+        sum[k] += c[k] * mono;
+    }
+
+    for( Int_t i = 0; i < kNTGVAR; ++i ) {
+      const Double_t* s = sum + i*kPORDER;
+      Double_t v = s[kPORDER-1];
+      for( Int_t k = kPORDER-2; k >= 0; --k )
+        v = v * x + s[k];
+      tg[i] = v;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+void THaVDC::OpticsTable::Print() const
+{
+  // Print the compiled table
+
+  static const char* const tgnames[kNTGVAR] = { "D", "T", "Y", "P", "L" };
+
+  cout << "Compiled target optics: " << fNterms << " matrix elements in "
+       << GetNmono() << " monomials (x th y ph |th|)" << endl;
+  for( UInt_t m = 0; m < GetNmono(); ++m ) {
+    const UChar_t* e = &fPowers[m*kNPOW];
+    for( Int_t i = 0; i < kNPOW; ++i )
+      cout << "  " << setw(2) << static_cast<Int_t>(e[i]);
+    for( Int_t i = 0; i < kNTGVAR; ++i ) {
+      const Double_t* c = &fCoef[m*kNCOEF + i*kPORDER];
+      if( all_of(c, c+kPORDER, []( Double_t v ) { return v == 0.0; }) )
+        continue;
+      cout << "  " << tgnames[i] << ":";
+      for( Int_t k = 0; k < kPORDER; ++k )
+        cout << " " << setprecision(4) << c[k];
+    }
+    cout << endl;
+  }
+}
 
 //_____________________________________________________________________________
 void THaVDC::CalcMatrix( const Double_t x, vector<THaMatrixElement>& matrix )
@@ -1158,6 +1340,7 @@ void THaVDC::Print(const Option_t* opt) const
     PrintME("Transport Matrix:  P-terms", fPMatrixElems);
     PrintME("Transport Matrix:  PTA-terms", fPTAMatrixElems);
     PrintME("Matrix L", fLMatrixElems);
+    fOptics.Print();
   }
 }
 
@@ -1219,6 +1402,16 @@ void THaVDC::SetDebug( Int_t level )
   fUpper->SetDebug(level);
 }
 
+//_____________________________________________________________________________
+Int_t THaVDC::End( THaRunBase* run )
+{
+  // End-of-run processing of the VDC and the chamber/plane subdetectors
+
+  fLower->End(run);
+  fUpper->End(run);
+  return THaTrackingDetector::End(run);
+}
+
 //_____________________________________________________________________________
 // TODO: Change return type to std::optional once we support C++17
 std::pair<Double_t,bool> THaVDC::GetTimeCorrection() const
@@ -9,6 +9,7 @@
 
 #include "THaTrackingDetector.h"
 #include "TimeCorrectionModule.h"
+#include "TrackBuffer.h"
 #include <cassert>
 #include <utility>
 #include <string>
@@ -37,6 +38,7 @@ public:
   virtual Int_t CoarseTrack( TClonesArray& tracks );
   virtual Int_t FineTrack( TClonesArray& tracks );
   virtual Int_t FindVertices( TClonesArray& tracks );
+  virtual Int_t End( THaRunBase* run = nullptr );
   virtual EStatus Init( const TDatime& date );
   virtual void  SetDebug( Int_t level );
 
@@ -70,6 +72,9 @@ public:
     kHardTDCcut     = BIT(15), // Use hard TDC cuts (fMinTime, fMaxTime)
     kSoftTDCcut     = BIT(16), // Use soft TDC cut (reasonable estimated drifts)
     kIgnoreNegDrift = BIT(17), // Completely ignore negative drift times
+    kFastClust      = BIT(18), // Single-pass bitset-based cluster finding
+    kBatchFit       = BIT(19), // Fit all clusters of a plane in one batch
+    kCheckFit       = BIT(20), // Validate batch fits against FitTrack
 #ifdef MCDATA
     kMCdata         = BIT(21), // Assume input is Monte Carlo data
 #endif
@@ -97,6 +102,37 @@ public:
     std::vector<double> poly;// the associated polynomial
   };
 
+  // Precompiled form of the focal-plane-to-target optics matrices.
+  // All target matrices (D, T, Y, YTA, P, PTA, L) are merged into one flat
+  // table of unique monomials x^i theta^j y^k phi^l |theta|^m. Each monomial
+  // row holds, contiguously, the x-polynomial coefficients for every target
+  // variable to which it contributes. Evaluating a track then amounts to a
+  // dense multiply-accumulate over the table followed by one Horner step per
+  // target variable.
+  class OpticsTable {
+  public:
+    enum ETgVar { kDelta = 0, kTheta, kY, kPhi, kPathl, kNTGVAR };
+    enum EFPVar { kX = 0, kTh, kYfp, kPh, kNFPVAR };
+    enum { kNPOW = 5, kMAXPW = 10, kNCOEF = kNTGVAR*kPORDER };
+
+    OpticsTable() : fNterms(0) { clear(); }
+    void   clear();
+    void   Add( const std::vector<THaMatrixElement>& matrix, ETgVar var,
+                bool has_xpow = false );
+    // Evaluate target quantities for n tracks. 'fp' holds kNFPVAR values
+    // per track, 'tg' receives kNTGVAR values per track.
+    void   Eval( const Double_t* fp, Double_t* tg, UInt_t n = 1 ) const;
+    UInt_t GetNmono()  const { return fPowers.size()/kNPOW; }
+    UInt_t GetNterms() const { return fNterms; }
+    void   Print() const;
+
+  private:
+    std::vector<UChar_t>  fPowers;  // Exponents of each monomial (kNPOW each)
+    std::vector<Double_t> fCoef;    // kNCOEF coefficients per monomial
+    Int_t    fMaxPw[kNPOW];         // Highest exponent used for each variable
+    UInt_t   fNterms;               // Number of matrix elements compiled in
+  };
+
 protected:
 
   enum ECoordType { kTransport, kRotatingTransport };
@@ -140,10 +176,18 @@ protected:
 
   std::vector<THaMatrixElement> fLMatrixElems;   // Path-length corrections (meters)
 
+  OpticsTable fOptics;      // Compiled target optics (built from the above)
+  std::vector<Double_t> fFPbuf;  // Per-event focal plane coordinate buffer
+  std::vector<Double_t> fTGbuf;  // Per-event target coordinate buffer
+  Podd::TrackBuffer fTrackBuf;   //! Per-event target/lab coordinates
+
   Podd::TimeCorrectionModule* fTimeCorrectionModule;
 
   void CalcFocalPlaneCoords( THaTrack* track );
   void CalcTargetCoords( THaTrack* the_track );
+  void GetFPCoords( const THaTrack* track, Double_t* fp ) const;
+  void SetTargetCoords( THaTrack* track, const Double_t* tg ) const;
+  void CompileOptics();
   static void CalcMatrix( double x, std::vector<THaMatrixElement>& matrix );
 //  Double_t DoPoly(const int n, const std::vector<double> &a, const double x);
 //  Double_t PolyInv(const double x1, const double x2, const double xacc,
@@ -132,6 +132,16 @@ void THaVDCChamber::SetDebug( Int_t level )
   fV->SetDebug(level);
 }
 
+//_____________________________________________________________________________
+Int_t THaVDCChamber::End( THaRunBase* run )
+{
+  // End-of-run processing of this chamber and its plane subdetectors
+
+  fU->End(run);
+  fV->End(run);
+  return THaSubDetector::End(run);
+}
+
 //_____________________________________________________________________________
 PointCoords_t THaVDCChamber::CalcDetCoords( const THaVDCCluster* ucl,
 					    const THaVDCCluster* vcl ) const
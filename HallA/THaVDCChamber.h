@@ -38,6 +38,7 @@ public:
   virtual Int_t   FineTrack();            // More precisely calculate track
   virtual EStatus Init( const TDatime& date );
   virtual void    SetDebug( Int_t level );
+  virtual Int_t   End( THaRunBase* run = nullptr );
 
   PointCoords_t   CalcDetCoords( const THaVDCCluster* u,
 				 const THaVDCCluster* v ) const;
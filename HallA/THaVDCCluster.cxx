@@ -56,6 +56,7 @@ void THaVDCCluster::Clear( Option_t* )
 
   ClearFit();
   fHits.clear();
+  fCoord.clear();
   fPivot   = nullptr;
   fPlane   = nullptr;
   fPointPair = nullptr;
@@ -63,6 +64,7 @@ void THaVDCCluster::Clear( Option_t* )
   fTrkNum  = 0;
   fClsBeg  = kMaxInt-1;
   fClsEnd  = -1;
+  fTimeCorrection = 0;
 }
 
 //_____________________________________________________________________________
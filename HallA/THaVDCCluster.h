@@ -30,6 +30,8 @@ namespace VDC {
   typedef std::vector<THaVDCHit*> Vhit_t;
   typedef std::vector<FitCoord_t> Vcoord_t;
 
+  class ClusterFitter;
+
   inline chi2_t operator+( chi2_t a, const chi2_t& b ) {
     a.first  += b.first;
     a.second += b.second;
@@ -39,6 +41,8 @@ namespace VDC {
 
 class THaVDCCluster : public TObject {
 
+  friend class VDC::ClusterFitter;
+
 public:
 
   explicit THaVDCCluster( THaVDCPlane* owner = nullptr );
@@ -0,0 +1,333 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaVDCClusterFitter                                                       //
+//                                                                           //
+// Fits all clusters of a VDC plane in one batch. The hit data of all        //
+// clusters are copied into contiguous arrays (wire positions, drift         //
+// distances, weights). For each cluster, the weighted sums for all drift    //
+// sign hypotheses are accumulated in one pass over the hits, with the       //
+// hypotheses in the (vectorizable) inner loop, and likewise for the chi2.   //
+// There are no per-hit virtual calls and no repeated passes per hypothesis. //
+//                                                                           //
+// The fits are the same as THaVDCCluster::FitSimpleTrack (modes kSimple     //
+// and kWeighted) and THaVDCCluster::LinearClusterFitWithT0 (mode kT0),      //
+// with the same arithmetic per hypothesis and the same hypothesis choice.   //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "THaVDCClusterFitter.h"
+#include "THaVDCHit.h"
+#include "THaVDCPlane.h"
+#include "TClonesArray.h"
+#include "TMath.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace VDC {
+
+//_____________________________________________________________________________
+Int_t ClusterFitter::Load( const TClonesArray* clusters,
+                           THaVDCCluster::EMode mode )
+{
+  // Copy the hit data of all clusters in 'clusters' into the fit buffers.
+  // The drift distances must have been calculated already.
+  // Returns number of clusters loaded.
+
+  fMode = mode;
+  fX.clear(); fY.clear(); fW.clear();
+  fClust.clear(); fBeg.clear(); fN.clear(); fPiv.clear(); fDriftVel.clear();
+
+  if( !clusters )
+    return 0;
+
+  Int_t nclust = clusters->GetLast()+1;
+  for( Int_t ic = 0; ic < nclust; ++ic ) {
+    auto* clust = static_cast<THaVDCCluster*>( clusters->At(ic) );
+    if( !clust )
+      continue;
+    Int_t n = clust->GetSize();
+    fClust.push_back(clust);
+    fBeg.push_back(fX.size());
+    fN.push_back(n);
+
+    Int_t ihit = 0, incr = 1, ipiv = 0;
+    if( mode == THaVDCCluster::kT0 ) {
+      // Order hits by increasing wire position, like LinearClusterFitWithT0
+      THaVDCPlane* plane = clust->GetPlane();
+      fDriftVel.push_back( plane ? plane->GetDriftVel() : 0.0 );
+      if( plane && plane->GetWSpac() < 0 ) {
+        ihit = n-1;
+        incr = -1;
+      }
+    } else
+      fDriftVel.push_back(0.0);
+
+    for( Int_t i = 0; i < n; ihit += incr, ++i ) {
+      const THaVDCHit* hit = clust->GetHit(ihit);
+      if( hit == clust->GetPivot() )
+        ipiv = i;
+      Double_t w = 1.0;
+      if( mode != THaVDCCluster::kSimple ) {
+        w = hit->GetdDist();
+        // the hit will be ignored if the uncertainty is <= 0
+        w = ( w > 0 ) ? 1./(w*w) : -1.;
+      }
+      fX.push_back( hit->GetPos() );
+      fY.push_back( hit->GetDist() + clust->GetTimeCorrection() );
+      fW.push_back( w );
+    }
+    fPiv.push_back(ipiv);
+  }
+  fRes.assign(fClust.size(), Result_t());
+
+  return fClust.size();
+}
+
+//_____________________________________________________________________________
+void ClusterFitter::Fit()
+{
+  // Fit all loaded clusters
+
+  UInt_t nclust = fClust.size();
+  for( UInt_t ic = 0; ic < nclust; ++ic ) {
+    if( fMode == THaVDCCluster::kT0 )
+      FitWithT0(ic);
+    else
+      FitSimple(ic);
+  }
+}
+
+//_____________________________________________________________________________
+void ClusterFitter::FitSimple( UInt_t ic )
+{
+  // Linear fit of drift distances vs. wire positions, t0 = 0.
+  // Two sign hypotheses: drift distances negative after the pivot wire,
+  // with the pivot distance positive or negative (see FitSimpleTrack).
+  // The sums for both hypotheses are accumulated in the same pass.
+
+  Result_t& res = fRes[ic];
+  UInt_t n = fN[ic];
+  if( n < 3 )
+    return;  // Too few hits to get meaningful results
+
+  const Double_t* x = &fX[fBeg[ic]];
+  const Double_t* y = &fY[fBeg[ic]];
+  const Double_t* w = &fW[fBeg[ic]];
+  UInt_t ipiv = fPiv[ic];
+
+  const Int_t nhyp = 2;
+  Double_t W = 0, sumX = 0, sumXX = 0;
+  Double_t sumY[nhyp] = { 0, 0 }, sumXY[nhyp] = { 0, 0 };
+  for( UInt_t j = 0; j < n; ++j ) {
+    Double_t wj = w[j];
+    if( wj <= 0 ) continue;
+    W     += wj;
+    sumX  += x[j] * wj;
+    sumXX += x[j] * x[j] * wj;
+    for( Int_t i = 0; i < nhyp; ++i ) {
+      Double_t yj = ( j > ipiv || (i == 1 && j == ipiv) ) ? -y[j] : y[j];
+      sumY[i]  += yj * wj;
+      sumXY[i] += x[j] * yj * wj;
+    }
+  }
+
+  // Standard formulae for linear regression (see Bevington)
+  Double_t Delta = W * sumXX - sumX * sumX;
+  Double_t F[nhyp], G[nhyp], chi2[nhyp] = { 0, 0 };
+  for( Int_t i = 0; i < nhyp; ++i ) {
+    F[i] = (sumXX * sumY[i] - sumX * sumXY[i]) / Delta;
+    G[i] = (W * sumXY[i] - sumX * sumY[i]) / Delta;
+  }
+  Int_t npt = 0;
+  for( UInt_t j = 0; j < n; ++j ) {
+    if( w[j] < 0 ) continue;
+    for( Int_t i = 0; i < nhyp; ++i ) {
+      Double_t yj = ( j > ipiv || (i == 1 && j == ipiv) ) ? -y[j] : y[j];
+      Double_t d  = yj - (x[j]*G[i] + F[i]);
+      chi2[i] += d*d*w[j];
+    }
+    ++npt;
+  }
+
+  // Pick the better hypothesis
+  Int_t i = ( chi2[1] < chi2[0] ) ? 1 : 0;
+  Double_t sigmaF2 = ( sumXX / Delta );
+  Double_t sigmaG2 = ( W / Delta );
+  Double_t sigmaFG = ( -sumX / Delta );
+
+  res.chi2   = chi2[i];
+  res.ndof   = npt - 2;
+  res.slope  = 1/G[i];
+  res.icpt   = -F[i]/G[i];
+  res.sslope = res.slope * res.slope * TMath::Sqrt( sigmaG2 );
+  res.sicpt  = TMath::Sqrt(sigmaF2 + F[i] * F[i] / (G[i] * G[i]) * sigmaG2
+                           - 2 * F[i] / G[i] * sigmaFG) / TMath::Abs(G[i]);
+  res.t0     = 0.0;
+  res.ok     = true;
+}
+
+//_____________________________________________________________________________
+void ClusterFitter::FitWithT0( UInt_t ic )
+{
+  // 3-parameter fit s_i ( d_i + d0 ) = m x_i + b for all sign vectors
+  // s_i = -1 for i <= k, +1 for i > k, k = 0...n-2
+  // (see LinearClusterFitWithT0).
+  //
+  // The sign-dependent sums and the chi2 of all hypotheses are accumulated
+  // together in single passes over the hits, with the hypotheses in the
+  // inner loop. The arithmetic per hypothesis is the same as in
+  // THaVDCCluster::Linear3DFit and CalcChisquare.
+
+  Result_t& res = fRes[ic];
+  UInt_t n = fN[ic];
+  if( n < 4 || !fClust[ic]->GetPlane() )
+    return;  // Too few hits to get meaningful results
+
+  const Double_t* x = &fX[fBeg[ic]];
+  const Double_t* d = &fY[fBeg[ic]];
+  const Double_t* w = &fW[fBeg[ic]];
+
+  UInt_t nhyp = n-1;
+  fS.assign(nhyp, 0.0);  fSX.assign(nhyp, 0.0);
+  fSD.assign(nhyp, 0.0); fSDX.assign(nhyp, 0.0);
+  fChi2.assign(nhyp, 0.0);
+  fM.resize(nhyp); fB.resize(nhyp); fD0.resize(nhyp);
+
+  Double_t* sumS   = fS.data();
+  Double_t* sumSX  = fSX.data();
+  Double_t* sumSD  = fSD.data();
+  Double_t* sumSDX = fSDX.data();
+  Double_t sumW = 0, sumX = 0, sumXX = 0, sumD = 0;
+  for( UInt_t j = 0; j < n; ++j ) {
+    Double_t wj = w[j];
+    if( wj <= 0 ) continue;
+    Double_t xj = x[j], dj = d[j];
+    sumX  += xj * wj;
+    sumXX += xj * xj * wj;
+    sumD  += dj * wj;
+    sumW  += wj;
+    for( UInt_t k = 0; k < nhyp; ++k ) {
+      Double_t s = ( j <= k ) ? -1.0 : 1.0;
+      sumS[k]   += s * wj;
+      sumSX[k]  += s * xj * wj;
+      sumSD[k]  += s * dj * wj;
+      sumSDX[k] += s * dj * xj * wj;
+    }
+  }
+
+  // Standard formulae for linear regression (see Bevington)
+  Double_t* m  = fM.data();
+  Double_t* b  = fB.data();
+  Double_t* d0 = fD0.data();
+  for( UInt_t k = 0; k < nhyp; ++k ) {
+    Double_t Delta =
+      sumXX      * ( sumW  * sumW - sumW * sumS[k]  ) -
+      sumX       * ( sumX  * sumW - sumX * sumS[k]  );
+    m[k] =
+      sumSDX[k]  * ( sumW  * sumW - sumW * sumS[k]  ) -
+      sumSD[k]   * ( sumX  * sumW - sumW * sumSX[k] ) +
+      sumD       * ( sumX  * sumS[k] - sumW * sumSX[k] );
+    b[k] =
+      -sumSDX[k] * ( sumX  * sumW - sumX * sumS[k]  ) +
+      sumSD[k]   * ( sumXX * sumW - sumX * sumSX[k] ) -
+      sumD       * ( sumXX * sumS[k] - sumX - sumSX[k] );
+    d0[k] = ( sumD - sumSD[k] ) * ( sumXX * sumW - sumX * sumX );
+    m[k]  /= Delta;
+    b[k]  /= Delta;
+    d0[k] /= Delta;
+  }
+
+  // chi2 of all hypotheses
+  Double_t* chi2 = fChi2.data();
+  Int_t npt = 0;
+  for( UInt_t j = 0; j < n; ++j ) {
+    Double_t wj = w[j];
+    if( wj < 0 ) continue;
+    Double_t xj = x[j], dj = d[j];
+    for( UInt_t k = 0; k < nhyp; ++k ) {
+      Double_t s  = ( j <= k ) ? -1.0 : 1.0;
+      Double_t y  = s * dj;
+      Double_t yp = xj*m[k] + b[k] + d0[k]*s;
+      Double_t r  = y-yp;
+      chi2[k] += r*r*wj;
+    }
+    ++npt;
+  }
+
+  // Pick the best hypothesis (the first one in case of ties)
+  UInt_t kbest = min_element(chi2, chi2+nhyp) - chi2;
+
+  // Rotate the coordinate system to match the VDC definition of "slope"
+  res.chi2   = chi2[kbest];
+  res.ndof   = npt - 3;
+  res.slope  = 1.0/m[kbest];
+  res.icpt   = -b[kbest] * res.slope;
+  res.t0     = d0[kbest] / fDriftVel[ic];
+  res.sslope = res.sicpt = res.st0 = 0.0;
+  res.ok     = true;
+}
+
+//_____________________________________________________________________________
+void ClusterFitter::Store() const
+{
+  // Copy fit results into the clusters and calculate the local
+  // track-to-wire distances
+
+  UInt_t nclust = fClust.size();
+  for( UInt_t ic = 0; ic < nclust; ++ic ) {
+    THaVDCCluster* clust = fClust[ic];
+    const Result_t& res = fRes[ic];
+    clust->fFitOK = res.ok;
+    if( res.ok ) {
+      clust->fChi2       = res.chi2;
+      clust->fNDoF       = res.ndof;
+      clust->fLocalSlope = res.slope;
+      clust->fInt        = res.icpt;
+      clust->fSigmaSlope = res.sslope;
+      clust->fSigmaInt   = res.sicpt;
+      clust->fT0         = res.t0;
+      if( fMode == THaVDCCluster::kT0 )
+        clust->fSigmaT0  = res.st0;
+    }
+    clust->CalcLocalDist();
+  }
+}
+
+//_____________________________________________________________________________
+static inline Double_t RelDiff( Double_t a, Double_t b, Double_t scale )
+{
+  // Difference of a and b relative to their magnitude, but at least 'scale'
+
+  Double_t s = max(max(TMath::Abs(a), TMath::Abs(b)), scale);
+  return TMath::Abs(a-b)/s;
+}
+
+//_____________________________________________________________________________
+Double_t ClusterFitter::Compare() const
+{
+  // Return the largest relative deviation of our fit results from those
+  // currently stored in the clusters. A disagreement of the fit status
+  // counts as a deviation of 1.
+
+  Double_t maxdiff = 0.0;
+  UInt_t nclust = fClust.size();
+  for( UInt_t ic = 0; ic < nclust; ++ic ) {
+    const THaVDCCluster* clust = fClust[ic];
+    const Result_t& res = fRes[ic];
+    if( res.ok != clust->IsFitOK() ) {
+      maxdiff = max(maxdiff, 1.0);
+      continue;
+    }
+    if( !res.ok )
+      continue;
+    maxdiff = max(maxdiff, RelDiff(res.slope, clust->GetLocalSlope(), 1e-3));
+    maxdiff = max(maxdiff, RelDiff(res.icpt,  clust->GetIntercept(),  1e-6));
+    maxdiff = max(maxdiff, RelDiff(res.t0,    clust->GetT0(),         1e-12));
+    maxdiff = max(maxdiff, RelDiff(res.chi2,  clust->GetChi2(),       1e-6));
+  }
+  return maxdiff;
+}
+
+} // namespace VDC
+
+///////////////////////////////////////////////////////////////////////////////
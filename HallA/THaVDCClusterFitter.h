@@ -0,0 +1,73 @@
+#ifndef Podd_VDC_ClusterFitter_h_
+#define Podd_VDC_ClusterFitter_h_
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaVDCClusterFitter                                                       //
+//                                                                           //
+// Batched linear fits of all clusters of a VDC plane                        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "THaVDCCluster.h"
+#include <vector>
+
+class TClonesArray;
+
+namespace VDC {
+
+  class ClusterFitter {
+
+  public:
+    ClusterFitter() : fMode(THaVDCCluster::kSimple) {}
+
+    // Copy hit data of all clusters into the fit buffers
+    Int_t    Load( const TClonesArray* clusters,
+                   THaVDCCluster::EMode mode = THaVDCCluster::kSimple );
+    // Fit all loaded clusters
+    void     Fit();
+    // Copy fit results back into the clusters
+    void     Store() const;
+    // Largest relative difference between our results and those in the
+    // clusters (for validation against THaVDCCluster::FitTrack)
+    Double_t Compare() const;
+
+    UInt_t   GetNclusters() const { return fClust.size(); }
+
+  protected:
+    THaVDCCluster::EMode fMode;  // Fit mode of loaded data
+
+    // Hit data of all clusters, structure of arrays
+    std::vector<Double_t> fX;    // Wire positions
+    std::vector<Double_t> fY;    // Drift distances incl. time correction
+    std::vector<Double_t> fW;    // Weights (<0: ignore hit)
+
+    // Per-cluster data
+    std::vector<THaVDCCluster*> fClust;  // Loaded clusters
+    std::vector<UInt_t>   fBeg;   // Index of first hit in hit arrays
+    std::vector<UInt_t>   fN;     // Number of hits
+    std::vector<Int_t>    fPiv;   // Index of pivot hit (simple fits)
+    std::vector<Double_t> fDriftVel; // Drift velocity (t0 fits)
+
+    // Per-cluster results
+    class Result_t {
+    public:
+      Result_t() : ok(false), slope(kBig), sslope(kBig), icpt(kBig),
+                   sicpt(kBig), t0(kBig), st0(kBig), chi2(kBig), ndof(0) {}
+      Bool_t   ok;
+      Double_t slope, sslope, icpt, sicpt, t0, st0, chi2, ndof;
+    };
+    std::vector<Result_t> fRes;
+
+    // Scratch space for sign hypothesis scans, one element per hypothesis
+    std::vector<Double_t> fS, fSX, fSD, fSDX;  // Sign-dependent sums
+    std::vector<Double_t> fM, fB, fD0, fChi2;  // Fit results
+
+    void FitSimple( UInt_t ic );
+    void FitWithT0( UInt_t ic );
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
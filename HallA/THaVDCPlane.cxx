@@ -22,10 +22,13 @@
 #include "THaVDCHit.h"
 #include "THaDetMap.h"
 #include "THaVDCAnalyticTTDConv.h"
+#include "THaVDCTableTTDConv.h"
 #include "THaEvData.h"
+#include "EventArena.h"
 #include "TString.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "TStopwatch.h"
 #include "VarDef.h"
 #include "THaApparatus.h"
 #include "Helper.h"
@@ -37,6 +40,7 @@
 #include <stdexcept>
 #include <set>
 #include <iomanip>
+#include <algorithm>
 
 #ifdef CLUST_RAWDATA_HACK
 #include <fstream>
@@ -56,10 +60,13 @@ THaVDCPlane::THaVDCPlane( const char* name, const char* description,
   fMaxClustSpan(kMaxInt), fNMaxGap(0), fMinTime(0), fMaxTime(kMaxInt),
   fMaxThits(0), fMinTdiff(0), fMaxTdiff(kBig), fTDCRes(0), fDriftVel(0),
   fT0Resolution(0), fOnlyFastestHit(false), fNoNegativeTime(false),
+  fFastClust(false), fBatchFit(false), fCheckFit(false),
   fWBeg(0), fWSpac(0), fWAngle(0), fSinWAngle(0),
   fCosWAngle(1), /*fTable(0),*/ fTTDConv(nullptr),
   fVDC{dynamic_cast<THaVDC*>( GetMainDetector() )},
-  fMaxData(kMaxUInt), fNextHit(0), fPrevWire(nullptr)
+  fMaxData(kMaxUInt), fNextHit(0), fPrevWire(nullptr),
+  fNfitEvents(0), fNfitClust(0), fNfitDiff(0), fFitMaxDiff(0),
+  fFitTime{0,0}
 {
   // Constructor
 }
@@ -197,6 +204,11 @@ Int_t THaVDCPlane::ReadDatabase( const TDatime& date )
     fOnlyFastestHit = fVDC->TestBit(THaVDC::kOnlyFastest);
     // If true, ignore negative drift times completely
     fNoNegativeTime = fVDC->TestBit(THaVDC::kIgnoreNegDrift);
+    // If true, find clusters in a single pass over the wire occupancy
+    fFastClust = fVDC->TestBit(THaVDC::kFastClust);
+    // If true, fit all clusters in one batch (and optionally check results)
+    fBatchFit = fVDC->TestBit(THaVDC::kBatchFit);
+    fCheckFit = fVDC->TestBit(THaVDC::kCheckFit);
   } else
     DefineAxes(0);
 
@@ -220,6 +232,15 @@ Int_t THaVDCPlane::ReadDatabase( const TDatime& date )
       wire->SetFlag(1);
   }
 
+  // Occupancy arrays for single-pass clustering
+  UInt_t nwords = (fNelem + 63) / 64;
+  fHitBits.assign(nwords, 0);
+  fSkipBits.assign(nwords, 0);
+  fWireHit.assign(fNelem, nullptr);
+  // A very large span means "no limit". A cluster cannot span more wires
+  // than the plane has.
+  fClusHits.reserve(TMath::Max(TMath::Min(fMaxClustSpan, fNelem), 0) + 1);
+
 #ifdef WITH_DEBUG
   if( fDebug > 2 ) {
     Double_t org[3]; fOrigin.GetXYZ(org);
@@ -422,6 +443,14 @@ Int_t THaVDCPlane::CreateTTDConv( const char* classname,
           "\"%s\". Check ttd.param in database.", classname);
     return kInitError;
   }
+#ifdef WITH_DEBUG
+  if( fDebug > 0 ) {
+    auto* tab = dynamic_cast<VDC::TableTTDConv*>(fTTDConv);
+    if( tab && tab->IsTabulated() )
+      Info(Here(here), "Time-to-distance table %u x %u, max error %g m",
+           tab->GetNtime(), tab->GetNtheta(), tab->GetMaxError());
+  }
+#endif
   return kOK;
 }
 
@@ -490,7 +519,20 @@ void THaVDCPlane::Clear( Option_t* opt )
   THaSubDetector::Clear(opt);
   fNHits = fNWiresHit = 0;
   fHits->Clear();
-  fClusters->Delete();
+  // Keep the cluster objects (and their hit vectors) for reuse in the next
+  // event. NewCluster() hands them out again.
+  fClusters->Clear("C");
+}
+
+//_____________________________________________________________________________
+THaVDCCluster* THaVDCPlane::NewCluster( Int_t i )
+{
+  // Return cluster object at index i of fClusters, reusing an object
+  // constructed in an earlier event if possible
+
+  auto* clust = static_cast<THaVDCCluster*>( fClusters->ConstructedAt(i) );
+  clust->SetPlane(this);
+  return clust;
 }
 
 //_____________________________________________________________________________
@@ -712,6 +754,9 @@ Int_t THaVDCPlane::FindClusters()
   // correspond to decreasing physical position.
   // Ignores possibility of overlapping clusters
 
+  if( fFastClust )
+    return FindClustersFast();
+
   TimeCut timecut(fVDC, this);
 
   Int_t nHits = GetNHits();   // Number of hits in the plane
@@ -720,7 +765,10 @@ Int_t THaVDCPlane::FindClusters()
   Int_t nextClust = 0;            // Current cluster number
   assert(GetNClusters() == 0);
 
-  vector<THaVDCHit*> clushits;
+  // Hits of the current cluster candidate. Scratch memory comes from the
+  // event arena, so there is no heap traffic once the arena has grown.
+  typedef Podd::ArenaAllocator<THaVDCHit*> HitAlloc_t;
+  vector<THaVDCHit*, HitAlloc_t> clushits{HitAlloc_t(GetEventArena())};
   clushits.reserve(nHits);
 
   fNpass = 0;
@@ -833,7 +881,7 @@ Int_t THaVDCPlane::FindClusters()
       // Also, make sure that we did indeed see the time
       // spectrum turn around at some point
       if( nwires >= fMinClustSize && !falling ) {
-        auto* clust = new((*fClusters)[nextClust++]) THaVDCCluster(this);
+        THaVDCCluster* clust = NewCluster(nextClust++);
         for( auto* clushit : clushits ) {
           clushit->SetClsNum(nextClust - 1);
           clust->AddHit(clushit);
@@ -853,11 +901,146 @@ Int_t THaVDCPlane::FindClusters()
   return nextClust;  // return the number of clusters found
 }
 
+//_____________________________________________________________________________
+Int_t THaVDCPlane::FindClustersFast()
+{
+  // Single-pass version of FindClusters, enabled with the VDC database
+  // flag "fast_clustering".
+  //
+  // The time cuts are applied once per hit while building a bitmap of the
+  // wires that have a usable hit, together with the earliest such hit per
+  // wire. Wires with fMaxThits or more hits are recorded in a separate
+  // bitmap; they are never part of a cluster but widen the allowed wire
+  // gap, as in FindClusters. Cluster candidates are then formed in one scan over
+  // the set bits, applying the same gap, span and V-shape criteria as
+  // FindClusters.
+  //
+  // Unlike FindClusters, hits rejected from a candidate are not
+  // reconsidered in further passes, and only the earliest usable hit on
+  // each wire is considered. With "only_fastest_hit" (the default) and
+  // clean events, the results are the same.
+
+  assert(GetNClusters() == 0);
+
+  TimeCut timecut(fVDC, this);
+
+  // Build the wire occupancy
+  std::fill(ALL(fHitBits), 0);
+  std::fill(ALL(fSkipBits), 0);
+  Int_t nHits = GetNHits();
+  for( Int_t i = 0; i < nHits; ++i ) {
+    THaVDCHit* hit = GetHit(i);
+    if( !timecut(hit) )
+      continue;
+    UInt_t w = hit->GetWireNum();
+    ULong64_t bit = 1ULL << (w & 63);
+    if( hit->GetNthit() >= fMaxThits )
+      fSkipBits[w >> 6] |= bit;
+    else if( !(fHitBits[w >> 6] & bit) ) {
+      // Hits are sorted by time for each wire, so this is the earliest one
+      fHitBits[w >> 6] |= bit;
+      fWireHit[w] = hit;
+    }
+  }
+
+  Int_t nextClust = 0;
+  fNpass = 1;
+
+  // Scan state of the current cluster candidate
+  THaVDCHit* hit = nullptr;  // Last hit added to the candidate
+  Bool_t falling = true;
+  Int_t  span = 0, nwires = 0, nskip = 0;
+  fClusHits.clear();
+
+  auto finish_cluster = [&]() {
+    if( hit && nwires >= fMinClustSize && !falling ) {
+      THaVDCCluster* clust = NewCluster(nextClust++);
+      for( auto* clushit : fClusHits ) {
+        clushit->SetClsNum(nextClust - 1);
+        clust->AddHit(clushit);
+      }
+      // This is a good cluster candidate. Estimate its position/slope
+      clust->EstTrackParameters();
+    }
+  };
+  auto start_cluster = [&]( THaVDCHit* start ) {
+    hit = start;
+    falling = true;
+    span = nskip = 0;
+    nwires = 1;
+    fClusHits.clear();
+    fClusHits.push_back(start);
+  };
+
+  UInt_t nwords = fHitBits.size();
+  for( UInt_t iw = 0; iw < nwords; ++iw ) {
+    ULong64_t word = fHitBits[iw] | fSkipBits[iw];
+    while( word ) {
+      UInt_t b = Podd::LowestSetBit(word);
+      word &= word - 1;
+      Int_t wnum = (iw << 6) + b;
+      ULong64_t bit = 1ULL << b;
+
+      if( !(fHitBits[iw] & bit) ) {
+        // Noisy wire. Skip it but continue the cluster
+        if( hit )
+          nskip++;
+        continue;
+      }
+      THaVDCHit* nextHit = fWireHit[wnum];
+      if( !hit ) {
+        start_cluster(nextHit);
+        continue;
+      }
+
+      Int_t ndif = wnum - hit->GetWireNum();
+      assert(ndif > 0);
+      Double_t deltat = nextHit->GetTime() - hit->GetTime();
+
+      span += ndif;
+      if( ndif > fNMaxGap + 1 + nskip || span > fMaxClustSpan ) {
+        // End of candidate. This wire starts the next one
+        finish_cluster();
+        start_cluster(nextHit);
+        continue;
+      }
+
+      // Make sure the time structure is sensible (see FindClusters)
+      if( !falling ) {
+        if( deltat < fMinTdiff * ndif ||
+            deltat > fMaxTdiff * ndif )
+          continue;
+      } else {
+        if( deltat < -fMaxTdiff * ndif )
+          continue;
+        if( deltat > 0.0 ) {
+          if( deltat < fMaxTdiff * ndif && span > 1 )
+            falling = false;
+          else
+            continue;
+        }
+      }
+
+      nwires++;
+      fClusHits.push_back(nextHit);
+      hit = nextHit;
+    }
+  }
+  finish_cluster();
+
+  assert(GetNClusters() == nextClust);
+
+  return nextClust;  // return the number of clusters found
+}
+
 //_____________________________________________________________________________
 Int_t THaVDCPlane::FitTracks()
 {
   // Fit tracks to cluster positions and drift distances.
 
+  if( fBatchFit )
+    return FitTracksBatch();
+
   Int_t nClust = GetNClusters();
   for (int i = 0; i < nClust; i++) {
     auto* clust = static_cast<THaVDCCluster*>( (*fClusters)[i] );
@@ -899,6 +1082,80 @@ Int_t THaVDCPlane::FitTracks()
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaVDCPlane::FitTracksBatch()
+{
+  // Fit tracks to all clusters of this plane in one batch, using
+  // VDC::ClusterFitter. Results are the same as those of FitTracks.
+  //
+  // If fCheckFit is set, also fit each cluster with THaVDCCluster::FitTrack
+  // (whose results are kept), and accumulate the timing of both methods
+  // and the differences of the results. These are reported by End().
+
+  Int_t nClust = GetNClusters();
+  for (int i = 0; i < nClust; i++) {
+    auto* clust = static_cast<THaVDCCluster*>( (*fClusters)[i] );
+    if( !clust ) continue;
+
+    // Convert drift times to distances (see FitTracks)
+    clust->ConvertTimeToDist();
+  }
+  if( nClust == 0 )
+    return 0;
+
+  if( !fCheckFit ) {
+    fFitter.Load(fClusters);
+    fFitter.Fit();
+    fFitter.Store();
+    return 0;
+  }
+
+  TStopwatch timer;
+  fFitter.Load(fClusters);
+  fFitter.Fit();
+  fFitter.Store();
+  timer.Stop();
+  fFitTime[1] += timer.RealTime();
+
+  timer.Start();
+  for (int i = 0; i < nClust; i++) {
+    auto* clust = static_cast<THaVDCCluster*>( (*fClusters)[i] );
+    if( clust )
+      clust->FitTrack();
+  }
+  timer.Stop();
+  fFitTime[0] += timer.RealTime();
+
+  Double_t diff = fFitter.Compare();
+  ++fNfitEvents;
+  fNfitClust += fFitter.GetNclusters();
+  if( diff > 1e-9 )
+    ++fNfitDiff;
+  fFitMaxDiff = TMath::Max(fFitMaxDiff, diff);
+
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaVDCPlane::End( THaRunBase* run )
+{
+  // End-of-run processing. Report results of batch fit validation, if any.
+
+  static const char* const here = "End";
+
+  if( fCheckFit && fNfitEvents > 0 ) {
+    Info( Here(here), "Batch fit check: %llu events, %llu clusters, "
+          "%llu events with differences, max rel. difference = %g. "
+          "Time/event: FitTrack %.3lf us, batch %.3lf us",
+          fNfitEvents, fNfitClust, fNfitDiff, fFitMaxDiff,
+          1e6*fFitTime[0]/fNfitEvents, 1e6*fFitTime[1]/fNfitEvents );
+  }
+  fNfitEvents = fNfitClust = fNfitDiff = 0;
+  fFitMaxDiff = fFitTime[0] = fFitTime[1] = 0;
+
+  return THaSubDetector::End(run);
+}
+
 //_____________________________________________________________________________
 Bool_t THaVDCPlane::IsInActiveArea( Double_t x, Double_t y ) const
 {
@@ -12,6 +12,7 @@
 #include "THaVDCCluster.h"
 #include "TClonesArray.h"
 #include "THaVDCHit.h"
+#include "THaVDCClusterFitter.h"
 #include <cassert>
 #include <vector>
 
@@ -35,6 +36,7 @@ public:
   virtual Int_t   ApplyTimeCorrection();      // Drift time correction
   virtual Int_t   FindClusters();             // Hits -> clusters
   virtual Int_t   FitTracks();                // Clusters -> tracks
+  virtual Int_t   End( THaRunBase* run = nullptr );
 
   //Get and Set functions
   Int_t           GetNClusters()      const { return fClusters->GetLast()+1; }
@@ -107,6 +109,9 @@ protected:
   Double_t fT0Resolution; // (Average) resolution of cluster time offset fit
   Bool_t fOnlyFastestHit; // Only record earliest hit for each wire
   Bool_t fNoNegativeTime; // Disallow negative drift times
+  Bool_t fFastClust;      // Use single-pass cluster finding
+  Bool_t fBatchFit;       // Fit all clusters in one batch
+  Bool_t fCheckFit;       // Validate and time batch fits against FitTrack
 
   // Geometry
   TVector3 fCenter;       // Plane center in VDC coordinate system (m)
@@ -131,6 +136,20 @@ protected:
   Int_t  fNextHit;
   THaVDCWire* fPrevWire;
 
+  // Wire occupancy for single-pass cluster finding, indexed by wire number
+  std::vector<ULong64_t>  fHitBits;   //! Wires with a usable hit
+  std::vector<ULong64_t>  fSkipBits;  //! Wires with too many hits (noise)
+  std::vector<THaVDCHit*> fWireHit;   //! Earliest usable hit on each wire
+  std::vector<THaVDCHit*> fClusHits;  //! Hits of the current cluster candidate
+
+  // Batched cluster fitting
+  VDC::ClusterFitter fFitter;  //! Fitter for all clusters of an event
+  ULong64_t fNfitEvents;       // Events checked against FitTrack
+  ULong64_t fNfitClust;        // Clusters checked against FitTrack
+  ULong64_t fNfitDiff;         // Events with differing fit results
+  Double_t  fFitMaxDiff;       // Largest relative difference seen
+  Double_t  fFitTime[2];       // Total time in FitTrack, batch fit (s)
+
   virtual void  MakePrefix();
   virtual Int_t ReadDatabase( const TDatime& date );
   virtual Int_t DefineVariables( EMode mode = kDefine );
@@ -138,6 +157,9 @@ protected:
 			      Bool_t required = false );
 
   virtual Int_t StoreHit( const DigitizerHitInfo_t& hitinfo, UInt_t data );
+  Int_t         FindClustersFast();
+  THaVDCCluster* NewCluster( Int_t i );
+  Int_t         FitTracksBatch();
   virtual void  PrintDecodedData( const THaEvData& evdata ) const;
 
 private:
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaVDCTableTTDConv                                                        //
+//                                                                           //
+// Time-to-distance converter that tabulates the analytic conversion of      //
+// AnalyticTTDConv on a regular grid in (drift time, tanTheta) when its      //
+// parameters are set, i.e. when the plane creates its converter. At run     //
+// time, a conversion is a bilinear interpolation in this table.             //
+//                                                                           //
+// The grid is refined until the interpolation error, sampled within each    //
+// cell, is below a configurable bound. Times or slopes outside the table    //
+// range are converted with the exact analytic form.                         //
+//                                                                           //
+// Database parameters (ttd.param):                                          //
+//   0-8:  same as AnalyticTTDConv                                           //
+//   9:    max interpolation error (m), default 5e-6.                        //
+//         If <= 0, no table is built and the exact form is always used.     //
+//   10:   max drift time covered by the table (s), default 4e-7             //
+//   11,12: tanTheta range covered by the table, default 0.5, 3.0            //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "THaVDCTableTTDConv.h"
+#include "TError.h"
+#include "TMath.h"
+#include <algorithm>
+
+ClassImp(VDC::TableTTDConv)
+
+using namespace std;
+
+namespace VDC {
+
+static const UInt_t kNparAnalytic = 9;
+static const UInt_t kMaxNodes = 1U<<20;  // Upper limit on table size
+
+//_____________________________________________________________________________
+TableTTDConv::TableTTDConv()
+  : fErrBound(5e-6), fTmin(0.0), fTmax(4e-7), fTHmin(0.5), fTHmax(3.0),
+    fNt(0), fNth(0), fInvDt(0), fInvDth(0), fMaxErr(0)
+{
+  // Constructor
+}
+
+//_____________________________________________________________________________
+Double_t TableTTDConv::ConvertTimeToDist( Double_t time, Double_t tanTheta,
+                                          Double_t* ddist ) const
+{
+  // Drift Velocity in m/s
+  // time in s
+  // Return m
+
+  if( !fTable.empty() && time >= fTmin && time < fTmax &&
+      tanTheta >= fTHmin && tanTheta < fTHmax )
+    return Interpolate(time, tanTheta, ddist);
+
+  return AnalyticTTDConv::ConvertTimeToDist(time, tanTheta, ddist);
+}
+
+//_____________________________________________________________________________
+Double_t TableTTDConv::Interpolate( Double_t time, Double_t tanTheta,
+                                    Double_t* ddist ) const
+{
+  // Bilinear interpolation in the table. Arguments must be within range.
+
+  Double_t u = (time - fTmin) * fInvDt;
+  Double_t w = (tanTheta - fTHmin) * fInvDth;
+  UInt_t i = min(static_cast<UInt_t>(u), fNt-2);
+  UInt_t j = min(static_cast<UInt_t>(w), fNth-2);
+  u -= i;
+  w -= j;
+
+  // Entries are (dist,ddist) pairs. The uncertainty is a step function of
+  // the drift time, so take it from the nearest time node.
+  const Double_t* p = &fTable[2*(j*fNt + i)];
+  const Double_t* q = p + 2*fNt;
+  Double_t ua = 1.0-u, wa = 1.0-w;
+  if( ddist ) {
+    Int_t k = ( u < 0.5 ) ? 1 : 3;
+    *ddist = wa*p[k] + w*q[k];
+  }
+  return wa*(ua*p[0] + u*p[2]) + w*(ua*q[0] + u*q[2]);
+}
+
+//_____________________________________________________________________________
+Double_t TableTTDConv::MaxError( UInt_t nt, UInt_t nth, Bool_t& t_worse )
+{
+  // Build an nt x nth table and return the largest deviation of the
+  // interpolated from the exact distance, sampled at the quarter points
+  // of each cell along each axis and at the cell centers.
+  // t_worse is set if the error is dominated by the time spacing.
+
+  fNt  = nt;
+  fNth = nth;
+  Double_t dt  = (fTmax - fTmin) / (nt-1);
+  Double_t dth = (fTHmax - fTHmin) / (nth-1);
+  fInvDt  = 1.0/dt;
+  fInvDth = 1.0/dth;
+  fTable.resize(2*nt*nth);
+  for( UInt_t j = 0; j < nth; ++j ) {
+    Double_t th = fTHmin + j*dth;
+    for( UInt_t i = 0; i < nt; ++i ) {
+      Double_t* p = &fTable[2*(j*nt + i)];
+      p[0] = AnalyticTTDConv::ConvertTimeToDist(fTmin + i*dt, th, p+1);
+    }
+  }
+
+  static const Double_t f[] = { 0.25, 0.5, 0.75 };
+  Double_t err_t = 0, err_th = 0, err_c = 0;
+  for( UInt_t j = 0; j+1 < nth; ++j ) {
+    Double_t th = fTHmin + j*dth;
+    for( UInt_t i = 0; i+1 < nt; ++i ) {
+      Double_t t = fTmin + i*dt;
+      for( Double_t x : f ) {
+        Double_t tt = t + x*dt, tth = th + x*dth;
+        Double_t e1 = AnalyticTTDConv::ConvertTimeToDist(tt, th)
+                      - Interpolate(tt, th, nullptr);
+        Double_t e2 = AnalyticTTDConv::ConvertTimeToDist(t, tth)
+                      - Interpolate(t, tth, nullptr);
+        err_t  = max(err_t,  TMath::Abs(e1));
+        err_th = max(err_th, TMath::Abs(e2));
+      }
+      Double_t tc = t + 0.5*dt, thc = th + 0.5*dth;
+      Double_t e3 = AnalyticTTDConv::ConvertTimeToDist(tc, thc)
+                    - Interpolate(tc, thc, nullptr);
+      err_c = max(err_c, TMath::Abs(e3));
+    }
+  }
+  t_worse = ( err_t >= err_th );
+  return max(err_c, max(err_t, err_th));
+}
+
+//_____________________________________________________________________________
+Int_t TableTTDConv::MakeTable()
+{
+  // Tabulate the analytic conversion. Start with a coarse grid and halve
+  // the node spacing along the axis contributing the larger error until
+  // the error bound is met or the table reaches its maximum size.
+
+  fTable.clear();
+  fNt = fNth = 0;
+  fMaxErr = 0;
+  if( fErrBound <= 0.0 )
+    return 0;  // Use exact conversion only
+
+  UInt_t nt = 33, nth = 9;
+  while( true ) {
+    Bool_t t_worse = false;
+    fMaxErr = MaxError(nt, nth, t_worse);
+    if( fMaxErr <= fErrBound )
+      break;
+    if( t_worse )
+      nt = 2*nt-1;
+    else
+      nth = 2*nth-1;
+    if( nt*nth > kMaxNodes ) {
+      // Rebuild the last table that fit
+      if( t_worse )
+        nt = (nt+1)/2;
+      else
+        nth = (nth+1)/2;
+      fMaxErr = MaxError(nt, nth, t_worse);
+      Warning( "VDC::TableTTDConv::MakeTable", "Cannot reach requested "
+               "max error of %g m within %u table nodes. Achieved: %g m",
+               fErrBound, kMaxNodes, fMaxErr );
+      break;
+    }
+  }
+  fTable.shrink_to_fit();
+  return 0;
+}
+
+//_____________________________________________________________________________
+Double_t TableTTDConv::GetParameter( UInt_t i ) const
+{
+  // Get i-th parameter
+
+  switch(i) {
+  case 9:
+    return fErrBound;
+  case 10:
+    return fTmax;
+  case 11:
+    return fTHmin;
+  case 12:
+    return fTHmax;
+  default:
+    return AnalyticTTDConv::GetParameter(i);
+  }
+}
+
+//_____________________________________________________________________________
+Int_t TableTTDConv::SetParameters( const vector<double>& parameters )
+{
+  // Set the parameters of the analytic conversion (0-8), followed by the
+  // optional table parameters (9-12, see header comment). Then build the
+  // table. The drift velocity must have been set before calling this.
+
+  Int_t ret = AnalyticTTDConv::SetParameters(parameters);
+  if( ret )
+    return ret;
+
+  size_t npar = parameters.size();
+  if( npar > kNparAnalytic )
+    fErrBound = parameters[kNparAnalytic];
+  if( npar > kNparAnalytic+1 )
+    fTmax = parameters[kNparAnalytic+1];
+  if( npar > kNparAnalytic+3 ) {
+    fTHmin = parameters[kNparAnalytic+2];
+    fTHmax = parameters[kNparAnalytic+3];
+  }
+  if( fTmax <= fTmin || fTHmax <= fTHmin ) {
+    fIsSet = false;
+    return -2;
+  }
+
+  return MakeTable();
+}
+
+} //namespace VDC
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,63 @@
+#ifndef Podd_VDC_TableTTDConv_h_
+#define Podd_VDC_TableTTDConv_h_
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// THaVDCTableTTDConv                                                        //
+//                                                                           //
+// Tabulated version of the analytic time-to-distance conversion. The        //
+// analytic form is evaluated once on a 2D grid in (drift time, tanTheta)    //
+// and then bilinearly interpolated.                                         //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "THaVDCAnalyticTTDConv.h"
+#include <vector>
+
+namespace VDC {
+
+  class TableTTDConv : public AnalyticTTDConv {
+
+  public:
+    TableTTDConv();
+    virtual ~TableTTDConv() = default;
+
+    virtual Double_t ConvertTimeToDist( Double_t time, Double_t tanTheta,
+                                        Double_t* ddist=0 ) const;
+    virtual Double_t GetParameter( UInt_t i ) const;
+    virtual Int_t    SetParameters( const std::vector<double>& param );
+
+    Double_t GetMaxError()  const { return fMaxErr; }
+    UInt_t   GetNtime()     const { return fNt; }
+    UInt_t   GetNtheta()    const { return fNth; }
+    Bool_t   IsTabulated()  const { return !fTable.empty(); }
+
+protected:
+
+    // Table configuration
+    Double_t fErrBound;   // Requested max interpolation error (m)
+    Double_t fTmin;       // Time range of table (s)
+    Double_t fTmax;
+    Double_t fTHmin;      // tanTheta range of table
+    Double_t fTHmax;
+
+    // Table data
+    UInt_t   fNt;         // Number of time nodes
+    UInt_t   fNth;        // Number of tanTheta nodes
+    Double_t fInvDt;      // Inverse node spacing in time (1/s)
+    Double_t fInvDth;     // Inverse node spacing in tanTheta
+    Double_t fMaxErr;     // Max interpolation error found when tabulating (m)
+    std::vector<Double_t> fTable; // (dist,ddist) pairs, time index fastest
+
+    Int_t    MakeTable();
+    Double_t Interpolate( Double_t time, Double_t tanTheta,
+                          Double_t* ddist ) const;
+    Double_t MaxError( UInt_t nt, UInt_t nth, Bool_t& t_worse );
+
+    ClassDef(TableTTDConv,0)   // VDC tabulated TTD conversion
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
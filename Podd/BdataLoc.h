@@ -54,6 +54,9 @@ public:
   virtual const char* GetTypeKey() const = 0;
   // Optional data passed in via generic pointer
   virtual Int_t   OptionPtr( void* ) { return 0; }
+  // True if Load() needs decoded module (slot) data. Locations that only
+  // read the raw crate buffers also work with THaEvData::PreDecode().
+  virtual Bool_t  NeedsSlotData() const { return true; }
 
   virtual void    Clear( const Option_t* ="" )  { data = kMaxUInt; }
   virtual Bool_t  DidLoad() const               { return (data != kMaxUInt); }
@@ -167,6 +170,7 @@ public:
   virtual Int_t  GetNparams() const       { return fgThisType->fNparams; }
   virtual const char* GetTypeKey() const  { return fgThisType->fDBkey; };
   virtual void    Print( Option_t* opt="" ) const;
+  virtual Bool_t  NeedsSlotData() const   { return false; }
 
   // virtual Bool_t operator==( const BdataLoc& rhs ) const
   // { return (crate == rhs.crate &&
@@ -193,6 +197,7 @@ public:
   virtual void   Load( const THaEvData& evt );
   virtual Int_t  GetNparams() const       { return fgThisType->fNparams; }
   virtual const char* GetTypeKey() const  { return fgThisType->fDBkey; };
+  virtual Bool_t NeedsSlotData() const    { return false; }
 
 private:
   static TypeIter_t fgThisType;
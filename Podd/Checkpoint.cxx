@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::Checkpoint
+//
+// Analyzer state at a checkpoint of a replay. THaAnalyzer writes this
+// object, together with the state of all analysis modules, into the
+// subdirectory "Checkpoint" of the output file every time a checkpoint
+// is due (see THaAnalyzer::SetCheckpointInterval). The output trees are
+// auto-saved at the same time, so a file left behind by a replay that
+// was killed can be continued with THaAnalyzer::Resume.
+//
+// The input position is recorded as the number of buffers read from
+// the run object. Checkpoints are only taken between buffers, so a
+// CODA 3 multi-event block is never split.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Checkpoint.h"
+#include "Helper.h"
+#include "TDirectory.h"
+#include "TKey.h"
+#include "TTree.h"
+#include "TVectorD.h"
+#include "TError.h"
+#include "TDatime.h"
+#include <iostream>
+
+using namespace std;
+
+namespace Podd {
+
+const char* const Checkpoint::kDirName = "Checkpoint";
+
+//_____________________________________________________________________________
+Checkpoint::Checkpoint()
+  : fRunNumber(0), fTime(0), fNbuf(0), fNev(0), fNentries(0)
+{
+  // Default constructor for ROOT I/O
+}
+
+//_____________________________________________________________________________
+Checkpoint::Checkpoint( const char* name, const char* description )
+  : TNamed(name, description)
+  , fRunNumber(0), fTime(0), fNbuf(0), fNev(0), fNentries(0)
+{
+  // Constructor
+}
+
+//_____________________________________________________________________________
+Checkpoint::~Checkpoint() = default;
+
+//_____________________________________________________________________________
+void Checkpoint::Print( Option_t* ) const
+{
+  TDatime date(fTime);
+  cout << "Checkpoint of run " << fRunNumber << " written "
+       << date.AsString() << endl;
+  cout << "  Buffers read:  " << fNbuf << endl;
+  cout << "  Events:        " << fNev << endl;
+  cout << "  Tree entries:  " << fNentries << endl;
+}
+
+//_____________________________________________________________________________
+void Checkpoint::SaveTree( TTree* tree )
+{
+  // Write the header of 'tree' to its directory, replacing the previous one,
+  // so that ResumeTree() can continue it from this point.
+  //
+  // Automatic AutoSave is turned off for good. Otherwise a later automatic
+  // save would overwrite the header with one holding more entries than
+  // the checkpoint, and the replay could no longer be resumed after a crash.
+
+  if( !tree )
+    return;
+  tree->SetAutoSave(0);
+  tree->AutoSave("SaveSelf");
+}
+
+//_____________________________________________________________________________
+TTree* Checkpoint::ResumeTree( TTree* tree )
+{
+  // Replace 'tree' by the copy of the same name saved in the tree's
+  // directory at the last checkpoint, so that filling continues where the
+  // checkpoint left off. 'tree' must already have all its branches and
+  // branch addresses set up. The addresses are transferred to the saved
+  // tree, and 'tree' is deleted.
+  //
+  // Returns the saved tree, or nullptr on error, in which case 'tree' is
+  // left unchanged.
+
+  static const char* const here = "Podd::Checkpoint::ResumeTree";
+
+  TDirectory* dir = tree ? tree->GetDirectory() : nullptr;
+  if( !dir )
+    return nullptr;
+  // Not Get(): that would return the in-memory tree of the same name
+  TKey* key = dir->GetKey(tree->GetName());
+  auto* saved = key ? dynamic_cast<TTree*>(key->ReadObj()) : nullptr;
+  if( !saved ) {
+    ::Error( here, "Tree %s not found in %s", tree->GetName(), dir->GetName() );
+    return nullptr;
+  }
+  if( saved->GetListOfBranches()->GetEntries() !=
+      tree->GetListOfBranches()->GetEntries() ) {
+    ::Error( here, "Branches of tree %s differ from saved tree. "
+             "Output definitions must not change when resuming.",
+             tree->GetName() );
+    delete saved;
+    return nullptr;
+  }
+  tree->CopyAddresses(saved);
+  saved->SetAutoSave(0);  // Only checkpoints may save it, see SaveTree()
+  delete tree;
+  return saved;
+}
+
+//_____________________________________________________________________________
+Int_t Checkpoint::WriteArray( TDirectory* dir, const char* name,
+                              const vector<Double_t>& data )
+{
+  // Write 'data' to 'dir' under the given name, replacing any previous
+  // version. Returns 0 on success.
+
+  TVectorD v(SINT(data.size()), data.data());
+  return (dir->WriteTObject(&v, name, "Overwrite") > 0) ? 0 : -1;
+}
+
+//_____________________________________________________________________________
+Int_t Checkpoint::ReadArray( TDirectory* dir, const char* name,
+                             vector<Double_t>& data )
+{
+  // Read array saved with WriteArray. Returns the number of elements read,
+  // or -1 if not found.
+
+  auto* v = dynamic_cast<TVectorD*>(dir->Get(name));
+  if( !v )
+    return -1;
+  data.assign(v->GetMatrixArray(), v->GetMatrixArray() + v->GetNrows());
+  delete v;
+  return SINT(data.size());
+}
+
+//_____________________________________________________________________________
+
+} // namespace Podd
+
+ClassImp(Podd::Checkpoint)
@@ -0,0 +1,57 @@
+#ifndef Podd_Checkpoint_h_
+#define Podd_Checkpoint_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::Checkpoint
+//
+// Analyzer state saved periodically during a replay, used by
+// THaAnalyzer::Resume
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TNamed.h"
+#include <vector>
+#include <string>
+
+class TDirectory;
+class TTree;
+
+namespace Podd {
+
+class Checkpoint : public TNamed {
+
+public:
+  Checkpoint();
+  Checkpoint( const char* name, const char* description );
+  virtual ~Checkpoint();
+
+  virtual void Print( Option_t* opt="" ) const;
+
+  // Helpers for WriteCheckpoint/ReadCheckpoint of analysis modules
+  static void   SaveTree( TTree* tree );
+  static TTree* ResumeTree( TTree* tree );
+  static Int_t  WriteArray( TDirectory* dir, const char* name,
+                            const std::vector<Double_t>& data );
+  static Int_t  ReadArray( TDirectory* dir, const char* name,
+                           std::vector<Double_t>& data );
+
+  // Name of output file subdirectory holding the checkpoint data
+  static const char* const kDirName;
+
+  UInt_t    fRunNumber;  // Run number
+  UInt_t    fTime;       // Time when written (UNIX time)
+  ULong64_t fNbuf;       // Number of input buffers read from run
+  UInt_t    fNev;        // Event count (THaAnalyzer::fNev)
+  Long64_t  fNentries;   // Number of entries in output tree
+  std::vector<UInt_t>      fCounts;     // Analyzer statistics counters
+  std::vector<std::string> fCutNames;   // Names of all cuts
+  std::vector<UInt_t>      fCutCalled;  // Number of evaluations of each cut
+  std::vector<UInt_t>      fCutPassed;  // Number of times each cut passed
+
+  ClassDef(Checkpoint,1)   // Analyzer checkpoint data
+};
+
+} // namespace Podd
+
+#endif
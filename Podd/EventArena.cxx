@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::EventArena
+//
+// Memory arena for objects that live for the duration of one event.
+//
+// Memory is handed out from large blocks by incrementing a pointer.
+// Nothing is freed individually. Reset(), typically called from the
+// owner's Clear(), runs the destructors of any non-trivial objects
+// created with New() and rewinds to the first block. The blocks
+// themselves are kept, so once the arena has grown to the size needed
+// by the busiest event, there is no further heap traffic. Blocks never
+// move, so addresses of arena objects are stable until the next Reset().
+//
+// Objects obtained from an arena must not be deleted.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "EventArena.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+EventArena::EventArena( size_t blocksize )
+  : fBlockSize(max(blocksize, sizeof(max_align_t))), fCurBlock(0),
+    fPtr(nullptr), fEnd(nullptr), fUsed(0), fHighWater(0), fDtors(nullptr)
+{
+  // Constructor. No memory is allocated until first needed.
+}
+
+//_____________________________________________________________________________
+EventArena::~EventArena()
+{
+  // Destructor. Destroys any remaining objects and frees all memory.
+
+  Release();
+}
+
+//_____________________________________________________________________________
+void* EventArena::AllocateSlow( size_t size, size_t align )
+{
+  // Allocate from the next block that has enough space. If there is none,
+  // append a new block of at least the default size. Blocks skipped here
+  // remain available after the next Reset().
+
+  assert( align > 0 && (align & (align-1)) == 0 );  // power of 2
+  size_t need = size + align;
+  size_t next = fPtr ? fCurBlock+1 : 0;
+  while( next < fBlocks.size() && fBlocks[next].size < need )
+    ++next;
+  if( next == fBlocks.size() ) {
+    size_t bsiz = max(fBlockSize, need);
+    fBlocks.push_back( {static_cast<char*>(::operator new(bsiz)), bsiz} );
+  }
+  fCurBlock = next;
+  fPtr = fBlocks[next].buf;
+  fEnd = fPtr + fBlocks[next].size;
+
+  return Allocate(size, align);
+}
+
+//_____________________________________________________________________________
+void EventArena::Reset()
+{
+  // Destroy all objects created with New(), last one first, and rewind to
+  // the beginning of the first block
+
+  for( Dtor_t* d = fDtors; d; d = d->prev )
+    d->dtor(d->obj);
+  fDtors = nullptr;
+
+  if( !fBlocks.empty() ) {
+    fCurBlock = 0;
+    fPtr = fBlocks[0].buf;
+    fEnd = fPtr + fBlocks[0].size;
+  }
+  fHighWater = max(fHighWater, fUsed);
+  fUsed = 0;
+}
+
+//_____________________________________________________________________________
+void EventArena::Release()
+{
+  // Destroy all objects and return all memory blocks to the system
+
+  Reset();
+  for( auto& block : fBlocks )
+    ::operator delete(block.buf);
+  fBlocks.clear();
+  fCurBlock = 0;
+  fPtr = fEnd = nullptr;
+}
+
+//_____________________________________________________________________________
+size_t EventArena::GetCapacity() const
+{
+  // Total size of all memory blocks
+
+  size_t cap = 0;
+  for( const auto& block : fBlocks )
+    cap += block.size;
+  return cap;
+}
+
+} // namespace Podd
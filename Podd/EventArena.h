@@ -0,0 +1,156 @@
+#ifndef Podd_EventArena_h_
+#define Podd_EventArena_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::EventArena
+//
+// Per-event memory arena for transient objects
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Podd {
+
+class EventArena {
+
+public:
+  explicit EventArena( size_t blocksize = kDefaultBlockSize );
+  EventArena( const EventArena& ) = delete;
+  EventArena& operator=( const EventArena& ) = delete;
+  ~EventArena();
+
+  // Raw memory of the given size and alignment. Valid until Reset().
+  void*  Allocate( size_t size, size_t align = alignof(std::max_align_t) );
+
+  // Construct an object of type T in the arena. Objects with non-trivial
+  // destructors are destroyed, in reverse order of creation, by Reset().
+  template<typename T, typename... Args>
+  T*     New( Args&&... args );
+
+  // Uninitialized array of n elements of trivial type T
+  template<typename T>
+  T*     NewArray( size_t n );
+
+  // Destroy all objects and make all memory available again.
+  // The memory blocks are kept for reuse.
+  void   Reset();
+
+  // Release all memory blocks (implies Reset)
+  void   Release();
+
+  size_t GetNblocks()   const { return fBlocks.size(); }
+  size_t GetCapacity()  const;
+  size_t GetUsed()      const { return fUsed; }
+  size_t GetHighWater() const { return fHighWater; }
+
+  static const size_t kDefaultBlockSize = 16384;
+
+private:
+  struct Block_t {
+    char*  buf;
+    size_t size;
+  };
+  struct Dtor_t {
+    void  (*dtor)( void* );
+    void*   obj;
+    Dtor_t* prev;
+  };
+
+  std::vector<Block_t> fBlocks;  // Memory blocks, in order of allocation
+  size_t   fBlockSize;  // Default size of new blocks
+  size_t   fCurBlock;   // Index of block currently being filled
+  char*    fPtr;        // Next free byte in current block
+  char*    fEnd;        // End of current block
+  size_t   fUsed;       // Bytes handed out since last Reset
+  size_t   fHighWater;  // Maximum of fUsed seen
+  Dtor_t*  fDtors;      // Destructors to run at Reset, last one first
+
+  void*  AllocateSlow( size_t size, size_t align );
+
+  template<typename T>
+  static void Destroy( void* obj ) { static_cast<T*>(obj)->~T(); }
+};
+
+//_____________________________________________________________________________
+inline void* EventArena::Allocate( size_t size, size_t align )
+{
+  // Bump-pointer allocation from the current block. Falls back to the next
+  // (possibly new) block if the current one is full.
+
+  auto p = reinterpret_cast<uintptr_t>(fPtr);
+  uintptr_t aligned = (p + align - 1) & ~static_cast<uintptr_t>(align - 1);
+  if( fPtr && aligned + size <= reinterpret_cast<uintptr_t>(fEnd) ) {
+    fPtr = reinterpret_cast<char*>(aligned + size);
+    fUsed += size;
+    return reinterpret_cast<void*>(aligned);
+  }
+  return AllocateSlow(size, align);
+}
+
+//_____________________________________________________________________________
+template<typename T, typename... Args>
+inline T* EventArena::New( Args&&... args )
+{
+  void* mem = Allocate(sizeof(T), alignof(T));
+  T* obj = ::new(mem) T(std::forward<Args>(args)...);
+  if( !std::is_trivially_destructible<T>::value ) {
+    auto* d = static_cast<Dtor_t*>(Allocate(sizeof(Dtor_t), alignof(Dtor_t)));
+    d->dtor = &Destroy<T>;
+    d->obj  = obj;
+    d->prev = fDtors;
+    fDtors  = d;
+  }
+  return obj;
+}
+
+//_____________________________________________________________________________
+template<typename T>
+inline T* EventArena::NewArray( size_t n )
+{
+  static_assert( std::is_trivially_destructible<T>::value,
+                 "EventArena::NewArray requires a trivially destructible type" );
+  return static_cast<T*>( Allocate(n*sizeof(T), alignof(T)) );
+}
+
+//_____________________________________________________________________________
+// STL allocator drawing from an EventArena. Deallocation is a no-op; memory
+// is recycled when the arena is reset. Containers using this allocator must
+// not be accessed after the arena's Reset().
+template<typename T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator( EventArena& arena ) : fArena(&arena) {}
+  template<typename U>
+  ArenaAllocator( const ArenaAllocator<U>& rhs ) : fArena(rhs.GetArena()) {}
+
+  T*   allocate( size_t n ) {
+    return static_cast<T*>( fArena->Allocate(n*sizeof(T), alignof(T)) );
+  }
+  void deallocate( T*, size_t ) {}
+
+  EventArena* GetArena() const { return fArena; }
+
+private:
+  EventArena* fArena;
+};
+
+template<typename T, typename U>
+inline bool operator==( const ArenaAllocator<T>& a, const ArenaAllocator<U>& b )
+{ return a.GetArena() == b.GetArena(); }
+template<typename T, typename U>
+inline bool operator!=( const ArenaAllocator<T>& a, const ArenaAllocator<U>& b )
+{ return !(a == b); }
+
+} // namespace Podd
+
+#endif
@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   Podd::HitCacheDecoder
+//
+//   Loads events written by HitCacheWriter, as read by HitCacheRun,
+//   directly into the slot data. No raw data are parsed, and modules
+//   are not called. Detectors that take their data from the standard
+//   crate/slot/channel hit tables (GetData, GetNumHits etc.) decode
+//   as usual. Data that only modules keep internally (e.g. FADC
+//   waveform analysis results) are not cached.
+//
+//   Use with
+//
+//     gHaInterface->SetDecoder(Podd::HitCacheDecoder::Class());
+//     Podd::HitCacheRun* run = new Podd::HitCacheRun("run1234.hits");
+//
+//   The global variables g.evnum etc. are the same as for the
+//   standard decoder.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "HitCacheDecoder.h"
+#include <cassert>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+HitCacheDecoder::HitCacheDecoder() = default;
+
+//_____________________________________________________________________________
+HitCacheDecoder::~HitCacheDecoder() = default;
+
+//_____________________________________________________________________________
+Int_t HitCacheDecoder::LoadEvent( const UInt_t* evbuffer )
+{
+  // Load one cached event record
+
+  assert(evbuffer);
+
+  if( first_decode || fNeedInit ) {
+    Int_t ret = Init();
+    if( ret != HED_OK )
+      return ret;
+  }
+  for( auto i : fSlotClear )
+    crateslot[i]->clearEvent();
+
+  buffer = evbuffer;
+  event_length = evbuffer[kRecLen]+1;
+  if( event_length <= kRecHits )
+    return HED_ERR;
+  event_type   = evbuffer[kRecEvType];
+  event_num    = evbuffer[kRecEvNum];
+  trigger_bits = evbuffer[kRecTrigBits];
+  evt_time     = evbuffer[kRecTimeLo] |
+    (static_cast<ULong64_t>(evbuffer[kRecTimeHi]) << 32);
+
+  return UnpackHits( evbuffer+kRecHits, evbuffer+event_length );
+}
+
+//_____________________________________________________________________________
+
+} // namespace Podd
+
+ClassImp(Podd::HitCacheDecoder)
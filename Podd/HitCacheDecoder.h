@@ -0,0 +1,43 @@
+#ifndef Podd_HitCacheDecoder_h_
+#define Podd_HitCacheDecoder_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   Podd::HitCacheDecoder
+//
+//   Decoder for events replayed from a decoded-hit cache file
+//   (see HitCacheWriter and HitCacheRun)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "CodaRawDecoder.h"
+
+namespace Podd {
+
+class HitCacheDecoder : public CodaRawDecoder {
+public:
+  HitCacheDecoder();
+  virtual ~HitCacheDecoder();
+
+  virtual Int_t  LoadEvent( const UInt_t* evbuffer );
+  virtual Int_t  PreDecode( const UInt_t* ) { return HED_WARN; }
+
+  // Cache file header. Native byte order.
+  enum {
+    kFileMagic = 0x50484331,  // "PHC1"
+    kFileVersion = 1,
+    kHdrMagic = 0, kHdrVersion, kHdrRunNum, kHdrRunType, kHdrDataVersion,
+    kHdrRunTimeLo, kHdrRunTimeHi, kHdrReserved, kFileHeaderLen
+  };
+  // Event record. The hit data are in THaEvData::PackHits() format.
+  enum {
+    kRecLen = 0,  // Number of words following this one
+    kRecEvType, kRecEvNum, kRecTrigBits, kRecTimeLo, kRecTimeHi, kRecHits
+  };
+
+  ClassDef(HitCacheDecoder,0) // Decoder for cached decoded hits
+};
+
+} // namespace Podd
+
+#endif
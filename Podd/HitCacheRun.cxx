@@ -0,0 +1,223 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::HitCacheRun
+//
+// Run object for decoded-hit cache files written by HitCacheWriter.
+// Each event read is one cache record, which must be decoded with
+// HitCacheDecoder. Run number, type, date and data version are taken
+// from the file header, so no prescan is needed.
+//
+// Scaler, EPICS and other non-physics events are not cached, and neither
+// are prescale factors. Calibration replays that need these should use
+// the original data.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "HitCacheRun.h"
+#include "HitCacheDecoder.h"
+#include "THaPrintOption.h"
+#include "TError.h"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+HitCacheRun::HitCacheRun( const char* fname, const char* description )
+  : THaRunBase(description)
+  , fFilename(fname)
+{
+  // Normal & default constructor
+
+  fDataRequired = kDate|kRunNumber|kRunType;
+}
+
+//_____________________________________________________________________________
+HitCacheRun::HitCacheRun( const HitCacheRun& rhs )
+  : THaRunBase(rhs)
+  , fFilename(rhs.fFilename)
+{
+  // Copy ctor
+}
+
+//_____________________________________________________________________________
+HitCacheRun& HitCacheRun::operator=( const THaRunBase& rhs )
+{
+  // Assignment operator. See THaRun::operator=.
+
+  if( this != &rhs ) {
+    THaRunBase::operator=(rhs);
+    Close();
+    auto* run = dynamic_cast<const HitCacheRun*>(&rhs);
+    if( run )
+      fFilename = run->fFilename;
+    else
+      fFilename.Clear();
+  }
+  return *this;
+}
+
+//_____________________________________________________________________________
+HitCacheRun::~HitCacheRun()
+{
+  // Destructor
+
+  HitCacheRun::Close();
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheRun::Close()
+{
+  // Close the cache file
+
+  fOpened = false;
+  fFile.reset();
+  return READ_OK;
+}
+
+//_____________________________________________________________________________
+const UInt_t* HitCacheRun::GetEvBuffer() const
+{
+  // Return the current event record
+
+  assert( !fBuffer.empty() );
+  return fBuffer.data();
+}
+
+//_____________________________________________________________________________
+Bool_t HitCacheRun::IsOpen() const
+{
+  return fOpened && fFile;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheRun::Open()
+{
+  // Open the cache file and check its header
+
+  static const char* const here = "Open";
+
+  using HC = HitCacheDecoder;
+
+  if( fFilename.IsNull() ) {
+    Error( here, "Cache file name not set. Cannot open the run." );
+    return READ_FATAL;
+  }
+  Close();
+  fFile.reset( new ifstream(fFilename.Data(), ios::in|ios::binary) );
+  if( !*fFile ) {
+    Error( here, "Cannot open cache file %s.", fFilename.Data() );
+    fFile.reset();
+    return READ_FATAL;
+  }
+  fHeader.assign(HC::kFileHeaderLen, 0);
+  fFile->read( reinterpret_cast<char*>(fHeader.data()),
+               fHeader.size()*sizeof(UInt_t) );
+  if( !*fFile || fHeader[HC::kHdrMagic] != HC::kFileMagic ) {
+    Error( here, "%s is not a hit cache file.", fFilename.Data() );
+    Close();
+    return READ_FATAL;
+  }
+  if( fHeader[HC::kHdrVersion] != HC::kFileVersion ) {
+    Error( here, "Unsupported hit cache format version %u in %s.",
+           fHeader[HC::kHdrVersion], fFilename.Data() );
+    Close();
+    return READ_FATAL;
+  }
+  fDataVersion = fHeader[HC::kHdrDataVersion];
+  fOpened = true;
+  return READ_OK;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheRun::ReadInitInfo( Int_t /* level */ )
+{
+  // Set run parameters from the file header
+
+  using HC = HitCacheDecoder;
+
+  assert( fHeader.size() == HC::kFileHeaderLen );
+  if( !fAssumeDate ) {
+    ULong64_t runtime = fHeader[HC::kHdrRunTimeLo] |
+      (static_cast<ULong64_t>(fHeader[HC::kHdrRunTimeHi]) << 32);
+    fDate.Set( static_cast<UInt_t>(runtime) );
+    fDataSet |= kDate;
+  }
+  SetNumber( fHeader[HC::kHdrRunNum] );
+  SetType( fHeader[HC::kHdrRunType] );
+  fDataSet  |= kRunNumber|kRunType;
+  fDataRead |= kDate|kRunNumber|kRunType;
+  return READ_OK;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheRun::ReadEvent()
+{
+  // Read the next event record
+
+  static const char* const here = "ReadEvent";
+
+  if( !IsOpen() )
+    return READ_FATAL;
+
+  UInt_t len = 0;
+  fFile->read( reinterpret_cast<char*>(&len), sizeof(len) );
+  if( fFile->eof() )
+    return READ_EOF;
+  if( !*fFile || len == 0 ) {
+    Error( here, "Error reading cache file %s.", fFilename.Data() );
+    return READ_FATAL;
+  }
+  fBuffer.resize(len+1);
+  fBuffer[0] = len;
+  fFile->read( reinterpret_cast<char*>(fBuffer.data()+1), len*sizeof(UInt_t) );
+  if( !*fFile ) {
+    Warning( here, "Truncated event record at end of cache file %s.",
+             fFilename.Data() );
+    return READ_EOF;
+  }
+  return READ_OK;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheRun::SetFilename( const char* name )
+{
+  // Set the name of the cache file. Return -1 if illegal name, 1 if name
+  // not changed, 0 otherwise.
+
+  static const char* const here = "SetFilename";
+
+  if( !name || !*name ) {
+    Error( here, "Illegal file name." );
+    return -1;
+  }
+  if( fFilename == name )
+    return 1;
+
+  Close();
+  fFilename = name;
+  fIsInit = false;
+  return 0;
+}
+
+//_____________________________________________________________________________
+void HitCacheRun::Print( Option_t* opt ) const
+{
+  THaPrintOption sopt(opt);
+  sopt.ToUpper();
+  if( sopt.Contains("NAMEDESC") ) {
+    cout << "\"file://" << GetFilename() << "\"";
+    if( strcmp( GetTitle(), "") != 0 )
+      cout << "  \"" << GetTitle() << "\"";
+    return;
+  }
+  THaRunBase::Print( opt );
+  cout << "Hit cache file: " << fFilename << endl;
+}
+
+} // namespace Podd
+
+ClassImp(Podd::HitCacheRun)
@@ -0,0 +1,50 @@
+#ifndef Podd_HitCacheRun_h_
+#define Podd_HitCacheRun_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::HitCacheRun
+//
+// A run read from a decoded-hit cache file
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "THaRunBase.h"
+#include "TString.h"
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace Podd {
+
+class HitCacheRun : public THaRunBase {
+
+public:
+  explicit HitCacheRun( const char* filename="", const char* description="" );
+  HitCacheRun( const HitCacheRun& run );
+  virtual HitCacheRun& operator=( const THaRunBase& rhs );
+  virtual ~HitCacheRun();
+
+  virtual Int_t         Close();
+  virtual const UInt_t* GetEvBuffer() const;
+  virtual Bool_t        IsOpen() const;
+  virtual Int_t         Open();
+  virtual Int_t         ReadEvent();
+  virtual void          Print( Option_t* opt="" ) const;
+          const char*   GetFilename() const { return fFilename.Data(); }
+  virtual Int_t         SetFilename( const char* name );
+
+protected:
+  TString  fFilename;  // Cache file name
+  std::unique_ptr<std::ifstream> fFile;  //! Cache file
+  std::vector<UInt_t> fHeader;           //! File header
+  std::vector<UInt_t> fBuffer;           //! Current event record
+
+  virtual Int_t ReadInitInfo( Int_t level );
+
+  ClassDef(HitCacheRun,1)  // Run from a decoded-hit cache file
+};
+
+} // namespace Podd
+
+#endif
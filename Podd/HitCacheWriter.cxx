@@ -0,0 +1,189 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   Podd::HitCacheWriter
+//
+//   Writes the decoded hits of physics events (the contents of the
+//   decoder's crate/slot/channel hit tables after LoadEvent) to a
+//   compact binary cache file. The file can be replayed with
+//   HitCacheRun and HitCacheDecoder, which skip reading and parsing
+//   the raw data. This is intended for calibrations that iterate the
+//   reconstruction many times over the same events.
+//
+//   Detector Decode() still runs during replay, so calibration
+//   parameters applied there (e.g. VDC t0 offsets) take effect in each
+//   iteration.
+//
+//   Usage:
+//
+//     analyzer->AddPostProcess(new Podd::HitCacheWriter("run1234.hits"));
+//
+//   An optional cut expression selects the events to write.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "HitCacheWriter.h"
+#include "HitCacheDecoder.h"
+#include "THaCut.h"
+#include "THaEvData.h"
+#include "THaRunBase.h"
+#include "TDatime.h"
+#include "TError.h"
+// only for ERetVal, used by Process(). Should put ERetVal in a separate header
+#include "THaAnalyzer.h"
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+HitCacheWriter::HitCacheWriter( const char* filename, const char* cutexpr )
+  : fFileName(filename), fCutExpr(cutexpr), fCut(nullptr),
+    fHeaderDone(false), fNwritten(0), fRunTime(0)
+{
+  // Constructor
+
+  // This module returns compatible return codes
+  SetBit(kUseReturnCode);
+}
+
+//_____________________________________________________________________________
+HitCacheWriter::~HitCacheWriter()
+{
+  // Destructor
+
+  HitCacheWriter::Close();
+  delete fCut;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheWriter::Close()
+{
+  // Close the cache file. If no event was seen, write the header from the
+  // Init() parameters, so that an empty cache is still a valid file.
+
+  if( !fOut )
+    return 0;
+  if( !fHeaderDone && !WriteHeader(nullptr, nullptr) )
+    Error( "HitCacheWriter::Close", "Error writing header of cache file %s. "
+           "Check disk space and permissions.", fFileName.Data() );
+  fOut->close();
+  fOut.reset();
+  fIsInit = 0;
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheWriter::Init( const TDatime& run_time )
+{
+  // Open the cache file and set up the cut, if any
+
+  const char* const here = "HitCacheWriter::Init";
+
+  if( fIsInit )
+    return 0;
+
+  delete fCut; fCut = nullptr;
+  if( !fCutExpr.IsNull() ) {
+    fCut = new THaCut( "HitCache_Test", fCutExpr, "PostProcess" );
+    if( fCut->IsZombie() || fCut->IsError() ) {
+      Error(here, "Illegal cut expression: %s", fCutExpr.Data());
+      delete fCut; fCut = nullptr;
+      return -1;
+    }
+  }
+
+  fOut.reset( new ofstream(fFileName.Data(), ios::out|ios::binary|ios::trunc) );
+  if( !*fOut ) {
+    Error(here, "Cannot open cache file %s for writing.", fFileName.Data());
+    fOut.reset();
+    return -3;
+  }
+  fHeaderDone = false;
+  fNwritten = 0;
+  fRunTime = run_time.Convert();
+  fIsInit = 1;
+  return 0;
+}
+
+//_____________________________________________________________________________
+Bool_t HitCacheWriter::WriteHeader( const THaEvData* evdata,
+                                    const THaRunBase* run )
+{
+  // Write the file header. Run parameters are taken from the run object,
+  // with the decoder as fallback. Without either, only the run time from
+  // Init() is known.
+
+  using HC = HitCacheDecoder;
+
+  UInt_t hdr[HC::kFileHeaderLen] = {};
+  ULong64_t runtime = run ? run->GetDate().Convert()
+    : ( evdata ? evdata->GetRunTime() : fRunTime );
+  hdr[HC::kHdrMagic]       = HC::kFileMagic;
+  hdr[HC::kHdrVersion]     = HC::kFileVersion;
+  if( run ) {
+    hdr[HC::kHdrRunNum]    = run->GetNumber();
+    hdr[HC::kHdrRunType]   = run->GetType();
+  } else if( evdata ) {
+    hdr[HC::kHdrRunNum]    = evdata->GetRunNum();
+    hdr[HC::kHdrRunType]   = evdata->GetRunType();
+  }
+  if( evdata )
+    hdr[HC::kHdrDataVersion] = evdata->GetDataVersion();
+  hdr[HC::kHdrRunTimeLo]   = static_cast<UInt_t>(runtime & 0xffffffff);
+  hdr[HC::kHdrRunTimeHi]   = static_cast<UInt_t>(runtime >> 32);
+  fOut->write( reinterpret_cast<const char*>(hdr), sizeof(hdr) );
+  fHeaderDone = true;
+  return fOut->good();
+}
+
+//_____________________________________________________________________________
+Int_t HitCacheWriter::Process( const THaEvData* evdata, const THaRunBase* run,
+                               Int_t /* code */ )
+{
+  // Append the decoded hits of the current physics event to the cache
+
+  const char* const here = "HitCacheWriter::Process";
+
+  if( !fIsInit || !evdata )
+    return THaAnalyzer::kOK;
+
+  // Write the header at the first event of any kind, so that the file is
+  // valid even if no event passes the selection
+  if( !fHeaderDone && !WriteHeader(evdata, run) ) {
+    Error( here, "Error writing header of cache file %s. Check disk space "
+           "and permissions.", fFileName.Data() );
+    return THaAnalyzer::kFatal;
+  }
+
+  if( !evdata->IsPhysicsTrigger() )
+    return THaAnalyzer::kOK;
+  if( fCut && !fCut->EvalCut() )
+    return THaAnalyzer::kOK;
+
+  using HC = HitCacheDecoder;
+
+  fBuffer.resize(HC::kRecHits);
+  fBuffer[HC::kRecEvType]   = evdata->GetEvType();
+  fBuffer[HC::kRecEvNum]    = evdata->GetEvNum();
+  fBuffer[HC::kRecTrigBits] = evdata->GetTrigBits();
+  fBuffer[HC::kRecTimeLo]   = static_cast<UInt_t>(evdata->GetEvTime() & 0xffffffff);
+  fBuffer[HC::kRecTimeHi]   = static_cast<UInt_t>(evdata->GetEvTime() >> 32);
+  evdata->PackHits(fBuffer);
+  fBuffer[HC::kRecLen] = fBuffer.size()-1;
+
+  fOut->write( reinterpret_cast<const char*>(fBuffer.data()),
+               fBuffer.size()*sizeof(UInt_t) );
+  if( !fOut->good() ) {
+    Error( here, "Error writing to cache file %s. Check disk space.",
+           fFileName.Data() );
+    return THaAnalyzer::kFatal;
+  }
+  ++fNwritten;
+  return THaAnalyzer::kOK;
+}
+
+//_____________________________________________________________________________
+
+} // namespace Podd
+
+ClassImp(Podd::HitCacheWriter)
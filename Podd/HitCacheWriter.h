@@ -0,0 +1,50 @@
+#ifndef Podd_HitCacheWriter_h_
+#define Podd_HitCacheWriter_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   Podd::HitCacheWriter
+//
+//   Post-processing module writing decoded hits to a cache file
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaPostProcess.h"
+#include "TString.h"
+#include <fstream>
+#include <memory>
+#include <vector>
+
+class THaCut;
+
+namespace Podd {
+
+class HitCacheWriter : public THaPostProcess {
+public:
+  explicit HitCacheWriter( const char* filename, const char* cutexpr = "" );
+  virtual ~HitCacheWriter();
+
+  virtual Int_t Init( const TDatime& );
+  virtual Int_t Process( const THaEvData*, const THaRunBase*, Int_t code );
+  virtual Int_t Close();
+
+  UInt_t  GetNwritten() const { return fNwritten; }
+
+protected:
+  TString  fFileName;   // Name of cache file
+  TString  fCutExpr;    // Optional selection cut
+  THaCut*  fCut;        // Compiled selection cut
+  std::unique_ptr<std::ofstream> fOut;  //! Cache file
+  std::vector<UInt_t> fBuffer;          //! Record being written
+  Bool_t   fHeaderDone; // File header written
+  UInt_t   fNwritten;   // Number of events written
+  ULong64_t fRunTime;   // Run time passed to Init (UNIX time)
+
+  Bool_t   WriteHeader( const THaEvData* evdata, const THaRunBase* run );
+
+  ClassDef(HitCacheWriter,0) // Writes decoded hits to a cache file
+};
+
+} // namespace Podd
+
+#endif
@@ -0,0 +1,261 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::ModuleProfiler
+//
+// Low-overhead timing of the individual analysis modules.
+//
+// THaAnalyzer's benchmarks only time whole analysis stages. While a
+// ModuleProfiler is active (see THaAnalyzer::EnableModuleProfiling),
+// the analyzer, apparatuses and spectrometers wrap each call of a module
+// or detector in a ModuleProfiler::Span, which records the duration of
+// the call in a THaLatencyHistogram kept per module and stage. The
+// summary printed by Print() gives the number of calls, the mean, median,
+// 90th and 99th percentile and maximum duration, and the total time, so
+// one can see which module is slow and whether slowness is in the tail.
+//
+// On x86, time is measured with the time stamp counter (RDTSC), which
+// costs only a few ns per reading. The tick rate is calibrated against
+// std::chrono::steady_clock between Start() and Stop(). Elsewhere,
+// steady_clock is used directly. A span costs a few tens of ns, well
+// below 1% of the typical analysis time per module and event. With no
+// profiler active, a span costs a single test.
+//
+// Times of an apparatus include those of its detectors. Only the
+// analysis thread may be timed.
+//
+// The spans of analysis objects also appear in the timeline of a
+// THaTimelineTrace (see THaAnalyzer::EnableTimelineTrace), whether or not
+// a profiler is active.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "ModuleProfiler.h"
+#include "THaApparatus.h"
+#include "THaDetector.h"
+#include "TList.h"
+#include "Helper.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace Podd {
+
+ModuleProfiler* ModuleProfiler::fgActive = nullptr;
+
+//_____________________________________________________________________________
+ModuleProfiler::ModuleProfiler()
+  : fTick0(0), fNs0(0), fTicks(0), fNs(0)
+{
+  // Constructor
+}
+
+//_____________________________________________________________________________
+ModuleProfiler::~ModuleProfiler()
+{
+  // Destructor
+
+  if( fgActive == this )
+    fgActive = nullptr;
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Init( const vector<THaAnalysisObject*>& modules )
+{
+  // Register the given modules, each apparatus followed by its detectors
+
+  for( auto* mod : modules ) {
+    Register(mod);
+    if( auto* app = dynamic_cast<THaApparatus*>(mod) ) {
+      TIter next(app->GetDetectors());
+      while( auto* det = static_cast<THaAnalysisObject*>(next()) )
+        Register(det);
+    }
+  }
+}
+
+//_____________________________________________________________________________
+Int_t ModuleProfiler::Register( THaAnalysisObject* obj )
+{
+  // Register 'obj', if not yet done, and return its index
+
+  UInt_t slot = obj->fProfileSlot;
+  if( slot < fModules.size() && fModules[slot].obj == obj )
+    return static_cast<Int_t>(slot);
+  auto it = find_if(ALL(fModules), [obj]( const Module_t& m ) {
+    return m.obj == obj;
+  });
+  if( it == fModules.end() ) {
+    string name = obj->GetPrefixName().Data();
+    if( name.empty() )
+      name = obj->GetName();
+    fModules.emplace_back(obj, name);
+    it = fModules.end() - 1;
+  }
+  obj->fProfileSlot = static_cast<Int_t>(it - fModules.begin());
+  return obj->fProfileSlot;
+}
+
+//_____________________________________________________________________________
+Int_t ModuleProfiler::Register( const char* name )
+{
+  // Register a pseudo-module, i.e. code that is not part of an analysis
+  // object, such as the output, and return its index for use with Span
+
+  auto it = find_if(ALL(fModules), [name]( const Module_t& m ) {
+    return !m.obj && m.name == name;
+  });
+  if( it == fModules.end() ) {
+    fModules.emplace_back(nullptr, name);
+    it = fModules.end() - 1;
+  }
+  return static_cast<Int_t>(it - fModules.begin());
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Start()
+{
+  // Start recording. Replaces any other active profiler.
+
+  if( fgActive == this )
+    return;
+  if( fgActive )
+    fgActive->Stop();
+  fNs0 = THaBenchmark::Now();
+  fTick0 = Ticks();
+  fgActive = this;
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Stop()
+{
+  // Stop recording
+
+  if( fgActive != this )
+    return;
+  fTicks += Ticks() - fTick0;
+  fNs += THaBenchmark::Now() - fNs0;
+  fgActive = nullptr;
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Reset()
+{
+  // Clear all histograms. The registered modules are kept.
+
+  for( auto& m : fModules ) {
+    for( auto& h : m.hist )
+      h.reset();
+  }
+  fTicks = fNs = 0;
+  if( fgActive == this ) {
+    fNs0 = THaBenchmark::Now();
+    fTick0 = Ticks();
+  }
+}
+
+//_____________________________________________________________________________
+Double_t ModuleProfiler::GetNsPerTick() const
+{
+  // Duration of one tick in ns, as measured while recording
+
+#ifdef PODD_PROFILER_TSC
+  ULong64_t ticks = fTicks, ns = fNs;
+  if( fgActive == this ) {
+    ticks += Ticks() - fTick0;
+    ns += THaBenchmark::Now() - fNs0;
+  }
+  return (ticks > 0) ? Double_t(ns)/Double_t(ticks) : 0.0;
+#else
+  return 1.0;
+#endif
+}
+
+//_____________________________________________________________________________
+const THaLatencyHistogram* ModuleProfiler::GetHistogram( Int_t slot,
+                                                         EStage stage ) const
+{
+  // Histogram of the durations (in ticks) of the given module and stage.
+  // nullptr if there were no such calls.
+
+  if( slot < 0 || static_cast<UInt_t>(slot) >= fModules.size() ||
+      stage < 0 || stage >= kNStages )
+    return nullptr;
+  return fModules[slot].hist[stage].get();
+}
+
+//_____________________________________________________________________________
+const char* ModuleProfiler::GetStageName( EStage stage )
+{
+  static const char* const names[kNStages] = {
+    "Clear", "Decode", "CoarseTracking", "CoarseReconstruct",
+    "Tracking", "Reconstruct", "Physics", "Output"
+  };
+  return (stage >= 0 && stage < kNStages) ? names[stage] : "unknown";
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Trace( THaAnalysisObject* obj, EStage stage,
+                            ULong64_t t0 )
+{
+  // Record a span of 'obj' in the active THaTimelineTrace. The span is
+  // named after the object's prefix, without the trailing dot.
+
+  const char* name = obj->GetPrefix();
+  UInt_t len = kMaxUInt;
+  if( name && *name ) {
+    len = strlen(name);
+    if( name[len-1] == '.' )
+      --len;
+  } else
+    name = obj->GetName();
+  THaTimelineTrace::Record(name, GetStageName(stage), t0,
+                           THaBenchmark::Now(), nullptr, 0, len);
+}
+
+//_____________________________________________________________________________
+void ModuleProfiler::Print( ostream& os ) const
+{
+  // Print the number of calls, the mean, median, 90th and 99th percentile
+  // and maximum duration per call (in microseconds), and the total time
+  // (in seconds) of each module and stage
+
+  const Double_t us = 1e-3 * GetNsPerTick();
+  size_t w = 10;
+  for( const auto& m : fModules )
+    w = max(w, m.name.length());
+
+  auto fmt = os.flags();
+  auto prec = os.precision();
+  os << "Module timing summary (us per call):" << endl;
+  os << left << setw(static_cast<int>(w)) << "Module" << " "
+     << setw(17) << "Stage" << right
+     << setw(10) << "Calls"
+     << setw(10) << "Mean" << setw(10) << "p50" << setw(10) << "p90"
+     << setw(10) << "p99" << setw(10) << "Max" << setw(10) << "Total/s"
+     << endl;
+  os << fixed;
+  for( const auto& m : fModules ) {
+    for( Int_t i = 0; i < kNStages; ++i ) {
+      const auto& h = m.hist[i];
+      if( !h || h->GetEntries() == 0 )
+        continue;
+      os << left << setw(static_cast<int>(w)) << m.name << " "
+         << setw(17) << GetStageName(static_cast<EStage>(i)) << right
+         << setw(10) << h->GetEntries() << setprecision(2)
+         << setw(10) << us * h->GetMean()
+         << setw(10) << us * h->GetPercentile(0.5)
+         << setw(10) << us * h->GetPercentile(0.9)
+         << setw(10) << us * h->GetPercentile(0.99)
+         << setw(10) << us * Double_t(h->GetMax()) << setprecision(3)
+         << setw(10) << 1e-6 * us * Double_t(h->GetSum())
+         << endl;
+    }
+  }
+  os.flags(fmt);
+  os.precision(prec);
+}
+
+} // namespace Podd
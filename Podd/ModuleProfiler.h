@@ -0,0 +1,153 @@
+#ifndef Podd_ModuleProfiler_h_
+#define Podd_ModuleProfiler_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::ModuleProfiler
+//
+// Per-module, per-stage latency histograms of the event analysis
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "THaAnalysisObject.h"
+#include "THaLatencyHistogram.h"
+#include "THaBenchmark.h"
+#include "THaTimelineTrace.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iosfwd>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PODD_PROFILER_TSC
+#endif
+
+namespace Podd {
+
+class ModuleProfiler {
+
+public:
+  // Analysis stage during which a module's code runs. Detector methods
+  // are assigned to the stage of the apparatus method calling them,
+  // e.g. THaNonTrackingDetector::CoarseProcess to kCoarseReconstruct.
+  enum EStage { kClear = 0, kDecode, kCoarseTrack, kCoarseReconstruct,
+                kTrack, kReconstruct, kPhysics, kOutput, kNStages };
+
+  ModuleProfiler();
+  ModuleProfiler( const ModuleProfiler& ) = delete;
+  ModuleProfiler& operator=( const ModuleProfiler& ) = delete;
+  ~ModuleProfiler();
+
+  // Register the given analysis modules and, for apparatuses, their
+  // detectors. This only fixes the order in the printout; objects not
+  // registered here are registered when they are first timed.
+  void   Init( const std::vector<THaAnalysisObject*>& modules );
+  Int_t  Register( THaAnalysisObject* obj );
+  Int_t  Register( const char* name );
+
+  // Start/stop recording. Only one profiler can be recording at a time.
+  void   Start();
+  void   Stop();
+  void   Reset();
+  Bool_t IsActive() const { return fgActive == this; }
+
+  // Print a table of the latency percentiles of each module and stage
+  void   Print( std::ostream& os ) const;
+
+  Double_t GetNsPerTick() const;
+  const THaLatencyHistogram* GetHistogram( Int_t slot, EStage stage ) const;
+
+  static ModuleProfiler* GetActive()  { return fgActive; }
+  static const char*     GetStageName( EStage stage );
+
+  // Raw timestamp. Time stamp counter ticks on x86, else nanoseconds.
+  static ULong64_t Ticks() {
+#ifdef PODD_PROFILER_TSC
+    return __builtin_ia32_rdtsc();
+#else
+    return THaBenchmark::Now();
+#endif
+  }
+
+  // Times the code in its scope as the given stage of the given module.
+  // If the current event is sampled by a THaTimelineTrace, the span of
+  // an analysis object is also recorded there. Costs two tests if neither
+  // a profiler nor a trace is active.
+  class Span {
+  public:
+    Span( THaAnalysisObject* obj, EStage stage )
+      : fProf(fgActive), fObj(nullptr), fStage(stage), fTraceT0(0) {
+      if( fProf ) {
+        fSlot = fProf->Slot(obj);
+        fT0 = Ticks();
+      }
+      if( THaTimelineTrace::IsSampling() ) {
+        fObj = obj;
+        fTraceT0 = THaBenchmark::Now();
+      }
+    }
+    // For pseudo-modules, slot as returned by Register(const char*)
+    Span( Int_t slot, EStage stage )
+      : fProf(fgActive), fObj(nullptr), fStage(stage), fTraceT0(0) {
+      if( fProf ) {
+        fSlot = slot;
+        fT0 = Ticks();
+      }
+    }
+    Span( const Span& ) = delete;
+    Span& operator=( const Span& ) = delete;
+    ~Span() {
+      if( fProf )
+        fProf->Fill(fSlot, fStage, Ticks() - fT0);
+      if( fTraceT0 )
+        Trace(fObj, fStage, fTraceT0);
+    }
+  private:
+    ModuleProfiler*    fProf;
+    THaAnalysisObject* fObj;
+    EStage             fStage;
+    Int_t              fSlot;
+    ULong64_t          fT0;
+    ULong64_t          fTraceT0;
+  };
+
+private:
+  struct Module_t {
+    Module_t( THaAnalysisObject* o, std::string n )
+      : obj(o), name(std::move(n)) {}
+    THaAnalysisObject* obj;    // Module, nullptr for pseudo-modules
+    std::string        name;   // Name in printout
+    std::array<std::unique_ptr<THaLatencyHistogram>,kNStages> hist;
+  };
+  std::vector<Module_t> fModules;  // Registered modules, in order
+  ULong64_t  fTick0;     // Ticks at Start()
+  ULong64_t  fNs0;       // Time (ns) at Start()
+  ULong64_t  fTicks;     // Ticks accumulated in earlier Start/Stop periods
+  ULong64_t  fNs;        // Time accumulated in earlier Start/Stop periods
+
+  Int_t  Slot( THaAnalysisObject* obj );
+  static void Trace( THaAnalysisObject* obj, EStage stage, ULong64_t t0 );
+  void   Fill( Int_t slot, EStage stage, ULong64_t ticks ) {
+    auto& h = fModules[slot].hist[stage];
+    if( !h )
+      h.reset(new THaLatencyHistogram);
+    h->Fill(ticks);
+  }
+
+  static ModuleProfiler* fgActive;  // Profiler currently recording
+};
+
+//_____________________________________________________________________________
+inline Int_t ModuleProfiler::Slot( THaAnalysisObject* obj )
+{
+  // Index of 'obj' in fModules. The index is cached in the object itself.
+
+  UInt_t slot = obj->fProfileSlot;
+  if( slot < fModules.size() && fModules[slot].obj == obj )
+    return static_cast<Int_t>(slot);
+  return Register(obj);
+}
+
+} // namespace Podd
+
+#endif
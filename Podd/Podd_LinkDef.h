@@ -27,12 +27,14 @@
 #pragma link C++ class THaHashList+;
 #pragma link C++ class THaInterface+;
 #pragma link C++ class THaRun+;
+#pragma link C++ class THaShmRun+;
 #pragma link C++ class THaRunBase+;
 #pragma link C++ class THaCodaRun+;
 #pragma link C++ class THaRunParameters+;
 #pragma link C++ class THaApparatus+;
 #pragma link C++ class THaSpectrometer+;
 #pragma link C++ class Podd::DecData+;
+#pragma link C++ class Podd::PreFilter+;
 #pragma link C++ class BdataLoc+;
 #pragma link C++ class CrateLoc+;
 #pragma link C++ class CrateLocMulti+;
@@ -110,6 +112,9 @@
 #pragma link C++ class Podd::MCTrackPoint+;
 #pragma link C++ class Podd::SimDecoder+;
 #pragma link C++ class Podd::CodaRawDecoder+;
+#pragma link C++ class Podd::HitCacheDecoder+;
+#pragma link C++ class Podd::HitCacheRun+;
+#pragma link C++ class Podd::HitCacheWriter+;
 #pragma link C++ class Podd::InterStageModule+;
 #pragma link C++ class Podd::TimeCorrectionModule+;
 #pragma link C++ class Podd::DetectorData+;
@@ -118,6 +123,7 @@
 #pragma link C++ class Podd::MultiFileRun+;
 #pragma link C++ class Podd::MultiFileRun::StreamInfo+;
 #pragma link C++ class Podd::MultiFileRun::FileInfo+;
+#pragma link C++ class Podd::Checkpoint+;
 
 #ifdef ONLINE_ET
 #pragma link C++ class THaOnlRun+;
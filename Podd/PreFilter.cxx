@@ -0,0 +1,197 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::PreFilter
+//
+// Event selection on raw data, evaluated by THaAnalyzer right after an
+// event has been read and before it is decoded. Events failing the cut
+// are discarded without ever going through THaEvData::LoadEvent() or
+// detector decoding, which makes skims of rare triggers much faster.
+//
+// Only data that can be obtained without decoding modules are available:
+//
+//   PF.evtype    CODA event type
+//   PF.evnum     event number
+//   PF.trigbits  trigger bits from the TI/TS bank (CODA3)
+//
+// plus any "word" and "roclen" locations defined in the database in
+// the same way as for Podd::DecData. Types that need decoded module data
+// ("crate", "multi", "bit" etc.) are rejected during initialization.
+// Likewise, the cut may only use this object's global variables.
+//
+// The cut expression is given in the constructor or, if empty, read from
+// the database key "<prefix>cut". Example:
+//
+//   Podd::PreFilter* pf = new Podd::PreFilter("PF", "(PF.trigbits&0x4)!=0");
+//   analyzer->SetPreFilter(pf);
+//
+// Only physics events are filtered. Events that the decoder cannot
+// pre-decode (see THaEvData::PreDecode) are always accepted.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "PreFilter.h"
+#include "THaCut.h"
+#include "THaEvData.h"
+#include "TDatime.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+PreFilter::PreFilter( const char* name, const char* cutexpr,
+                      const char* descript )
+  : DecData( name, descript ), evnum(0), trigbits(0), fCutExpr(cutexpr),
+    fCut(nullptr)
+{
+}
+
+//_____________________________________________________________________________
+PreFilter::~PreFilter()
+{
+  // Destructor
+
+  delete fCut;
+  RemoveVariables();
+}
+
+//_____________________________________________________________________________
+void PreFilter::Clear( Option_t* opt )
+{
+  // Reset event-by-event data
+
+  DecData::Clear(opt);
+  evnum    = 0;
+  trigbits = 0;
+}
+
+//_____________________________________________________________________________
+Int_t PreFilter::DefineVariables( EMode mode )
+{
+  // Define/delete global variables
+
+  Int_t ret = DecData::DefineVariables( mode );
+  if( ret != kOK )
+    return ret;
+
+  RVarDef vars[] = {
+    { "evnum",    "Event number",  "evnum" },
+    { "trigbits", "Trigger bits",  "trigbits" },
+    { nullptr }
+  };
+  return DefineVarsFromList( vars, mode );
+}
+
+//_____________________________________________________________________________
+Int_t PreFilter::ReadDatabase( const TDatime& date )
+{
+  // Read cut expression and data location definitions. The database is
+  // optional if a cut expression was given in the constructor.
+
+  fDBCutExpr = "";
+  FILE* file = OpenFile( date );
+  if( !file ) {
+    if( fCutExpr.IsNull() )
+      return kFileError;
+    fBdataLoc.Clear();
+    return kOK;
+  }
+  TString dbkey = GetPrefix();
+  dbkey.Append("cut");
+  LoadDBvalue( file, date, dbkey, fDBCutExpr );
+  fclose(file);
+
+  return DecData::ReadDatabase( date );
+}
+
+//_____________________________________________________________________________
+THaAnalysisObject::EStatus PreFilter::Init( const TDatime& run_time )
+{
+  // Initialize data locations and variables, then compile the cut
+
+  const char* const here = "Init";
+
+  delete fCut; fCut = nullptr;
+
+  if( DecData::Init( run_time ) != kOK )
+    return fStatus;
+
+  // Only the raw crate buffers are available before full decoding
+  TIter next( &fBdataLoc );
+  while( auto* dataloc = static_cast<BdataLoc*>(next()) ) {
+    if( dataloc->NeedsSlotData() ) {
+      Error( Here(here), "Variable %s of type \"%s\" requires decoded module "
+             "data, which are not available before full event decoding. "
+             "Fix database.", dataloc->GetName(), dataloc->GetTypeKey() );
+      return fStatus = kInitError;
+    }
+  }
+
+  const TString& expr = fCutExpr.IsNull() ? fDBCutExpr : fCutExpr;
+  if( expr.IsNull() ) {
+    Warning( Here(here), "No cut defined. All events will be accepted." );
+    return fStatus;
+  }
+  TString cutname = GetName();
+  cutname.Append("_Test");
+  fCut = new THaCut( cutname, expr, "PreFilter" );
+  if( fCut->IsZombie() || fCut->IsError() ) {
+    Error( Here(here), "Invalid cut expression \"%s\".", expr.Data() );
+    delete fCut; fCut = nullptr;
+    return fStatus = kInitError;
+  }
+  vector<string> vars;
+  fCut->GetVarNames(vars);
+  for( const auto& var : vars ) {
+    if( !TString(var).BeginsWith(GetPrefix()) ) {
+      Error( Here(here), "Cut uses variable %s, which is not available "
+             "before full event decoding. Only %s* variables are allowed.",
+             var.c_str(), GetPrefix() );
+      delete fCut; fCut = nullptr;
+      return fStatus = kInitError;
+    }
+  }
+  return fStatus;
+}
+
+//_____________________________________________________________________________
+Int_t PreFilter::Decode( const THaEvData& evdata )
+{
+  // Extract header data and the raw data locations from the event
+
+  Int_t ret = DecData::Decode( evdata );
+  evnum    = evdata.GetEvNum();
+  trigbits = evdata.GetTrigBits();
+  return ret;
+}
+
+//_____________________________________________________________________________
+Bool_t PreFilter::Accept( const THaEvData& evdata )
+{
+  // Return true if the pre-decoded event in 'evdata' passes the cut.
+  // Events are always accepted if this object is not initialized or has
+  // no cut.
+
+  if( Decode( evdata ) != 0 || !fCut )
+    return true;
+  return fCut->EvalCut();
+}
+
+//_____________________________________________________________________________
+void PreFilter::Print( Option_t* opt ) const
+{
+  // Print cut and current data
+
+  DecData::Print(opt);
+  cout << " event number = " << evnum << endl;
+  cout << " cut = \"" << (fCutExpr.IsNull() ? fDBCutExpr : fCutExpr) << "\""
+       << endl;
+}
+
+} // namespace Podd
+
+ClassImp(Podd::PreFilter)
@@ -0,0 +1,53 @@
+#ifndef Podd_PreFilter_h_
+#define Podd_PreFilter_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::PreFilter
+//
+// Raw-level event selection, evaluated before full event decoding
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "DecData.h"
+#include "TString.h"
+
+class THaCut;
+
+namespace Podd {
+
+class PreFilter : public DecData {
+
+public:
+  explicit PreFilter( const char* name = "PF", const char* cutexpr = "",
+                      const char* description = "Raw-level event pre-filter" );
+  virtual ~PreFilter();
+
+  virtual EStatus Init( const TDatime& run_time );
+  virtual void    Clear( Option_t* opt="" );
+  virtual Int_t   Decode( const THaEvData& );
+  virtual void    Print( Option_t* opt="" ) const;
+
+  // Load data from a pre-decoded event and evaluate the cut
+  Bool_t          Accept( const THaEvData& evdata );
+
+  const char*     GetCutExpr() const { return fCutExpr.Data(); }
+  THaCut*         GetCut()     const { return fCut; }
+  void            SetCutExpr( const char* expr ) { fCutExpr = expr; }
+
+protected:
+  UInt_t          evnum;       // Event number
+  UInt_t          trigbits;    // Trigger bits (CODA3 TI/TS bank)
+  TString         fCutExpr;    // Cut expression given by user
+  TString         fDBCutExpr;  // Cut expression from database
+  THaCut*         fCut;        // Compiled selection cut
+
+  virtual Int_t   DefineVariables( EMode mode = kDefine );
+  virtual Int_t   ReadDatabase( const TDatime& date );
+
+  ClassDef(PreFilter,0)  // Raw-level event pre-filter
+};
+
+} // namespace Podd
+
+#endif
@@ -14,6 +14,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaAnalysisObject.h"
+#include "EventArena.h"
 #include "THaVarList.h"
 #include "THaGlobals.h"
 #include "TClass.h"
@@ -47,7 +48,7 @@ THaAnalysisObject::THaAnalysisObject( const char* name,
   TNamed(name,description), fPrefix(nullptr), fStatus(kNotinit),
   fDebug(0), fIsInit(false), fIsSetup(false), fProperties(0),
   fOKOut(false), fInitDate(19950101,0), fNEventsWithWarnings(0),
-  fExtra(nullptr)
+  fExtra(nullptr), fArena(nullptr), fProfileSlot(-1)
 {
   // Constructor
 
@@ -59,7 +60,7 @@ THaAnalysisObject::THaAnalysisObject( const char* name,
 THaAnalysisObject::THaAnalysisObject()
   : fPrefix(nullptr), fStatus(kNotinit), fDebug(0), fIsInit(false),
     fIsSetup(false), fProperties(), fOKOut(false), fNEventsWithWarnings(0),
-    fExtra(nullptr)
+    fExtra(nullptr), fArena(nullptr), fProfileSlot(-1)
 {
   // only for ROOT I/O
 }
@@ -72,6 +73,7 @@ THaAnalysisObject::~THaAnalysisObject()
   RemoveVariables();
 
   delete fExtra; fExtra = nullptr;
+  delete fArena; fArena = nullptr;
 
   if (fgModules) {
     fgModules->Remove( this );
@@ -101,6 +103,29 @@ Int_t THaAnalysisObject::Begin( THaRunBase* /* run */ )
   return 0;
 }
 
+//_____________________________________________________________________________
+void THaAnalysisObject::Clear( Option_t* )
+{
+  // Clear event-by-event data. The default Clear() releases all objects
+  // allocated from this object's event arena, if any.
+
+  if( fArena )
+    fArena->Reset();
+}
+
+//_____________________________________________________________________________
+Podd::EventArena& THaAnalysisObject::GetEventArena()
+{
+  // Return the per-event memory arena of this object, creating it if
+  // necessary. Objects allocated from it remain valid until the next Clear().
+  // Derived classes that override Clear() must call their base class
+  // Clear() for this to happen.
+
+  if( !fArena )
+    fArena = new Podd::EventArena;
+  return *fArena;
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalysisObject::End( THaRunBase* /* run */ )
 {
@@ -511,6 +536,29 @@ Int_t THaAnalysisObject::InitOutput( THaOutput* /* output */ )
   return kOK;
 }
 
+//_____________________________________________________________________________
+Int_t THaAnalysisObject::WriteCheckpoint( TDirectory* /* dir */ )
+{
+  // Called by THaAnalyzer when writing a checkpoint of the replay.
+  //
+  // Modules that carry state from one event to the next (running sums,
+  // sequence predictors, trees of their own etc.) should save that state
+  // here, as objects in 'dir' whose names start with the module's prefix.
+  // Use TObject::kOverwrite so that only the latest state is kept.
+  // Return 0 on success.
+
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalysisObject::ReadCheckpoint( TDirectory* /* dir */ )
+{
+  // Called by THaAnalyzer::Resume after Init() and Begin() to restore the
+  // state saved by WriteCheckpoint(). Return 0 on success.
+
+  return 0;
+}
+
 //_____________________________________________________________________________
 void THaAnalysisObject::MakePrefix( const char* basename )
 {
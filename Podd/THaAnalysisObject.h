@@ -27,6 +27,11 @@ class TVector3;
 class THaRunBase;
 class THaOutput;
 class TObjArray;
+class TDirectory;
+namespace Podd {
+  class EventArena;
+  class ModuleProfiler;
+}
 
 class THaAnalysisObject : public TNamed {
   
@@ -44,7 +49,7 @@ public:
   virtual ~THaAnalysisObject();
   
   virtual Int_t        Begin( THaRunBase* r=nullptr );
-  virtual void         Clear( Option_t* ="" ) {} // override TNamed::Clear()
+  virtual void         Clear( Option_t* opt="" ); // override TNamed::Clear()
   virtual Int_t        End( THaRunBase* r=nullptr );
   virtual const char*  GetDBFileName() const;
           const char*  GetClassName() const;
@@ -67,6 +72,9 @@ public:
 
   virtual Int_t        InitOutput( THaOutput * );
           Bool_t       IsOKOut() const           { return fOKOut; }
+  // Save/restore state kept across events (THaAnalyzer checkpoints)
+  virtual Int_t        WriteCheckpoint( TDirectory* dir );
+  virtual Int_t        ReadCheckpoint( TDirectory* dir );
   virtual FILE*        OpenFile( const TDatime& date );
   virtual FILE*        OpenRunDBFile( const TDatime& date );
   virtual void         Print( Option_t* opt="" ) const;
@@ -124,6 +132,8 @@ protected:
 
   TObject*        fExtra;     // Additional member data (for binary compat.)
 
+  Podd::EventArena* fArena;   //! Memory for per-event transient objects
+
   virtual Int_t        DefineVariables( EMode mode = kDefine );
           Int_t        DefineVarsFromList( const VarDef* list,
                                            EMode mode = kDefine,
@@ -142,6 +152,7 @@ protected:
   THaAnalysisObject*   FindModule( const char* name, const char* classname,
 				   bool do_error = true );
 
+  Podd::EventArena&    GetEventArena();
   virtual const char*  Here( const char* ) const;
   virtual const char*  ClassNameHere( const char* ) const;
           Int_t        LoadDB( FILE* f, const TDatime& date,
@@ -165,6 +176,9 @@ protected:
 private:
   Int_t DefineVariablesWrapper( EMode mode = kDefine );
 
+  Int_t           fProfileSlot; //! Index in Podd::ModuleProfiler (cache)
+  friend class Podd::ModuleProfiler;
+
   static TList* fgModules;  // List of all currently existing Analysis Modules
 
   ClassDef(THaAnalysisObject,2)   //ABC for a data analysis object
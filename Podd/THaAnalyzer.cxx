@@ -26,10 +26,17 @@
 #include "THaGlobals.h"
 #include "THaSpectrometer.h"
 #include "THaCutList.h"
+#include "THaCut.h"
+#include "THaDetector.h"
 #include "THaPhysicsModule.h"
 #include "InterStageModule.h"
 #include "THaPostProcess.h"
+#include "PreFilter.h"
+#include "Checkpoint.h"
+#include "ModuleProfiler.h"
 #include "THaBenchmark.h"
+#include "THaTimelineTrace.h"
+#include "THaPerfCounters.h"
 #include "THaEvtTypeHandler.h"
 #include "THaEpicsEvtHandler.h"
 #include "TList.h"
@@ -38,18 +45,25 @@
 #include "TDatime.h"
 #include "TError.h"
 #include "TClass.h"
+#include "TBits.h"
 #include "TSystem.h"
 #include "TROOT.h"
 #include "TDirectory.h"
 #include "THaCrateMap.h"
 #include "Helper.h"
+#include "Textvars.h"  // Podd::JsonString
+#include "ha_compiledata.h"
 
 #include <iostream>
+#include <fstream>
 #include <iomanip>
 #include <exception>
 #include <stdexcept>
 #include <algorithm>
 #include <vector>
+#include <string>
+#include <cstring>
+#include <sys/resource.h>  // for getrusage
 
 using namespace std;
 using namespace Decoder;
@@ -64,6 +78,18 @@ THaAnalyzer* THaAnalyzer::fgAnalyzer = nullptr;
 //FIXME:
 // do we need to "close" scalers/EPICS analysis if we reach the event limit?
 
+//_____________________________________________________________________________
+// Names of the benchmarks recorded during analysis, in reporting order
+static const vector<TString>& BenchmarkNames()
+{
+  static const vector<TString> names = {
+    "Init", "Begin", "RawDecode", "Decode", "CoarseTracking",
+    "CoarseReconstruct", "Tracking", "Reconstruct", "Physics", "PostProcess",
+    "End", "Output", "Cuts", "Checkpoint"
+  };
+  return names;
+}
+
 //_____________________________________________________________________________
 // Convert from type-unsafe ROOT containers to STL vectors
 template<typename T>
@@ -105,6 +131,7 @@ THaAnalyzer::THaAnalyzer()
   , fPrevEvent(nullptr)
   , fRun(nullptr)
   , fEvData(nullptr)
+  , fPreFilter(nullptr)
   , fIsInit(false)
   , fAnalysisStarted(false)
   , fLocalEvent(false)
@@ -115,7 +142,19 @@ THaAnalyzer::THaAnalyzer()
   , fDoPhysics(true)
   , fDoOtherEvents(true)
   , fDoSlowControl(true)
+  , fDecodeOnDemand(false)
   , fFirstPhysics(true)
+  , fPreFilterSkip(false)
+  , fCkptEvents(0)
+  , fCkptMinutes(0)
+  , fCkptLastCount(0)
+  , fCkptLastTime(0)
+  , fNbuf(0)
+  , fResumeFrom(nullptr)
+  , fProfiler(nullptr)
+  , fProfOutputSlot(-1)
+  , fTrace(nullptr)
+  , fPerf(nullptr)
   , fExtra(nullptr)
 {
   // Default constructor.
@@ -147,6 +186,11 @@ THaAnalyzer::~THaAnalyzer()
   DeleteContainer(fPostProcess);
   DeleteContainer(fEvtHandlers);
   DeleteContainer(fInterStage);
+  delete fPreFilter;
+  delete fResumeFrom;
+  delete fProfiler;
+  delete fTrace;
+  delete fPerf;
   delete fExtra; fExtra = nullptr;
   delete fBench;
   if( fgAnalyzer == this )
@@ -228,6 +272,42 @@ Int_t THaAnalyzer::AddPostProcess( THaPostProcess* module )
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaAnalyzer::SetPreFilter( Podd::PreFilter* filter )
+{
+  // Set the raw-level pre-filter. Physics events failing the filter's cut
+  // are discarded right after reading, before LoadEvent() and any further
+  // processing. The analyzer takes ownership of 'filter'. A null pointer
+  // removes the current filter.
+
+  const char* const here = "SetPreFilter";
+
+  if( filter == fPreFilter )
+    return 0;
+
+  if( fAnalysisStarted ) {
+    Error( Here(here), "Cannot change the pre-filter while analysis "
+                       "is in progress. Close() this analysis first." );
+    return 237;
+  }
+
+  // As in AddInterStage, initialize right away if we are initialized
+  if( filter && fIsInit ) {
+    if( !fRun || !fRun->IsInit()) {
+      Error(Here(here),"fIsInit, but bad fRun?!?");
+      return 236;
+    }
+    TDatime run_time = fRun->GetDate();
+    Int_t retval = filter->Init(run_time);
+    if( retval )
+      return retval;
+  }
+
+  delete fPreFilter;
+  fPreFilter = filter;
+  return 0;
+}
+
 //_____________________________________________________________________________
 void THaAnalyzer::ClearCounters()
 {
@@ -253,6 +333,7 @@ void THaAnalyzer::Close()
   fSpectrometers.clear();
   fPhysics.clear();
   fEvtHandlers.clear();
+  fEvtTypeDispatch.clear();
 
   if( gHaRun && *gHaRun == *fRun )
     gHaRun = nullptr;
@@ -273,7 +354,106 @@ void THaAnalyzer::Close()
 //_____________________________________________________________________________
 void THaAnalyzer::EnableBenchmarks( Bool_t b )
 {
+  // Enable/disable detailed timing statistics. These include the
+  // distribution of the durations of each analysis stage, from which
+  // WriteBenchmarkReport() obtains latency percentiles.
+
   fDoBench = b;
+  fBench->EnableLatency(b);
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::EnableModuleProfiling( Bool_t b )
+{
+  // Enable/disable timing of the individual analysis modules and their
+  // detectors in each analysis stage. The distribution of the durations
+  // of the calls is recorded by a Podd::ModuleProfiler and summarized,
+  // with latency percentiles, in the timing summary, which also goes to
+  // the summary file. The added overhead is well below 1%.
+
+  if( b ) {
+    if( !fProfiler )
+      fProfiler = new ModuleProfiler;
+  } else {
+    delete fProfiler;
+    fProfiler = nullptr;
+  }
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::EnablePerfCounters( Bool_t b )
+{
+  // Enable/disable the hardware performance counters (cycles, instructions,
+  // cache misses, branch misses) of the analysis thread, read at the
+  // start and end of each benchmarked analysis stage and around the
+  // decoding of each crate slot. The timing summary then shows IPC and
+  // misses per event for each stage and each decoder module type.
+  // Implies EnableBenchmarks(). Must be called from the thread that runs
+  // Process(). Requires Linux and access to the CPU's counters; if these
+  // are unavailable, a warning is printed and the counters stay disabled.
+  // Each reading costs a system call, which slows down decoding of events
+  // with many slots noticeably, so enable this for diagnosis only.
+
+  static const char* const here = "EnablePerfCounters";
+
+  if( b ) {
+    if( !fPerf ) {
+      fPerf = new THaPerfCounters;
+      if( !fPerf->Open() ) {
+        Warning( here, "Hardware performance counters not available: %s",
+                 fPerf->GetError() );
+        delete fPerf;
+        fPerf = nullptr;
+        return;
+      }
+    }
+    EnableBenchmarks();
+  } else {
+    delete fPerf;
+    fPerf = nullptr;
+  }
+  fBench->SetPerfCounters(fPerf);
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::EnableTimelineTrace( const char* filename, UInt_t every,
+                                       UInt_t max_events )
+{
+  // Record a timeline of the processing of every 'every'-th event, up to
+  // 'max_events' events (0: no limit), and write it to 'filename' at the
+  // end of each replay. The file is in Chrome Trace Event format and can
+  // be opened with https://ui.perfetto.dev. It shows the reading, raw
+  // decoding (per ROC), each stage of each apparatus and detector, each
+  // physics module, the cuts, and the steps of the output.
+  // An empty or null filename disables the trace.
+
+  if( filename && *filename ) {
+    if( !fTrace )
+      fTrace = new THaTimelineTrace(every, max_events);
+    else
+      fTrace->SetSampling(every, max_events);
+    fTraceFileName = filename;
+  } else {
+    delete fTrace;
+    fTrace = nullptr;
+    fTraceFileName.Clear();
+  }
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::EnableDecodeOnDemand( Bool_t b )
+{
+  // Decode only the detectors whose data are actually used by the output
+  // or by cuts. Detectors not needed for the Decode-stage tests are decoded
+  // only if an event passes these tests. See InitDecodeOnDemand().
+  //
+  // Detectors that other modules use internally without any of the
+  // detector's variables being referenced must be declared with
+  // RequireDecode().
+
+  fDecodeOnDemand = b;
+  if( fIsInit )
+    InitDecodeOnDemand();
 }
 
 //_____________________________________________________________________________
@@ -324,6 +504,7 @@ bool THaAnalyzer::EvalStage( int n )
   if( fDoBench ) fBench->Begin("Cuts");
 
   const Stage_t& theStage = fStages[n];
+  THaTimelineTrace::Span span(theStage.name, "cuts");
 
   //FIXME: support stage-wise blocks of histograms
   //  if( theStage.hist_list ) {
@@ -394,6 +575,7 @@ void THaAnalyzer::InitCounters() {
     {kNevAccepted,     "events accepted"},
     {kDecodeErr,       "decoding error"},
     {kCodaErr,         "CODA errors"},
+    {kPreFilterTest,   "skipped by pre-filter"},
     {kRawDecodeTest,   "skipped after raw decoding"},
     {kDecodeTest,      "skipped after Decode"},
     {kCoarseTrackTest, "skipped after Coarse Tracking"},
@@ -426,6 +608,183 @@ void THaAnalyzer::InitCuts()
   }
 }
 
+//_____________________________________________________________________________
+static inline bool BeginsWith( const string& name, const char* prefix )
+{
+  return name.compare(0, strlen(prefix), prefix) == 0;
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::InitDecodeOnDemand()
+{
+  // If decoding on demand is enabled, determine which detectors need to be
+  // decoded and when. Called from DoInit() after the cuts and the output
+  // have been initialized.
+  //
+  // A detector is decoded if
+  //  - any of its global variables is used by the output or by a cut, or
+  //  - any variable of its apparatus proper (i.e. not of one of the
+  //    apparatus's detectors) is used, because the reconstruction of an
+  //    apparatus generally depends on all its detectors, or
+  //  - any variable of a physics or inter-stage module is used. These
+  //    modules may depend on any apparatus, so this enables all apparatuses
+  //    that have any used detectors or variables, or
+  //  - it or its apparatus was named with RequireDecode().
+  //
+  // Detectors needed by the tests of the "Decode" block are decoded in the
+  // Decode stage as usual. The remaining ones are decoded only if the event
+  // passes these tests. If there are inter-stage modules for the Decode
+  // stage, all needed detectors are decoded in the Decode stage.
+
+  static const char* const here = "InitDecodeOnDemand";
+
+  if( !fDecodeOnDemand ) {
+    for( auto* app : fApps )
+      app->ClearDecodeLists();
+    return;
+  }
+
+  // Collect the names of all global variables in use, and of those used
+  // in the Decode stage
+  vector<string> used, early;
+  if( fOutput )
+    fOutput->GetVarNames(used);
+  TIter next_cut( gHaCuts->GetCutList() );
+  while( auto* cut = static_cast<THaCut*>( next_cut() ))
+    cut->GetVarNames(used);
+  if( static_cast<Int_t>(fStages.size()) > kDecode &&
+      fStages[kDecode].cut_list ) {
+    TIter next_dcut( fStages[kDecode].cut_list );
+    while( auto* cut = static_cast<THaCut*>( next_dcut() ))
+      cut->GetVarNames(early);
+  }
+  for( auto* names : {&used, &early} ) {
+    sort(ALL(*names));
+    names->erase( unique(ALL(*names)), names->end() );
+  }
+
+  // Any used names with the given prefix? All such names follow each other
+  // in the sorted list, starting at lower_bound(prefix).
+  auto uses = []( const vector<string>& names, const char* prefix ) -> bool {
+    if( !prefix || !*prefix )
+      return false;
+    auto it = lower_bound(ALL(names), string(prefix));
+    return it != names.end() && BeginsWith(*it, prefix);
+  };
+  // Any used names of the apparatus that do not belong to a detector?
+  auto app_uses = [&uses]( const vector<string>& names,
+                           THaApparatus* app ) -> bool {
+    const char* prefix = app->GetPrefix();
+    if( !uses(names, prefix) )
+      return false;
+    auto it = lower_bound(ALL(names), string(prefix));
+    for( ; it != names.end() && BeginsWith(*it, prefix); ++it ) {
+      bool owned = false;
+      TIter next_det( app->GetDetectors() );
+      while( auto* det = static_cast<THaDetector*>( next_det() )) {
+        const char* dpfx = det->GetPrefix();
+        if( dpfx && *dpfx && BeginsWith(*it, dpfx) ) {
+          owned = true;
+          break;
+        }
+      }
+      if( !owned )
+        return true;
+    }
+    return false;
+  };
+  auto required = [this]( const char* prefix ) -> bool {
+    if( !prefix )
+      return false;
+    for( const auto& name : fRequiredDecode ) {
+      TString req(name);
+      if( !req.EndsWith(".") )
+        req.Append('.');
+      if( BeginsWith(prefix, req.Data()) )
+        return true;
+    }
+    return false;
+  };
+
+  bool all_used = false, all_early = false;
+  for( auto* mod : fInterStage ) {
+    if( mod->GetStage() == kDecode )
+      all_early = true;
+    if( uses(used, mod->GetPrefix()) )
+      all_used = true;
+  }
+  for( auto* mod : fPhysics ) {
+    if( uses(used, mod->GetPrefix()) )
+      all_used = true;
+  }
+
+  UInt_t ndet = 0, nnow = 0, nlater = 0;
+  vector<THaDetector*> now, later;
+  for( auto* app : fApps ) {
+    bool app_needed = all_used || required(app->GetPrefix()) ||
+      app_uses(used, app);
+    bool app_early = all_early || app_uses(early, app);
+    now.clear();
+    later.clear();
+    TIter next_det( app->GetDetectors() );
+    while( auto* det = static_cast<THaDetector*>( next_det() )) {
+      ++ndet;
+      const char* prefix = det->GetPrefix();
+      bool needed = app_needed || uses(used, prefix) || required(prefix);
+      if( !needed ) {
+        if( fVerbose>1 )
+          Info( here, "Not decoding %s, none of its variables are used",
+                prefix );
+        continue;
+      }
+      if( app_early || uses(early, prefix) )
+        now.push_back(det);
+      else
+        later.push_back(det);
+    }
+    app->SetDecodeLists(now, later);
+    nnow += now.size();
+    nlater += later.size();
+  }
+  if( fVerbose>0 )
+    Info( here, "Decoding %u of %u detectors, %u of them after the "
+          "Decode-stage tests", nnow+nlater, ndet, nlater );
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::InitEvtTypeDispatch()
+{
+  // Set up the table of event type handlers by event type. For each CODA
+  // event type up to Decoder::MAX_EVTYPE, list the handlers whose
+  // IsMyEvent() accepts that type, in order of registration. MainAnalysis
+  // calls only these handlers. All handlers are called for larger types.
+  //
+  // The decoder gets a read-only view of which event types have handlers,
+  // so that events nobody is interested in skip handler work entirely.
+  //
+  // Handlers that change their event types after Init() require this
+  // function to be called again.
+
+  fEvtTypeDispatch.assign(Decoder::MAX_EVTYPE+1, {});
+  TBits handled(Decoder::MAX_EVTYPE+1);
+  for( UInt_t itype = 0; itype <= Decoder::MAX_EVTYPE; ++itype ) {
+    auto& handlers = fEvtTypeDispatch[itype];
+    for( auto* obj : fEvtHandlers ) {
+      if( obj->IsMyEvent(itype) )
+        handlers.push_back(obj);
+    }
+    if( !handlers.empty() )
+      handled.SetBitNumber(itype);
+    if( fVerbose > 2 && !handlers.empty() ) {
+      cout << "Event type " << itype << " handled by";
+      for( auto* obj : handlers )
+        cout << " " << obj->GetName();
+      cout << endl;
+    }
+  }
+  fEvData->SetEvtTypesHandled(&handled);
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalyzer::InitModules(
   const std::vector<THaAnalysisObject*>& module_list, TDatime& run_time )
@@ -473,7 +832,11 @@ Int_t THaAnalyzer::Init( THaRunBase* run )
   // This is a wrapper, so we can conveniently control the benchmark counter
   if( !run ) return -1;
 
-  if( !fIsInit ) fBench->Reset();
+  if( !fIsInit ) {
+    fBench->Reset();
+    if( fProfiler ) fProfiler->Reset();
+    if( fPerf ) fPerf->Reset();
+  }
   fBench->Begin("Total");
 
   if( fDoBench ) fBench->Begin("Init");
@@ -744,16 +1107,18 @@ Int_t THaAnalyzer::DoInit( THaRunBase* run )
     ListToVector(gHaEvtHandlers, fEvtHandlers);
   }
 
-  // Initialize all apparatuses, physics modules, event type handlers
-  // and inter-stage modules in that order. Quit on any errors.
+  // Initialize all apparatuses, physics modules, event type handlers,
+  // inter-stage modules and the pre-filter in that order. Quit on any errors.
   cout << "Initializing analysis objects" << endl;
   vector<THaAnalysisObject*> modulesToInit;
   modulesToInit.reserve(fApps.size() + fPhysics.size() +
-                        fEvtHandlers.size() + fInterStage.size());
+                        fEvtHandlers.size() + fInterStage.size() + 1);
   modulesToInit.insert(modulesToInit.end(), ALL(fApps));
   modulesToInit.insert(modulesToInit.end(), ALL(fPhysics));
   modulesToInit.insert(modulesToInit.end(), ALL(fEvtHandlers));
   modulesToInit.insert(modulesToInit.end(), ALL(fInterStage));
+  if( fPreFilter )
+    modulesToInit.push_back(fPreFilter);
   retval = InitModules(modulesToInit, run_time);
   if( retval == 0 ) {
 
@@ -822,6 +1187,8 @@ Int_t THaAnalyzer::DoInit( THaRunBase* run )
 
   // If initialization succeeded, set status flags accordingly
   if( retval == 0 ) {
+    InitDecodeOnDemand();
+    InitEvtTypeDispatch();
     fIsInit = true;
   }
   return retval;
@@ -850,23 +1217,253 @@ Int_t THaAnalyzer::InitOutput( const std::vector<THaAnalysisObject*>& module_lis
 }
 
 
+//_____________________________________________________________________________
+Bool_t THaAnalyzer::CheckpointDue() const
+{
+  // Return true if a checkpoint should be written now
+
+  if( fCkptEvents > 0 && GetCount(kNevRead) - fCkptLastCount >= fCkptEvents )
+    return true;
+  if( fCkptMinutes > 0 &&
+      difftime(time(nullptr), fCkptLastTime) >= 60.0*fCkptMinutes )
+    return true;
+  return false;
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::WriteCheckpoint()
+{
+  // Save the state of the analysis to the output file, so that it can be
+  // continued with Resume() if the replay is interrupted. Saved are:
+  //
+  //  - output trees (auto-saved) and histograms (THaOutput)
+  //  - statistics counters, cut statistics, and run parameters
+  //  - the state of all analysis modules and event type handlers
+  //    (THaAnalysisObject::WriteCheckpoint)
+  //  - the input position as the number of buffers read from the run
+  //
+  // Module states and the analyzer state go into the subdirectory
+  // "Checkpoint" of the output file. Only the most recent checkpoint is
+  // kept. Errors are reported but do not stop the analysis.
+
+  static const char* const here = "WriteCheckpoint";
+
+  if( !fOutput || !fRun )
+    return -1;
+  if( fDoBench ) fBench->Begin("Checkpoint");
+
+  // Get the current file, since the output tree may have been split
+  if( fOutput->GetTree() )
+    fFile = fOutput->GetTree()->GetCurrentFile();
+  if( !fFile ) {
+    if( fDoBench ) fBench->Stop("Checkpoint");
+    return -1;
+  }
+  TDirectory* olddir = gDirectory;
+  fFile->cd();
+
+  Checkpoint ckpt("analyzer", "Analyzer state at checkpoint");
+  ckpt.fRunNumber = fRun->GetNumber();
+  ckpt.fTime      = static_cast<UInt_t>(time(nullptr));
+  ckpt.fNbuf      = fNbuf;
+  ckpt.fNev       = fNev;
+  ckpt.fNentries  = fOutput->GetTree() ? fOutput->GetTree()->GetEntries() : 0;
+  ckpt.fCounts.reserve(fCounters.size());
+  for( const auto& theCounter : fCounters )
+    ckpt.fCounts.push_back(theCounter.count);
+  TIter next(gHaCuts->GetCutList());
+  while( auto* cut = static_cast<THaCut*>(next()) ) {
+    ckpt.fCutNames.emplace_back(cut->GetName());
+    ckpt.fCutCalled.push_back(cut->GetNCalled());
+    ckpt.fCutPassed.push_back(cut->GetNPassed());
+  }
+
+  Int_t ret = fOutput->WriteCheckpoint();
+  TDirectory* dir = fFile->GetDirectory(Checkpoint::kDirName);
+  if( !dir )
+    dir = fFile->mkdir(Checkpoint::kDirName, "Analyzer checkpoint");
+  if( !dir ) {
+    Error( here, "Cannot create checkpoint directory in output file %s",
+           fFile->GetName() );
+    olddir->cd();
+    if( fDoBench ) fBench->Stop("Checkpoint");
+    return -2;
+  }
+  for( auto* theModule : fAnalysisModules ) {
+    if( theModule->WriteCheckpoint(dir) != 0 ) {
+      Error( here, "Error saving state of module %s", theModule->GetName() );
+      ret = -3;
+    }
+  }
+  for( auto* theHandler : fEvtHandlers ) {
+    if( theHandler->IsOK() && theHandler->WriteCheckpoint(dir) != 0 ) {
+      Error( here, "Error saving state of event type handler %s",
+             theHandler->GetName() );
+      ret = -3;
+    }
+  }
+  dir->WriteTObject(fRun, "run", "Overwrite");
+  // The analyzer state last. Resume() checks it against the saved tree.
+  if( dir->WriteTObject(&ckpt, "analyzer", "Overwrite") <= 0 )
+    ret = -4;
+  fFile->WriteStreamerInfo();
+  dir->SaveSelf(true);
+  fFile->SaveSelf(true);
+  fFile->Flush();
+  olddir->cd();
+
+  fCkptLastCount = GetCount(kNevRead);
+  fCkptLastTime  = time(nullptr);
+  if( ret != 0 )
+    Warning( here, "Checkpoint incomplete. Resuming from it may fail." );
+  else if( fVerbose > 1 )
+    cout << "Checkpoint at " << GetCount(kNevRead) << " events read" << endl;
+
+  if( fDoBench ) fBench->Stop("Checkpoint");
+  return ret;
+}
+
+//_____________________________________________________________________________
+Int_t THaAnalyzer::ReadCheckpoint()
+{
+  // Restore the analysis state saved in fResumeFrom and the output file,
+  // and position the input after the last buffer read before the
+  // checkpoint. Called from Process() after BeginAnalysis().
+
+  static const char* const here = "Resume";
+
+  const Checkpoint& ckpt = *fResumeFrom;
+  if( ckpt.fRunNumber != fRun->GetNumber() ) {
+    Error( here, "Checkpoint is for run %u, but trying to resume run %u",
+           ckpt.fRunNumber, fRun->GetNumber() );
+    return -1;
+  }
+  TDirectory* dir = fFile->GetDirectory(Checkpoint::kDirName);
+  if( !dir ) {
+    Error( here, "Checkpoint directory missing in output file" );
+    return -1;
+  }
+
+  // Continue the saved trees and histograms
+  if( fOutput->ReadCheckpoint(fFile) != 0 )
+    return -2;
+  if( fOutput->GetTree() && fOutput->GetTree()->GetEntries() != ckpt.fNentries ) {
+    Error( here, "Output tree has %lld entries, checkpoint expects %lld. "
+           "Output file was not closed cleanly during checkpoint.",
+           fOutput->GetTree()->GetEntries(), ckpt.fNentries );
+    return -2;
+  }
+
+  // Counters and cut statistics
+  if( ckpt.fCounts.size() != fCounters.size() ) {
+    Error( here, "Checkpoint was written by an incompatible analyzer version" );
+    return -3;
+  }
+  for( size_t i = 0; i < fCounters.size(); ++i )
+    fCounters[i].count = ckpt.fCounts[i];
+  for( size_t i = 0; i < ckpt.fCutNames.size(); ++i ) {
+    if( auto* cut = gHaCuts->FindCut(ckpt.fCutNames[i].c_str()) )
+      cut->SetStatistics(ckpt.fCutCalled[i], ckpt.fCutPassed[i]);
+  }
+  fNev = ckpt.fNev;
+
+  // Run parameters collected from the data so far
+  if( auto* run = dynamic_cast<THaRunBase*>(dir->Get("run")) ) {
+    fRun->IncrNumAnalyzed(SINT(run->GetNumAnalyzed()));
+    if( fRun->GetParameters() && run->GetParameters() )
+      fRun->GetParameters()->Prescales() = run->GetParameters()->GetPrescales();
+    delete run;
+  }
+
+  // Module states
+  for( auto* theModule : fAnalysisModules ) {
+    if( theModule->ReadCheckpoint(dir) != 0 ) {
+      Error( here, "Error restoring state of module %s", theModule->GetName() );
+      return -4;
+    }
+  }
+  for( auto* theHandler : fEvtHandlers ) {
+    if( theHandler->IsOK() && theHandler->ReadCheckpoint(dir) != 0 ) {
+      Error( here, "Error restoring state of event type handler %s",
+             theHandler->GetName() );
+      return -4;
+    }
+  }
+
+  // Skip input already analyzed. Nothing is decoded here.
+  if( fVerbose > 0 )
+    cout << "Skipping " << ckpt.fNbuf << " input buffers" << endl;
+  if( fDoBench ) fBench->Begin("RawDecode");
+  for( fNbuf = 0; fNbuf < ckpt.fNbuf; ++fNbuf ) {
+    Int_t status = fRun->ReadEvent();
+    if( status == THaRunBase::READ_EOF || status == THaRunBase::READ_FATAL ) {
+      Error( here, "Input ended after %llu buffers, before checkpoint "
+             "position %llu", fNbuf, ckpt.fNbuf );
+      if( fDoBench ) fBench->Stop("RawDecode");
+      return -5;
+    }
+  }
+  if( fDoBench ) fBench->Stop("RawDecode");
+  return 0;
+}
+
+//_____________________________________________________________________________
+Bool_t THaAnalyzer::PreFilterEvent()
+{
+  // Evaluate the pre-filter for the event buffer just read. The decoder
+  // only extracts the event header, trigger bits and crate data locations
+  // here. Returns false if the event should be discarded.
+  // Non-physics events and events that the decoder cannot pre-decode
+  // always pass.
+
+  if( fEvData->PreDecode( fRun->GetEvBuffer() ) != THaEvData::HED_OK )
+    return true;
+  if( !fEvData->IsPhysicsTrigger() )
+    return true;
+
+  return fPreFilter->Accept( *fEvData );
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalyzer::ReadOneEvent()
 {
   // Read one event from current run (fRun) and raw-decode it using the
   // current decoder (fEvData)
 
+  bool newbuf = !fEvData->DataCached();
+
+  // Checkpoints are taken between input buffers, when all events read so
+  // far have been fully processed
+  if( newbuf && (fCkptEvents > 0 || fCkptMinutes > 0) && CheckpointDue() )
+    WriteCheckpoint();
+
+  if( fTrace ) fTrace->NextEvent();
   if( fDoBench ) fBench->Begin("RawDecode");
 
   // Find next event buffer in CODA file. Quit if error.
   Int_t status = THaRunBase::READ_OK;
-  if( !fEvData->DataCached() )
+  if( newbuf ) {
+    THaTimelineTrace::Span span("ReadEvent", "input");
     status = fRun->ReadEvent();
+    if( status != THaRunBase::READ_EOF && status != THaRunBase::READ_FATAL )
+      ++fNbuf;
+  }
 
+  fPreFilterSkip = false;
   switch( status ) {
   case THaRunBase::READ_OK:
+    // Drop the event right here if it fails the pre-filter
+    if( fPreFilter && newbuf && !PreFilterEvent() ) {
+      fPreFilterSkip = true;
+      Incr(kNevRead);
+      Incr(kPreFilterTest);
+      break;
+    }
     // Decode the event
-    status = fEvData->LoadEvent( fRun->GetEvBuffer() );
+    {
+      THaTimelineTrace::Span span("LoadEvent", "decode");
+      status = fEvData->LoadEvent( fRun->GetEvBuffer() );
+    }
     switch( status ) {
     case THaEvData::HED_OK:     // fall through
     case THaEvData::HED_WARN:
@@ -915,6 +1512,20 @@ void THaAnalyzer::AddEpicsEvtType(Int_t itype)
     if (fEpicsHandler) fEpicsHandler->AddEvtType(itype);
 }
 
+//_____________________________________________________________________________
+void THaAnalyzer::SetCheckpointInterval( UInt_t nevents, UInt_t minutes )
+{
+  // Write a checkpoint of the analysis to the output file every 'nevents'
+  // events read and/or every 'minutes' minutes, whichever comes first.
+  // An interrupted replay can then be continued with Resume().
+  // Zero disables the respective interval. Disabled by default.
+  // From the first checkpoint on, output trees are no longer auto-saved;
+  // their headers are written only at checkpoints.
+
+  fCkptEvents  = nevents;
+  fCkptMinutes = minutes;
+}
+
 //_____________________________________________________________________________
 Int_t THaAnalyzer::SetCountMode( Int_t mode )
 {
@@ -1035,15 +1646,28 @@ void THaAnalyzer::PrintTimingSummary() const
     vector<TString> names;
     if( fDoBench ) {
       cout << "Timing summary:" << endl;
-      names = {
-        "Init", "Begin", "RawDecode", "Decode", "CoarseTracking",
-        "CoarseReconstruct", "Tracking", "Reconstruct", "Physics", "End",
-        "Output", "Cuts"
-      };
+      names = BenchmarkNames();
     }
     names.emplace_back("Total");
     fBench->PrintByName(names);
   }
+  if( fProfiler )
+    fProfiler->Print(cout);
+  if( fPerf ) {
+    // Hardware counters, normalized to the number of events read, so that
+    // the stages add up to the total
+    const Double_t nread = GetCount(kNevRead);
+    cout << "Hardware counter summary:" << endl;
+    THaPerfCounters::PrintHeader(cout, "Stage", 20, nread > 0);
+    vector<TString> names = BenchmarkNames();
+    names.emplace_back("Total");
+    for( const auto& name : names ) {
+      const THaPerfCounters::Sum_t* sum = fBench->GetPerfCounts(name);
+      if( sum && sum->calls > 0 )
+        THaPerfCounters::PrintRow(cout, name, 20, *sum, nread);
+    }
+    fPerf->PrintModules(cout, nread);
+  }
 }
 
 //_____________________________________________________________________________
@@ -1086,6 +1710,122 @@ void THaAnalyzer::PrintSummary( EExitStatus exit_status ) const
     }
   }
 
+  if( fDoBench && !fBenchReportFileName.IsNull() )
+    WriteBenchmarkReport(exit_status);
+}
+
+//_____________________________________________________________________________
+static Long64_t PeakRSS()
+{
+  // Peak resident set size of this process (kB), -1 if unknown
+  struct rusage ru{};
+  if( getrusage(RUSAGE_SELF, &ru) != 0 )
+    return -1;
+#ifdef __APPLE__
+  return ru.ru_maxrss / 1024;  // macOS reports bytes
+#else
+  return ru.ru_maxrss;
+#endif
+}
+
+//_____________________________________________________________________________
+void THaAnalyzer::WriteBenchmarkReport( EExitStatus exit_status ) const
+{
+  // Write the benchmark results of the last replay in JSON format to
+  // fBenchReportFileName, replacing any existing file. The report gives
+  // the overall event rate, the call rate and latency percentiles of each
+  // analysis stage, the peak resident memory and, if the program counts
+  // them (see THaBenchmark::SetAllocCounter), the number of memory
+  // allocations. With EnablePerfCounters(), each stage also gets its IPC
+  // and hardware counts per event read. Intended for comparing performance
+  // between builds, see bench/compare_bench.py.
+
+  static const char* const here = "WriteBenchmarkReport";
+
+  ofstream ostr(fBenchReportFileName.Data());
+  if( !ostr ) {
+    Error( here, "Cannot open benchmark report file %s",
+           fBenchReportFileName.Data() );
+    return;
+  }
+  const char* status = "unknown";
+  switch( exit_status ) {
+  case EExitStatus::kUnknown:    break;
+  case EExitStatus::kEOF:        status = "eof"; break;
+  case EExitStatus::kEvLimit:    status = "event_limit"; break;
+  case EExitStatus::kFatal:      status = "fatal"; break;
+  case EExitStatus::kTerminated: status = "terminated"; break;
+  }
+  const bool count_allocs = (THaBenchmark::GetAllocCounter() != nullptr);
+  const Double_t total = fBench->GetRealTime("Total");
+  const UInt_t nread = GetCount(kNevRead);
+  auto rate = []( Double_t n, Double_t t ) { return (t > 0) ? n/t : 0.0; };
+
+  ostr << fixed << setprecision(3);
+  ostr << "{" << endl
+       << "  \"version\": " << JsonString(HA_VERSION "") << "," << endl
+       << "  \"gitrev\": " << JsonString(HA_GITREV "") << "," << endl
+       << "  \"date\": " << JsonString(TDatime().AsSQLString()) << "," << endl
+       << "  \"input\": " << JsonString(fRun->GetName()) << "," << endl
+       << "  \"run\": " << fRun->GetNumber() << "," << endl
+       << "  \"exit_status\": \"" << status << "\"," << endl
+       << "  \"events\": { \"read\": " << nread
+       << ", \"physics\": " << GetCount(kNevPhysics)
+       << ", \"analyzed\": " << GetCount(kNevAnalyzed)
+       << ", \"accepted\": " << GetCount(kNevAccepted) << " }," << endl
+       << "  \"real_time_s\": " << total << "," << endl
+       << "  \"cpu_time_s\": " << fBench->GetCpuTime("Total") << "," << endl
+       << "  \"events_per_s\": " << rate(nread, total) << "," << endl
+       << "  \"peak_rss_kb\": " << PeakRSS() << "," << endl;
+  if( count_allocs ) {
+    ULong64_t nalloc = fBench->GetAllocations("Total");
+    ostr << "  \"allocations\": " << nalloc << "," << endl
+         << "  \"allocations_per_event\": " << rate(nalloc, nread) << ","
+         << endl;
+  } else {
+    ostr << "  \"allocations\": null," << endl
+         << "  \"allocations_per_event\": null," << endl;
+  }
+  ostr << "  \"stages\": {";
+  const char* sep = "";
+  for( const auto& name : BenchmarkNames() ) {
+    const THaLatencyHistogram* h = fBench->GetLatency(name);
+    if( !h || h->GetEntries() == 0 )
+      continue;
+    Double_t real = fBench->GetRealTime(name);
+    ostr << sep << endl
+         << "    " << JsonString(name) << ": { "
+         << "\"calls\": " << h->GetEntries()
+         << ", \"real_time_s\": " << real
+         << ", \"cpu_time_s\": " << fBench->GetCpuTime(name)
+         << ", \"calls_per_s\": " << rate(h->GetEntries(), real) << "," << endl
+         << "      \"latency_us\": { "
+         << "\"mean\": " << 1e-3 * h->GetMean()
+         << ", \"p50\": " << 1e-3 * h->GetPercentile(0.5)
+         << ", \"p90\": " << 1e-3 * h->GetPercentile(0.9)
+         << ", \"p99\": " << 1e-3 * h->GetPercentile(0.99)
+         << ", \"max\": " << 1e-3 * Double_t(h->GetMax()) << " }";
+    if( count_allocs )
+      ostr << ", \"allocations\": " << fBench->GetAllocations(name);
+    const THaPerfCounters::Sum_t* perf = fBench->GetPerfCounts(name);
+    if( perf && perf->calls > 0 ) {
+      using PC = THaPerfCounters;
+      ostr << "," << endl
+           << "      \"perf_per_event\": { "
+           << "\"ipc\": " << perf->GetIPC()
+           << ", \"cycles\": " << rate(perf->v[PC::kCycles], nread)
+           << ", \"instructions\": " << rate(perf->v[PC::kInstructions], nread)
+           << ", \"cache_misses\": " << rate(perf->v[PC::kCacheMisses], nread)
+           << ", \"branch_misses\": " << rate(perf->v[PC::kBranchMisses], nread)
+           << " }";
+    }
+    ostr << " }";
+    sep = ",";
+  }
+  ostr << endl << "  }" << endl << "}" << endl;
+  if( !ostr )
+    Error( here, "Error writing benchmark report file %s",
+           fBenchReportFileName.Data() );
 }
 
 //_____________________________________________________________________________
@@ -1129,6 +1869,14 @@ Int_t THaAnalyzer::EndAnalysis()
     obj->End(fRun);
   }
 
+  // Write the timeline of the sampled events
+  if( fTrace ) {
+    if( fTrace->Write(fTraceFileName) == 0 && fVerbose > 1 )
+      cout << "Timeline of " << fTrace->GetNsampled() << " events written "
+           << "to " << fTraceFileName << endl;
+    fTrace->Clear();
+  }
+
   if( fDoBench ) fBench->Stop("End");
 
   return 0;
@@ -1170,21 +1918,35 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* mod : fAnalysisModules ) {
       obj = mod;
+      ModuleProfiler::Span span(mod, ModuleProfiler::kClear);
       mod->Clear();
     }
     for( auto* app : fApps ) {
       obj = app;
+      ModuleProfiler::Span span(app, ModuleProfiler::kDecode);
       app->Decode(*fEvData);
     }
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kDecode ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kDecode);
         mod->Process(*fEvData);
       }
     }
     if( fDoBench ) fBench->Stop(stage);
     if( !EvalStage(kDecode) ) return kSkip;
 
+    // Decode the detectors not needed for the Decode-stage tests
+    if( fDecodeOnDemand ) {
+      if( fDoBench ) fBench->Begin(stage);
+      for( auto* app : fApps ) {
+        obj = app;
+        ModuleProfiler::Span span(app, ModuleProfiler::kDecode);
+        app->DecodeDeferred(*fEvData);
+      }
+      if( fDoBench ) fBench->Stop(stage);
+    }
+
     //--- Main physics analysis. Calls the following for each defined apparatus
     //    THaSpectrometer::CoarseTrack  (only for spectrometers)
     //    THaApparatus::CoarseReconstruct
@@ -1199,11 +1961,13 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* spectro : fSpectrometers ) {
       obj = spectro;
+      ModuleProfiler::Span span(spectro, ModuleProfiler::kCoarseTrack);
       spectro->CoarseTrack();
     }
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kCoarseTrack ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kCoarseTrack);
         mod->Process(*fEvData);
       }
     }
@@ -1215,11 +1979,13 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* app : fApps ) {
       obj = app;
+      ModuleProfiler::Span span(app, ModuleProfiler::kCoarseReconstruct);
       app->CoarseReconstruct();
     }
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kCoarseRecon ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kCoarseReconstruct);
         mod->Process(*fEvData);
       }
     }
@@ -1232,11 +1998,13 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* spectro : fSpectrometers ) {
       obj = spectro;
+      ModuleProfiler::Span span(spectro, ModuleProfiler::kTrack);
       spectro->Track();
     }
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kTracking ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kTrack);
         mod->Process(*fEvData);
       }
     }
@@ -1248,11 +2016,13 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* app : fApps ) {
       obj = app;
+      ModuleProfiler::Span span(app, ModuleProfiler::kReconstruct);
       app->Reconstruct();
     }
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kReconstruct ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kReconstruct);
         mod->Process(*fEvData);
       }
     }
@@ -1265,6 +2035,7 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     if( fDoBench ) fBench->Begin(stage);
     for( auto* physmod : fPhysics ) {
       obj = physmod;
+      ModuleProfiler::Span span(physmod, ModuleProfiler::kPhysics);
       Int_t err = physmod->Process( *fEvData );
       if( err == THaPhysicsModule::kTerminate )
         code = kTerminate;
@@ -1276,6 +2047,7 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
     for( auto* mod : fInterStage ) {
       if( mod->GetStage() == kPhysics ) {
         obj = mod;
+        ModuleProfiler::Span span(mod, ModuleProfiler::kPhysics);
         mod->Process(*fEvData);
       }
     }
@@ -1303,6 +2075,8 @@ Int_t THaAnalyzer::PhysicsAnalysis( Int_t code )
   //---  Process output
   if( fDoBench ) fBench->Begin("Output");
   try {
+    ModuleProfiler::Span span(fProfOutputSlot, ModuleProfiler::kOutput);
+    THaTimelineTrace::Span trace_span("Output", "output");
     //--- If Event defined, fill it.
     if( fEvent ) {
       fEvent->GetHeader()->Set( fEvData->GetEvNum(),
@@ -1400,13 +2174,19 @@ Int_t THaAnalyzer::MainAnalysis()
   }
 
   //FIXME Move to "OtherAnalysis"?
-  for( auto* obj : fEvtHandlers ) {
-    try {
-      obj->Analyze(fEvData);
-    }
-    catch( const exception& e) {
-      // Generic exceptions are not fatal. Print message and continue.
-      Error( here, "%s", e.what() );
+  if( fEvData->IsEvtTypeHandled() ) {
+    // Call only the handlers interested in this event type
+    UInt_t evtype = fEvData->GetEvType();
+    const auto& handlers = ( evtype < fEvtTypeDispatch.size() )
+                           ? fEvtTypeDispatch[evtype] : fEvtHandlers;
+    for( auto* obj : handlers ) {
+      try {
+        obj->Analyze(fEvData);
+      }
+      catch( const exception& e) {
+        // Generic exceptions are not fatal. Print message and continue.
+        Error( here, "%s", e.what() );
+      }
     }
   }
 
@@ -1510,12 +2290,37 @@ Int_t THaAnalyzer::Process( THaRunBase* run )
 
   if( fDoBench ) fBench->Begin("Init");
   fNev = 0;
+  fNbuf = 0;
   bool terminate = false, fatal = false;
   UInt_t nlast = fRun->GetLastEvent();
   fAnalysisStarted = true;
   PrepareModuleList();
+  if( fProfiler ) {
+    fProfiler->Init(fAnalysisModules);
+    fProfOutputSlot = fProfiler->Register("output");
+    fProfiler->Start();
+  }
+  if( fTrace ) fTrace->Start();
+  if( fPerf ) THaPerfCounters::SetActive(fPerf);
   if( fDoBench ) fBench->Stop("Init");
   BeginAnalysis();
+  if( fResumeFrom ) {
+    // Restore state and skip input up to the checkpoint
+    status = ReadCheckpoint();
+    delete fResumeFrom; fResumeFrom = nullptr;
+    if( status != 0 ) {
+      Error( here, "Failed to resume from checkpoint. Close() this analysis "
+             "and start over." );
+      if( fProfiler ) fProfiler->Stop();
+      if( fTrace ) fTrace->Stop();
+      THaPerfCounters::SetActive(nullptr);
+      fRun->Close();
+      fBench->Stop("Total");
+      return -5;
+    }
+  }
+  fCkptLastCount = GetCount(kNevRead);
+  fCkptLastTime  = time(nullptr);
   if( fFile ) {
     if( fDoBench ) fBench->Begin("Output");
     fFile->cd();
@@ -1559,6 +2364,10 @@ Int_t THaAnalyzer::Process( THaRunBase* run )
         (fCountMode == kCountAll || fEvData->IsPhysicsTrigger()) )
       cout << dec << fNev << endl;
 
+    //--- Event rejected by the pre-filter. Counted, but not decoded.
+    if( fPreFilterSkip )
+      continue;
+
     //--- Update run parameters with current event
     if( fUpdateRun )
       fRun->Update( fEvData );
@@ -1591,6 +2400,10 @@ Int_t THaAnalyzer::Process( THaRunBase* run )
 
   }  // End of event loop
 
+  if( fProfiler ) fProfiler->Stop();
+  if( fTrace ) fTrace->Stop();
+  THaPerfCounters::SetActive(nullptr);
+
   EndAnalysis();
 
   //--- Close the input file
@@ -1639,6 +2452,66 @@ Int_t THaAnalyzer::Process( THaRunBase* run )
   return SINT(fNev);
 }
 
+//_____________________________________________________________________________
+Int_t THaAnalyzer::Resume( THaRunBase* run )
+{
+  // Continue an analysis of 'run' that was interrupted, from the last
+  // checkpoint in the output file (see SetCheckpointInterval). The output
+  // file set with SetOutFile() is opened for update, and the output trees,
+  // histograms, counters, cut statistics, run parameters and module states
+  // are restored. Input up to the checkpoint is skipped without decoding.
+  // Analysis then continues as with Process(), appending to the output.
+  //
+  // The setup (modules, cut and output definitions, decoder) must be the
+  // same as for the original replay. If the output tree was split into
+  // several files, resume from the last one (SetOutFile).
+  //
+  // Returns the same as Process(), or a negative number if the checkpoint
+  // cannot be used.
+
+  static const char* const here = "Resume";
+
+  if( !run )
+    return -1;
+  if( fAnalysisStarted ) {
+    Error( here, "Analysis in progress. Close() it before resuming." );
+    return -1;
+  }
+  if( fOutFileName.IsNull() ) {
+    Error( here, "Must specify the output file to resume. "
+           "Set it with SetOutFile()." );
+    return -12;
+  }
+  if( fFile ) {
+    Error( here, "Output file already open. Close() the analyzer before "
+           "resuming." );
+    return -11;
+  }
+  auto* file = new TFile( fOutFileName.Data(), "UPDATE" );
+  if( file->IsZombie() ) {
+    Error( here, "Cannot open output file %s for update.", fOutFileName.Data() );
+    delete file;
+    return -14;
+  }
+  TDirectory* dir = file->GetDirectory(Checkpoint::kDirName);
+  auto* ckpt = dir ? dynamic_cast<Checkpoint*>(dir->Get("analyzer")) : nullptr;
+  if( !ckpt ) {
+    Error( here, "No checkpoint found in %s.", fOutFileName.Data() );
+    delete file;
+    return -16;
+  }
+  cout << "Resuming analysis from " << fOutFileName << endl;
+  if( fVerbose > 0 )
+    ckpt->Print();
+
+  fFile = file;
+  delete fResumeFrom;
+  fResumeFrom = ckpt;
+  Int_t status = Process( run );
+  delete fResumeFrom; fResumeFrom = nullptr;
+  return status;
+}
+
 //_____________________________________________________________________________
 void THaAnalyzer::SetCodaVersion( Int_t vers )
 {
@@ -1650,6 +2523,22 @@ void THaAnalyzer::SetCodaVersion( Int_t vers )
   fWantCodaVers = vers;
 }
 
+//_____________________________________________________________________________
+void THaAnalyzer::RequireDecode( const char* name )
+{
+  // Always decode the detector or apparatus with the given prefix name
+  // (e.g. "R.vdc" or "R") when decoding on demand is enabled. Use this for
+  // detectors that other modules access directly rather than through
+  // global variables.
+
+  if( !name || !*name )
+    return;
+  if( find(ALL(fRequiredDecode), TString(name)) == fRequiredDecode.end() )
+    fRequiredDecode.emplace_back(name);
+  if( fIsInit )
+    InitDecodeOnDemand();
+}
+
 //_____________________________________________________________________________
 void THaAnalyzer::PrepareModuleList()
 {
@@ -10,6 +10,7 @@
 #include "TObject.h"
 #include "TString.h"
 #include <vector>
+#include <ctime>
 
 class THaEvent;
 class THaRunBase;
@@ -20,6 +21,8 @@ class TFile;
 class TDatime;
 class THaCut;
 class THaBenchmark;
+class THaTimelineTrace;
+class THaPerfCounters;
 class THaEvData;
 class THaPostProcess;
 class THaCrateMap;
@@ -31,6 +34,9 @@ class THaPhysicsModule;
 class THaAnalysisObject;
 namespace Podd {
   class InterStageModule;
+  class PreFilter;
+  class Checkpoint;
+  class ModuleProfiler;
 }
 
 class THaAnalyzer : public TObject {
@@ -47,8 +53,16 @@ public:
   virtual Int_t  Process( THaRunBase* run=nullptr );
           Int_t  Process( THaRunBase& run ) { return Process(&run); }
   virtual void   Print( Option_t* opt="" ) const;
+  virtual Int_t  Resume( THaRunBase* run );
+          Int_t  Resume( THaRunBase& run )  { return Resume(&run); }
+  virtual Int_t  SetPreFilter( Podd::PreFilter* filter );
 
   void           EnableBenchmarks( Bool_t b = true );
+  void           EnableDecodeOnDemand( Bool_t b = true );
+  void           EnableModuleProfiling( Bool_t b = true );
+  void           EnablePerfCounters( Bool_t b = true );
+  void           EnableTimelineTrace( const char* filename, UInt_t every = 100,
+                                      UInt_t max_events = 1000 );
   void           EnableHelicity( Bool_t b = true );
   void           EnableOtherEvents( Bool_t b = true );
   void           EnableOverwrite( Bool_t b = true );
@@ -59,6 +73,7 @@ public:
   const char*    GetCutFileName()      const  { return fCutFileName.Data(); }
   const char*    GetOdefFileName()     const  { return fOdefFileName.Data(); }
   const char*    GetSummaryFileName()  const  { return fSummaryFileName.Data(); }
+  const char*    GetBenchmarkReportFileName() const { return fBenchReportFileName.Data(); }
   TFile*         GetOutFile()          const  { return fFile; }
   Int_t          GetCompressionLevel() const  { return fCompress; }
   THaEvent*      GetEvent()            const  { return fEvent; }
@@ -73,22 +88,30 @@ public:
                  GetEvtHandlers()      const  { return fEvtHandlers; }
   const std::vector<THaPostProcess*>&
                  GetPostProcess()      const  { return fPostProcess; }
+  Podd::PreFilter* GetPreFilter()      const  { return fPreFilter; }
+  Bool_t         DecodeOnDemandEnabled() const { return fDecodeOnDemand; }
   Bool_t         HasStarted()          const  { return fAnalysisStarted; }
   Bool_t         HelicityEnabled()     const  { return fDoHelicity; }
   Bool_t         PhysicsEnabled()      const  { return fDoPhysics; }
   Bool_t         OtherEventsEnabled()  const  { return fDoOtherEvents; }
   Bool_t         SlowControlEnabled()  const  { return fDoSlowControl; }
   virtual Int_t  SetCountMode( Int_t mode );
+  // Write a checkpoint every 'nevents' events read and/or 'minutes' minutes
+  void           SetCheckpointInterval( UInt_t nevents, UInt_t minutes = 0 );
   void           SetCrateMapFileName( const char* name );
   void           SetEvent( THaEvent* event )        { fEvent = event; }
   void           SetOutFile( const char* name )     { fOutFileName = name; }
   void           SetCutFile( const char* name )     { fCutFileName = name; }
   void           SetOdefFile( const char* name )    { fOdefFileName = name; }
   void           SetSummaryFile( const char* name ) { fSummaryFileName = name; }
+  // Write benchmark results in JSON format to this file (needs benchmarks)
+  void           SetBenchmarkReport( const char* name ) { fBenchReportFileName = name; }
   void           SetCompressionLevel( Int_t level ) { fCompress = level; }
   void           SetMarkInterval( UInt_t interval ) { fMarkInterval = interval; }
   void           SetVerbosity( Int_t level )        { fVerbose = level; }
   void           SetCodaVersion(Int_t vers);
+  // Always decode the named detector or apparatus ("R.vdc", "R")
+  void           RequireDecode( const char* name );
 
   // Set the EPICS event type
   void           SetEpicsEvtType(Int_t itype);
@@ -126,8 +149,9 @@ protected:
   enum {
     kNevRead = 0, kNevGood, kNevPhysics, kNevEpics, kNevOther,
     kNevPostProcess, kNevAnalyzed, kNevAccepted,
-    kDecodeErr, kCodaErr, kRawDecodeTest, kDecodeTest, kCoarseTrackTest,
-    kCoarseReconTest, kTrackTest, kReconstructTest, kPhysicsTest
+    kDecodeErr, kCodaErr, kPreFilterTest, kRawDecodeTest, kDecodeTest,
+    kCoarseTrackTest, kCoarseReconTest, kTrackTest, kReconstructTest,
+    kPhysicsTest
   };
   class Counter_t {
   public:
@@ -146,6 +170,7 @@ protected:
   TString        fLoadedCutFileName;//Name of last loaded cut definition file
   TString        fOdefFileName;    //Name of output definition file
   TString        fSummaryFileName; //Name of test/cut statistics output file
+  TString        fBenchReportFileName; //Name of JSON benchmark report file
   THaEvent*      fEvent;           //The event structure to be written to file.
   Int_t          fWantCodaVers;    //Version of CODA assumed for file
   std::vector<Stage_t>   fStages;  //Parameters for analysis stages
@@ -168,6 +193,10 @@ protected:
   std::vector<Podd::InterStageModule*> fInterStage;      // Inter-stage modules
   std::vector<THaEvtTypeHandler*>      fEvtHandlers;     // Event type handlers
   std::vector<THaPostProcess*>         fPostProcess;     // Post-processing mods
+  Podd::PreFilter*                     fPreFilter;       // Raw-level filter
+  // Event type handlers interested in each CODA event type
+  // (0-Decoder::MAX_EVTYPE). Set up by InitEvtTypeDispatch().
+  std::vector<std::vector<THaEvtTypeHandler*>> fEvtTypeDispatch;
   // Combined list of fApps, fInterStage and fPhysics for PhysicsAnalysis.
   // Does not include fPostProcess and fEvtHandlers.
   std::vector<THaAnalysisObject*>      fAnalysisModules; // Analysis modules
@@ -183,12 +212,31 @@ protected:
   Bool_t         fDoPhysics;       // Enable physics event processing
   Bool_t         fDoOtherEvents;   // Enable other event processing
   Bool_t         fDoSlowControl;   // Enable slow control processing
+  Bool_t         fDecodeOnDemand;  // Decode only detectors whose data are used
+  std::vector<TString> fRequiredDecode; // Always decode these (RequireDecode)
 
   // Variables used by analysis functions
   Bool_t         fFirstPhysics;    // Status flag for physics analysis
+  Bool_t         fPreFilterSkip;   // Current event rejected by fPreFilter
+
+  // Checkpointing
+  UInt_t         fCkptEvents;      // Checkpoint interval in events read (0=off)
+  UInt_t         fCkptMinutes;     // Checkpoint interval in minutes (0=off)
+  UInt_t         fCkptLastCount;   // Events read at last checkpoint
+  time_t         fCkptLastTime;    // Time of last checkpoint
+  ULong64_t      fNbuf;            // Input buffers read during current replay
+  Podd::Checkpoint* fResumeFrom;   // Checkpoint to resume from (Resume())
+
+  // Per-module timing (EnableModuleProfiling)
+  Podd::ModuleProfiler* fProfiler; // Module latency histograms
+  Int_t          fProfOutputSlot;  // Profiler index of output pseudo-module
+  THaTimelineTrace* fTrace;        // Timeline of sampled events
+  TString        fTraceFileName;   // Output file for fTrace
+  THaPerfCounters* fPerf;          // Hardware counters (EnablePerfCounters)
 
   // Main analysis functions
   virtual Int_t  BeginAnalysis();
+  virtual Bool_t CheckpointDue() const;
   virtual Int_t  DoInit( THaRunBase* run );
   virtual Int_t  EndAnalysis();
   virtual Int_t  MainAnalysis();
@@ -196,7 +244,10 @@ protected:
   virtual Int_t  SlowControlAnalysis( Int_t code );
   virtual Int_t  OtherAnalysis( Int_t code );
   virtual Int_t  PostProcess( Int_t code );
+  virtual Bool_t PreFilterEvent();
+  virtual Int_t  ReadCheckpoint();
   virtual Int_t  ReadOneEvent();
+  virtual Int_t  WriteCheckpoint();
 
   // Support methods & data
   void           ClearCounters();
@@ -205,6 +256,8 @@ protected:
   virtual bool   EvalStage( int n );
   virtual void   InitCounters();
   virtual void   InitCuts();
+  virtual void   InitDecodeOnDemand();
+  virtual void   InitEvtTypeDispatch();
   virtual void   InitStages();
   virtual Int_t  InitModules( const std::vector<THaAnalysisObject*>& module_list,
                               TDatime& run_time );
@@ -218,6 +271,7 @@ protected:
   virtual void   PrintCutSummary() const;
   virtual void   PrintTimingSummary() const;
   virtual void   PrintSummary( EExitStatus exit_status ) const;
+  virtual void   WriteBenchmarkReport( EExitStatus exit_status ) const;
 
   static THaAnalyzer* fgAnalyzer;  //Pointer to instance of this class
 
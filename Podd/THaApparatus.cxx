@@ -8,12 +8,18 @@
 // Defines a standard Decode() method that loops over all detectors 
 // defined for this object.
 //
+// The analyzer may restrict decoding to the detectors whose results are
+// actually used (see THaAnalyzer::EnableDecodeOnDemand). In that case,
+// Decode() handles only the detectors needed for the Decode-stage tests,
+// and DecodeDeferred(), called once those tests have passed, the rest.
+//
 // A Reconstruct() method has to be implemented by the derived classes.
 //
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaApparatus.h"
 #include "THaDetector.h"
+#include "ModuleProfiler.h"
 #include "TClass.h"
 #include "TList.h"
 
@@ -23,18 +29,20 @@
 #endif
 
 using namespace std;
+using Podd::ModuleProfiler;
 
 //_____________________________________________________________________________
 THaApparatus::THaApparatus( const char* name, const char* description ) : 
   THaAnalysisObject(name,description),
-  fDetectors{new TList}
+  fDetectors{new TList},
+  fSelectiveDecode{false}
 {
   // Constructor
   
 }
 
 //_____________________________________________________________________________
-THaApparatus::THaApparatus( ) : fDetectors(nullptr)
+THaApparatus::THaApparatus( ) : fDetectors(nullptr), fSelectiveDecode(false)
 {
   // only for ROOT I/O
 }
@@ -120,25 +128,69 @@ void THaApparatus::Clear( Option_t* opt )
 #endif
     }
   }
+  THaAnalysisObject::Clear(opt);
 }
 
 //_____________________________________________________________________________
-Int_t THaApparatus::Decode( const THaEvData& evdata )
+void THaApparatus::ClearDecodeLists()
 {
-  // Call the Decode() method for all detectors defined for this apparatus.
+  // Return to decoding all detectors in Decode()
+
+  fDecodeNow.clear();
+  fDecodeLater.clear();
+  fSelectiveDecode = false;
+}
 
+//_____________________________________________________________________________
+Int_t THaApparatus::Decode( const THaEvData& evdata )
+{
+  // Call the Decode() method for all detectors defined for this apparatus,
+  // or, if selective decoding is enabled, for the detectors set up to be
+  // decoded immediately.
+
+  if( fSelectiveDecode ) {
+    for( auto* theDetector : fDecodeNow )
+      DecodeDetector( theDetector, evdata );
+    return 0;
+  }
   TIter next(fDetectors);
-  while( auto* theDetector = static_cast<THaDetector*>( next() )) {
+  while( auto* theDetector = static_cast<THaDetector*>( next() ))
+    DecodeDetector( theDetector, evdata );
+
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaApparatus::DecodeDeferred( const THaEvData& evdata )
+{
+  // Decode the detectors whose decoding was deferred until after the
+  // Decode-stage tests. Does nothing unless selective decoding is enabled.
+
+  for( auto* theDetector : fDecodeLater )
+    DecodeDetector( theDetector, evdata );
+
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaApparatus::DecodeDetector( THaDetector* theDetector,
+                                    const THaEvData& evdata )
+{
+  // Decode a single detector
+
 #ifdef WITH_DEBUG
-    if( fDebug>1 ) cout << "Decoding " << theDetector->GetName()
-                        << "... " << flush;
+  if( fDebug>1 ) cout << "Decoding " << theDetector->GetName()
+                      << "... " << flush;
 #endif
-    theDetector->Decode( evdata );
+  Int_t ret;
+  {
+    ModuleProfiler::Span span(theDetector, ModuleProfiler::kDecode);
+    ret = theDetector->Decode( evdata );
+  }
 #ifdef WITH_DEBUG
-    if( fDebug>1 ) cout << "done.\n" << flush;
+  if( fDebug>1 ) cout << "done.\n" << flush;
 #endif
-  }
-  return 0;
+  return ret;
 }
 
 //_____________________________________________________________________________
@@ -153,6 +205,32 @@ Int_t THaApparatus::End( THaRunBase* run )
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaApparatus::ReadCheckpoint( TDirectory* dir )
+{
+  // Restore checkpoint state of all our detectors
+
+  TIter next(fDetectors);
+  while( auto* obj = static_cast<THaAnalysisObject*>(next()) ) {
+    if( Int_t ret = obj->ReadCheckpoint(dir) )
+      return ret;
+  }
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaApparatus::WriteCheckpoint( TDirectory* dir )
+{
+  // Save checkpoint state of all our detectors
+
+  TIter next(fDetectors);
+  while( auto* obj = static_cast<THaAnalysisObject*>(next()) ) {
+    if( Int_t ret = obj->WriteCheckpoint(dir) )
+      return ret;
+  }
+  return 0;
+}
+
 //_____________________________________________________________________________
 THaDetector* THaApparatus::GetDetector( const char* name )
 {
@@ -230,6 +308,18 @@ void THaApparatus::Print( Option_t* opt ) const
     fDetectors->Print(opt);
 }
 
+//_____________________________________________________________________________
+void THaApparatus::SetDecodeLists( const vector<THaDetector*>& now,
+                                   const vector<THaDetector*>& later )
+{
+  // Decode only the detectors in 'now' in Decode() and those in 'later' in
+  // DecodeDeferred(). Detectors in neither list are not decoded.
+
+  fDecodeNow = now;
+  fDecodeLater = later;
+  fSelectiveDecode = true;
+}
+
 //_____________________________________________________________________________
 void THaApparatus::SetDebugAll( Int_t level )
 {
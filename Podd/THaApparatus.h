@@ -8,6 +8,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaAnalysisObject.h"
+#include <vector>
 
 class THaDetector;
 class THaEvData;
@@ -23,6 +24,7 @@ public:
   virtual Int_t        Begin( THaRunBase* r=nullptr );
   virtual void         Clear( Option_t* opt="" );
   virtual Int_t        Decode( const THaEvData& );
+  virtual Int_t        DecodeDeferred( const THaEvData& );
   virtual Int_t        End( THaRunBase* r=nullptr );
           Int_t        GetNumDets() const;
   virtual THaDetector* GetDetector( const char* name );
@@ -30,12 +32,26 @@ public:
 
   virtual EStatus      Init( const TDatime& run_time );
   virtual void         Print( Option_t* opt="" ) const;
+  virtual Int_t        ReadCheckpoint( TDirectory* dir );
+  virtual Int_t        WriteCheckpoint( TDirectory* dir );
   virtual Int_t        CoarseReconstruct() { return 0; }
   virtual Int_t        Reconstruct() = 0;
   virtual void         SetDebugAll( Int_t level );
 
+  // Selective decoding. Decode() handles only the detectors in 'now',
+  // DecodeDeferred() those in 'later'. Others are not decoded at all.
+          void         SetDecodeLists( const std::vector<THaDetector*>& now,
+                                       const std::vector<THaDetector*>& later );
+          void         ClearDecodeLists();
+          Bool_t       IsSelectiveDecode() const { return fSelectiveDecode; }
+
 protected:
   TList*         fDetectors;    // List of all detectors for this apparatus
+  std::vector<THaDetector*> fDecodeNow;   //! Detectors decoded by Decode()
+  std::vector<THaDetector*> fDecodeLater; //! Detectors decoded by DecodeDeferred()
+  Bool_t         fSelectiveDecode;        //! Use the above lists
+
+  Int_t          DecodeDetector( THaDetector* det, const THaEvData& evdata );
 
   THaApparatus( const char* name, const char* description );
   THaApparatus( );
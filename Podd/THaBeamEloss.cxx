@@ -48,15 +48,7 @@ void THaBeamEloss::CalcEloss( THaBeamInfo* beamifo )
   //
   // May be overridden by derived classes as necessary.
 
-  Double_t p0 = beamifo->GetP();
-  Double_t beta = p0 / TMath::Sqrt(p0*p0 + fM*fM);
-  if( fElectronMode ) {
-    fEloss = ElossElectron( beta, fZmed, fAmed, 
-			    fDensity, fPathlength );
-  } else {
-    fEloss = ElossHadron( fZ, beta, fZmed, fAmed, 
-			  fDensity, fPathlength );
-  }
+  fEloss = ElossForMomentum( beamifo->GetP() );
 }
 
 //_____________________________________________________________________________
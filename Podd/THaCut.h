@@ -41,6 +41,9 @@ public:
   virtual void         SetBlockname( const Text_t* name );
   virtual void         SetName( const Text_t* name );
   virtual void         SetNameTitle( const Text_t* name, const Text_t* title );
+  // Restore statistics, e.g. when resuming an analysis from a checkpoint
+          void         SetStatistics( UInt_t ncalled, UInt_t npassed )
+                         { fNCalled = ncalled; fNPassed = npassed; }
 
 protected:
   Bool_t      fLastResult;  // Result of last evaluation of this formula
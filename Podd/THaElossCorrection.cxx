@@ -4,6 +4,18 @@
 //
 // THaElossCorrection
 //
+// Base class for energy loss corrections.
+//
+// Since the medium and particle mass are fixed for a run, Init() tabulates
+// the energy loss per unit pathlength as a function of ln(beta*gamma)
+// over the range kBGmin < beta*gamma < kBGmax. Per-event corrections are
+// then obtained by linear interpolation in this table. The table is
+// refined until the relative interpolation error, checked at the midpoints
+// of all intervals, is below kTableTol (1e-4), which is far smaller than
+// the uncertainty of the stopping power formulas themselves. Outside of the
+// table range, the exact calculation is used. SetUseTable(false) disables
+// the table and always uses the exact calculation, e.g. for validation.
+//
 //////////////////////////////////////////////////////////////////////////
 
 #include "THaElossCorrection.h"
@@ -17,6 +29,13 @@
 // Default tolerance for floating-point equality comparisons of z_med
 static const Double_t eps = 0.1;
 
+// Energy loss table parameters
+static const Double_t kBGmin     = 0.2;    // Lower limit of beta*gamma
+static const Double_t kBGmax     = 1e5;    // Upper limit of beta*gamma
+static const Double_t kTableTol  = 1e-4;   // Max relative interpolation error
+static const UInt_t   kTableNmin = 512;    // Initial number of intervals
+static const UInt_t   kTableNmax = 65536;  // Max number of intervals
+
 using namespace std;
 
 //_____________________________________________________________________________
@@ -29,7 +48,8 @@ THaElossCorrection::THaElossCorrection( const char* name,
   fZ(hadron_charge), fZmed(0.0), fAmed(0.0), fDensity(0.0), fPathlength(0.0),
   fZref(0.0), fScale(0.0),
   fTestMode(false), fElectronMode(false), fExtPathMode(false),
-  fInputName(input_tracks), fVertexModule(nullptr)
+  fInputName(input_tracks), fVertexModule(nullptr), fUseTable(true),
+  fTableXmin(0.0), fTableXmax(0.0), fTableInvStep(0.0), fTableMaxErr(0.0)
 {
   // Normal constructor.
 
@@ -70,9 +90,103 @@ THaAnalysisObject::EStatus THaElossCorrection::Init( const TDatime& run_time )
   // Continue with standard initialization
   THaPhysicsModule::Init( run_time );
 
+  fTable.clear();
+  if( fStatus == kOK && fUseTable && !fTestMode )
+    BuildTable();
+
   return fStatus;
 }
 
+//_____________________________________________________________________________
+Double_t THaElossCorrection::ExactEloss( Double_t p, Double_t pathlength ) const
+{
+  // Energy loss (GeV) of the particle with momentum p (GeV/c) over the
+  // given pathlength (m), calculated from the full formulas
+
+  Double_t beta = p / TMath::Sqrt(p*p + fM*fM);
+  if( fElectronMode )
+    return ElossElectron( beta, fZmed, fAmed, fDensity, pathlength );
+  else
+    return ElossHadron( fZ, beta, fZmed, fAmed, fDensity, pathlength );
+}
+
+//_____________________________________________________________________________
+Double_t THaElossCorrection::ElossForMomentum( Double_t p ) const
+{
+  // Energy loss (GeV) of the particle with momentum p (GeV/c) over the
+  // current pathlength. Uses the lookup table if available.
+
+  if( !fTable.empty() && p > 0.0 ) {
+    Double_t x = TMath::Log(p/fM);
+    if( x >= fTableXmin && x < fTableXmax ) {
+      Double_t u = (x - fTableXmin) * fTableInvStep;
+      auto i = static_cast<size_t>(u);
+      if( i+1 < fTable.size() ) {
+        Double_t f = u - static_cast<Double_t>(i);
+        return ( fTable[i] + f*(fTable[i+1]-fTable[i]) ) * fPathlength;
+      }
+    }
+  }
+  return ExactEloss( p, fPathlength );
+}
+
+//_____________________________________________________________________________
+Int_t THaElossCorrection::BuildTable()
+{
+  // Tabulate the energy loss per meter of medium vs. ln(beta*gamma).
+  // The number of points is doubled until the interpolation error at the
+  // interval midpoints is below kTableTol. Returns 0 if the table is
+  // usable, otherwise 1 (and the exact calculation is used).
+
+  static const char* const here = "BuildTable";
+
+  fTable.clear();
+  fTableMaxErr = 0.0;
+  if( fM <= 0.0 || fZmed == 0.0 || fAmed == 0.0 )
+    return 1;
+  // Unknown media have zero energy loss. Check once here rather than
+  // printing the warnings of ExEnerg/HaDensi for every table point.
+  if( ExEnerg(fZmed,fDensity) == 0.0 )
+    return 1;
+  if( !fElectronMode ) {
+    Double_t X0 = 0, X1 = 0, M = 0;
+    HaDensi(fZmed,fDensity,X0,X1,M);
+    if( X0+X1+M == 0.0 )
+      return 1;
+  }
+
+  Double_t xmin = TMath::Log(kBGmin), xmax = TMath::Log(kBGmax);
+  vector<Double_t> table;
+  Double_t maxerr = 0.0;
+  for( UInt_t n = kTableNmin; n <= kTableNmax; n *= 2 ) {
+    Double_t step = (xmax-xmin)/n;
+    table.resize(n+1);
+    for( UInt_t i = 0; i <= n; ++i )
+      table[i] = ExactEloss( fM*TMath::Exp(xmin + i*step), 1.0 );
+    maxerr = 0.0;
+    for( UInt_t i = 0; i < n; ++i ) {
+      Double_t exact = ExactEloss( fM*TMath::Exp(xmin + (i+0.5)*step), 1.0 );
+      Double_t interp = 0.5*(table[i]+table[i+1]);
+      Double_t scale = TMath::Max( TMath::Abs(exact), 1e-12 );
+      maxerr = TMath::Max( maxerr, TMath::Abs(interp-exact)/scale );
+    }
+    if( maxerr < kTableTol ) {
+      fTable.swap(table);
+      fTableXmin = xmin;
+      fTableXmax = xmax;
+      fTableInvStep = 1.0/step;
+      fTableMaxErr = maxerr;
+      if( fDebug > 0 )
+        Info( Here(here), "Energy loss table with %u points, "
+              "max. relative error %.2g", n+1, maxerr );
+      return 0;
+    }
+  }
+  Warning( Here(here), "Cannot tabulate energy loss to required precision "
+           "(error %.2g). Using exact calculation.", maxerr );
+  return 1;
+}
+
 //_____________________________________________________________________________
 Int_t THaElossCorrection::DefineVariables( EMode mode )
 {
@@ -171,6 +285,18 @@ void THaElossCorrection::SetTestMode( Bool_t enable, Double_t eloss_value )
     PrintInitError("SetTestMode");
 }
 
+//_____________________________________________________________________________
+void THaElossCorrection::SetUseTable( Bool_t enable )
+{
+  // Enable/disable the use of a lookup table for the energy loss
+  // calculation. If disabled, the full calculation is done for every event.
+
+  if( !IsInit() )
+    fUseTable = enable;
+  else
+    PrintInitError("SetUseTable");
+}
+
 //_____________________________________________________________________________
 void THaElossCorrection::SetMedium( Double_t Z, Double_t A,
 				    Double_t density ) 
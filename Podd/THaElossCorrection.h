@@ -9,6 +9,7 @@
 
 #include "THaPhysicsModule.h"
 #include "TString.h"
+#include <vector>
 
 class THaVertexModule;
 
@@ -22,11 +23,14 @@ public:
 
   Double_t          GetMass()       const { return fM; }
   Double_t          GetEloss()      const { return fEloss; }
+  Bool_t            IsTableMode()   const { return !fTable.empty(); }
+  Double_t          GetTableError() const { return fTableMaxErr; }
 
           void      SetInputModule( const char* name );
           void      SetMass( Double_t m /* GeV/c^2 */ );
           void      SetTestMode( Bool_t enable=true,
 				 Double_t eloss_value=0.0 /* GeV */ );
+          void      SetUseTable( Bool_t enable=true );
           void      SetMedium( Double_t Z, Double_t A,
 			       Double_t density  /* g/cm^3 */ );
           void      SetPathlength( Double_t pathlength /* m */ );
@@ -65,6 +69,19 @@ protected:
   TString            fVertexName;  // Name of vertex module for var pathlength, if any
   THaVertexModule*   fVertexModule;// Pointer to vertex module
 
+  // Lookup table of energy loss per unit pathlength vs. ln(beta*gamma)
+  Bool_t             fUseTable;    // If true, use lookup table when possible
+  std::vector<Double_t> fTable;    // Energy loss per m of medium (GeV/m)
+  Double_t           fTableXmin;   // ln(beta*gamma) of first table point
+  Double_t           fTableXmax;   // ln(beta*gamma) of last table point
+  Double_t           fTableInvStep;// 1/(table step in ln(beta*gamma))
+  Double_t           fTableMaxErr; // Max relative interpolation error found
+
+  // Energy loss for momentum p (GeV/c) over the current pathlength
+  Double_t      ElossForMomentum( Double_t p ) const;
+  Double_t      ExactEloss( Double_t p, Double_t pathlength ) const;
+  Int_t         BuildTable();
+
   // Setup functions
   virtual Int_t DefineVariables( EMode mode = kDefine );
   virtual Int_t ReadRunDatabase( const TDatime& date );
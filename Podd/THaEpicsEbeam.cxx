@@ -12,6 +12,8 @@
 #include "THaEpicsEbeam.h"
 #include "VarDef.h"
 #include "THaEvData.h"
+#include "THaAnalyzer.h"
+#include "THaEpicsEvtHandler.h"
 #include "TMath.h"
 
 //_____________________________________________________________________________
@@ -20,7 +22,8 @@ THaEpicsEbeam::THaEpicsEbeam( const char* name, const char* description,
 			      Double_t scale_factor ) : 
   THaPhysicsModule( name,description ), fEcorr(0.0), fEpicsIsMomentum(false),
   fScaleFactor(scale_factor), fBeamName(beam), fEpicsVar(epics_var), 
-  fBeamModule(nullptr)
+  fBeamModule(nullptr), fEpicsHandler(nullptr),
+  fEpicsHandle(Decoder::THaEpics::kNoHandle)
 {
   // Constructor.
 }
@@ -54,6 +57,13 @@ THaAnalysisObject::EStatus THaEpicsEbeam::Init( const TDatime& run_time )
   if( !fBeamModule )
     return fStatus;
 
+  // Resolve the EPICS variable once. The handle stays valid even if no
+  // data for this variable have been read yet.
+  THaAnalyzer* analyzer = THaAnalyzer::GetInstance();
+  fEpicsHandler = analyzer ? analyzer->GetEpicsEvtHandler() : nullptr;
+  if( fEpicsHandler )
+    fEpicsHandle = fEpicsHandler->GetHandle(fEpicsVar.Data());
+
   //this is done by THaBeamInfo::operator= in Process
   //  fBeamIfo.SetBeam( fBeamModule->GetBeamInfo()->GetBeam() );
 
@@ -88,8 +98,16 @@ Int_t THaEpicsEbeam::Process( const THaEvData& evdata )
 
   // Obtain current beam energy (or momentum) from EPICS
   // If requested EPICS variable not loaded, do nothing
-  if( evdata.IsLoadedEpics(fEpicsVar) ) {
-    Double_t e = evdata.GetEpicsData(fEpicsVar);
+  Bool_t loaded = false;
+  Double_t e = 0;
+  if( fEpicsHandler && fEpicsHandler->IsLoaded(fEpicsHandle) ) {
+    e = fEpicsHandler->GetData(fEpicsHandle);
+    loaded = true;
+  } else if( evdata.IsLoadedEpics(fEpicsVar) ) {
+    e = evdata.GetEpicsData(fEpicsVar);
+    loaded = true;
+  }
+  if( loaded ) {
     // the scale factor must convert the EPICS value to GeV
     e *= fScaleFactor;
     Double_t m = fBeamIfo.GetM();
@@ -33,6 +33,17 @@ public:
    time_t GetTime( const char* tag, UInt_t event = 0 ) const;
    TString GetString( const char* tag, UInt_t event = 0 ) const;
 
+   // Handle-based access. Obtain handles once, e.g. at Init
+   typedef Decoder::THaEpics::Handle_t Handle_t;
+   Handle_t GetHandle( const char* tag ) { return fEpics->GetHandle(tag); }
+   Bool_t IsLoaded( Handle_t h ) const { return fEpics->IsLoaded(h); }
+   Double_t GetData( Handle_t h, UInt_t event = 0 ) const
+   { return fEpics->GetData(h, event); }
+   time_t GetTime( Handle_t h, UInt_t event = 0 ) const
+   { return fEpics->GetTimeStamp(h, event); }
+   const char* GetString( Handle_t h, UInt_t event = 0 ) const
+   { return fEpics->GetCString(h, event); }
+
 private:
 
    std::unique_ptr<Decoder::THaEpics> fEpics;
@@ -765,6 +765,32 @@ Int_t THaFormula::GetNdata() const
   return GetNdataUnchecked();
 }
 
+//_____________________________________________________________________________
+void THaFormula::GetVarNames( vector<string>& names ) const
+{
+  // Append the names of all global variables that this formula depends on
+  // to 'names'. Variables used by referenced cuts and by the arguments of
+  // special functions are included. 'names' may contain duplicates.
+
+  for( const auto& def : fVarDef ) {
+    switch( def.type ) {
+    case kVariable:
+    case kString:
+    case kArray:
+      names.emplace_back( static_cast<const THaVar*>(def.obj)->GetName() );
+      break;
+    case kCut:
+    case kFormula:
+    case kVarFormula:
+      if( def.obj )
+        static_cast<const THaFormula*>(def.obj)->GetVarNames(names);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
 //_____________________________________________________________________________
 void THaFormula::Print( Option_t* option ) const
 {
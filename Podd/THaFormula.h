@@ -11,6 +11,7 @@
 #include "v5/TFormula.h"
 #include "THaGlobals.h"
 #include <vector>
+#include <string>
 #include <iostream>
 
 class THaVarList;
@@ -48,6 +49,8 @@ public:
   { return const_cast<THaFormula*>(this)->Eval(); }
   virtual Double_t    EvalInstance( Int_t instance );
   virtual Int_t       GetNdata()   const;
+  // Append names of global variables used, including via cuts & functions
+  virtual void        GetVarNames( std::vector<std::string>& names ) const;
   virtual Bool_t      IsArray()    const { return TestBit(kArrayFormula); }
   virtual Bool_t      IsVarArray() const { return TestBit(kVarArray); }
           Bool_t      IsError()    const { return TestBit(kError); }
@@ -32,6 +32,7 @@
 #include "THaEpicsEvtHandler.h"
 #include "THaString.h"
 #include "FileInclude.h"
+#include "Checkpoint.h"
 
 #include <algorithm>
 #include <fstream>
@@ -42,6 +43,7 @@
 #include <vector>
 
 #include "THaBenchmark.h"
+#include "THaTimelineTrace.h"
 
 using namespace std;
 using namespace THaString;
@@ -59,7 +61,8 @@ class THaEpicsKey {
 // Utility class used by THaOutput to store a list of
 // 'keys' to access EPICS data 'string=num' assignments
 public:
-  explicit THaEpicsKey(string nm) : fName(std::move(nm))
+  explicit THaEpicsKey(string nm)
+    : fName(std::move(nm)), fHandle(Decoder::THaEpics::kNoHandle)
      { fAssign.clear(); }
   void AddAssign(const string& input) {
 // Add optional assignments.  The input must
@@ -99,7 +102,7 @@ public:
     return result;
   };
   Bool_t IsString() { return !fAssign.empty(); };
-  Double_t Eval(const string& input) {
+  Double_t Eval(const char* input) {
     if (fAssign.empty()) return 0;
     for( const auto& pm : fAssign ) {
       if (input == pm.first) {
@@ -109,11 +112,14 @@ public:
     return 0;
   };
   Double_t Eval(const TString& input) {
-    return Eval(string(input.Data()));
+    return Eval(input.Data());
   }
   const string& GetName() { return fName; };
+  Decoder::THaEpics::Handle_t GetHandle() const { return fHandle; }
+  void SetHandle( Decoder::THaEpics::Handle_t h ) { fHandle = h; }
 private:
   string fName;
+  Decoder::THaEpics::Handle_t fHandle; // Handle in current EPICS handler
   map<string,Double_t> fAssign;
 };
 
@@ -233,6 +239,7 @@ Int_t THaOutput::Init( const char* filename )
   fTree->SetAutoSave(200000000);
   fOpenEpics  = false;
   fFirstEpics = true;
+  fEpicsHandler = nullptr;  // EPICS keys must be looked up again
 
   Int_t err = LoadFile( filename );
   if( fgDoBench && err != 0 ) fgBench.Stop("Init");
@@ -514,21 +521,24 @@ Int_t THaOutput::ProcEpics(THaEvData *evdata, THaEpicsEvtHandler *epicshandle)
   extras->fEpicsTimestamp = -1;
   extras->fEpicsEvtNum = evdata->GetEvNum(); // most recent physics event number
   auto siz = fEpicsKey.size();
+  // Look up the tags only once per handler. Handles remain valid
+  // even for tags whose data have not been seen yet.
+  if( epicshandle != fEpicsHandler ) {
+    for( auto* key : fEpicsKey )
+      key->SetHandle(epicshandle->GetHandle(key->GetName().c_str()));
+    fEpicsHandler = epicshandle;
+  }
   for( size_t i = 0; i < siz; ++i ) {
-    if (epicshandle->IsLoaded(fEpicsKey[i]->GetName().c_str())) {
-      //      cout << "EPICS name "<<fEpicsKey[i]->GetName()<<"    val "
-      //      << epicshandle->GetString(fEpicsKey[i]->GetName().c_str())<<endl;
+    auto h = fEpicsKey[i]->GetHandle();
+    if (epicshandle->IsLoaded(h)) {
       if (fEpicsKey[i]->IsString()) {
-        fEpicsVar[i] =
-          fEpicsKey[i]->Eval(
-            epicshandle->GetString(fEpicsKey[i]->GetName().c_str()));
+        fEpicsVar[i] = fEpicsKey[i]->Eval(epicshandle->GetString(h));
       } else {
-        fEpicsVar[i] = epicshandle->GetData(fEpicsKey[i]->GetName().c_str());
+        fEpicsVar[i] = epicshandle->GetData(h);
       }
  // fill time stamp (once is ok since this is an EPICS event)
  //FIXME: check for inconsistent time stamps?
-      extras->fEpicsTimestamp =
-        epicshandle->GetTime(fEpicsKey[i]->GetName().c_str());
+      extras->fEpicsTimestamp = epicshandle->GetTime(h);
     } else {
       fEpicsVar[i] = -1e32;  // data not yet found
     }
@@ -538,22 +548,45 @@ Int_t THaOutput::ProcEpics(THaEvData *evdata, THaEpicsEvtHandler *epicshandle)
   return 1;
 }
 
+//_____________________________________________________________________________
+void THaOutput::GetVarNames( vector<string>& names ) const
+{
+  // Append the names of all global variables that the output depends on
+  // to 'names': tree variables (including those used by formulas), and
+  // the variables used by output cuts and histograms. Call after Init().
+  // 'names' may contain duplicates.
+
+  names.insert(names.end(), fVNames.begin(), fVNames.end());
+  names.insert(names.end(), fArrayNames.begin(), fArrayNames.end());
+  for( const auto* pcut : fCuts ) {
+    for( const auto& str : pcut->GetVars() )
+      names.push_back(StripBracket(str));
+  }
+  for( const auto* pVhist : fHistos ) {
+    for( const auto& str : pVhist->GetVars() )
+      names.push_back(StripBracket(str));
+  }
+}
+
 //_____________________________________________________________________________
 Int_t THaOutput::Process()
 {
   // Process the variables, formulas, and histograms.
   // This is called by THaAnalyzer.
 
+  THaTimelineTrace::Span span("Formulas", "output");
   if( fgDoBench ) fgBench.Begin("Formulas");
   for (auto & form : fFormulas)
     if (form) form->Process();
   if( fgDoBench ) fgBench.Stop("Formulas");
 
+  span.Next("Cuts");
   if( fgDoBench ) fgBench.Begin("Cuts");
   for (auto & cut : fCuts)
     if (cut) cut->Process();
   if( fgDoBench ) fgBench.Stop("Cuts");
 
+  span.Next("Variables");
   if( fgDoBench ) fgBench.Begin("Variables");
   for (UInt_t ivar = 0; ivar < fNvar; ivar++) {
     const auto* pvar = fVariables[ivar];
@@ -588,14 +621,21 @@ Int_t THaOutput::Process()
   }
   if( fgDoBench ) fgBench.Stop("Variables");
 
+  span.Next("Histos");
   if( fgDoBench ) fgBench.Begin("Histos");
   for (auto & hist : fHistos)
     hist->Process();
   if( fgDoBench ) fgBench.Stop("Histos");
 
+  // Tree baskets are compressed and written within Fill(). In the trace,
+  // note the compressed bytes written, if any.
+  Long64_t zipbytes = (fTree && span.IsRecording()) ? fTree->GetZipBytes() : 0;
+  span.Next("TreeFill");
   if( fgDoBench ) fgBench.Begin("TreeFill");
   if (fTree) fTree->Fill();
   if( fgDoBench ) fgBench.Stop("TreeFill");
+  if( fTree && span.IsRecording() )
+    span.SetArg("zipbytes", fTree->GetZipBytes() - zipbytes);
 
   return 0;
 }
@@ -626,6 +666,49 @@ Int_t THaOutput::End()
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaOutput::WriteCheckpoint()
+{
+  // Save the trees and histograms to the output file so that the analysis
+  // can be resumed from this point with ReadCheckpoint(). The current
+  // directory must be the output file.
+
+  Podd::Checkpoint::SaveTree(fTree);
+  Podd::Checkpoint::SaveTree(fEpicsTree);
+  for (auto & hist : fHistos)
+    hist->WriteCheckpoint();
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaOutput::ReadCheckpoint( TDirectory* dir )
+{
+  // Continue filling the trees and histograms saved in 'dir' at the last
+  // checkpoint. Must be called after Init() and after all modules have
+  // added their branches to the tree, since the saved trees take over
+  // the branch addresses of the ones just created.
+
+  if (fTree) {
+    TTree* tree = Podd::Checkpoint::ResumeTree(fTree);
+    if (!tree) return -1;
+    fTree = tree;
+    for (auto & odat : fOdata)
+      odat->tree = fTree;
+    for (auto & form : fFormulas)
+      form->ResetOutput(fTree);
+    for (auto & cut : fCuts)
+      cut->ResetOutput(fTree);
+  }
+  if (fEpicsTree) {
+    TTree* tree = Podd::Checkpoint::ResumeTree(fEpicsTree);
+    if (!tree) return -1;
+    fEpicsTree = tree;
+  }
+  for (auto & hist : fHistos)
+    hist->ReadCheckpoint(dir);
+  return 0;
+}
+
 //_____________________________________________________________________________
 Int_t THaOutput::LoadFile( const char* filename )
 {
@@ -20,6 +20,7 @@ class THaVform;
 class THaVhist;
 class THaEvData;
 class TTree;
+class TDirectory;
 class THaEvtTypeHandler;
 
 class THaOdata {
@@ -78,8 +79,13 @@ public:
   virtual Int_t Process();
   virtual Int_t ProcEpics(THaEvData *ev, THaEpicsEvtHandler *han);
   virtual Int_t End();
+  // Save/restore trees and histograms at analysis checkpoints
+  virtual Int_t WriteCheckpoint();
+  virtual Int_t ReadCheckpoint( TDirectory* dir );
   virtual Bool_t TreeDefined() const { return fTree != nullptr; };
   virtual TTree* GetTree() const { return fTree; };
+  // Append names of all global variables used by the output
+  virtual void  GetVarNames( std::vector<std::string>& names ) const;
 
   static void SetVerbosity( Int_t level );
   
@@ -136,7 +142,7 @@ private:
 
   std::string stitle, sfvarx, sfvary, scut;
 
-  THaEvtTypeHandler *fEpicsHandler;
+  THaEvtTypeHandler *fEpicsHandler;  // Handler for which EPICS keys are resolved
 
   Int_t nx,ny,iscut;
   Float_t xlo,xhi,ylo,yhi;
@@ -105,43 +105,20 @@ Int_t THaReactionPoint::Process( const THaEvData& )
     beam_org = fBeam->GetPosition();
     beam_ray = fBeam->GetDirection();
   }
-  static const TVector3 yax( 0.0, 1.0, 0.0 );
-  TVector3 org, v; 
-
-  for( Int_t i = 0; i<ntracks; i++ ) {
-    auto* theTrack = static_cast<THaTrack*>( tracks->At(i) );
-    // Ignore junk tracks
-    if( !theTrack || !theTrack->HasTarget() ) 
-      continue;  
-    org.SetXYZ( 0.0, theTrack->GetTY(), 0.0 );
-    org *= fSpectro->GetToLabRot();
-    org += fSpectro->GetPointingOffset();
-    Double_t t = 0; // dummy
-    if( !IntersectPlaneWithRay( theTrack->GetPvect(), yax, org,
-				beam_org, beam_ray, t, v ))
-      continue; // Oops, track and beam parallel?
-    theTrack->SetVertex(v);
-
-    // FIXME: preliminary
-    if( theTrack == fSpectro->GetGoldenTrack() ) {
-      fVertex = theTrack->GetVertex();
-      fVertexOK = true;
-    }
-    // FIXME: calculate vertex coordinate errors here (need beam errors)
-
-
-    // The following is more efficient but less general
-    // and requires the tangents of the beam angles (TRANSPORT style)
-
-//      Double_t x0 = (fSpectro->GetPointingOffset()).X() + 
-//        (fSpectro->GetToLabRot()).XY() * theTrack->GetTY();
-//      Double_t z0 = (fSpectro->GetPointingOffset()).Z() + 
-//        (fSpectro->GetToLabRot()).ZY() * theTrack->GetTY();
-//      Double_t dx  = beam_x + beam_th*z0 - x0;
-//      Double_t dz  = dx /( theTrack->GetLabPx()/theTrack->GetLabPz() - beam_th );
-//      Double_t z   = z0 + dz;
-//      theTrack->SetVertex( beam_x+beam_th*z, beam_y+beam_ph*z, z );
+  // Vertices of all tracks in one pass
+  fTrackBuf.Load(*tracks);
+  fSpectro->TrackVertices(fTrackBuf, beam_org, beam_ray);
+  fTrackBuf.StoreVertex(*tracks);
+
+  // FIXME: preliminary
+  THaTrack* golden = fSpectro->GetGoldenTrack();
+  Int_t igold = golden ? tracks->IndexOf(golden) : -1;
+  if( igold >= 0 && fTrackBuf.ok[igold] ) {
+    fVertex = golden->GetVertex();
+    fVertexOK = true;
   }
+  // FIXME: calculate vertex coordinate errors here (need beam errors)
+
   return 0;
 }
   
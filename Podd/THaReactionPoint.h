@@ -9,6 +9,7 @@
 
 #include "THaPhysicsModule.h"
 #include "THaVertexModule.h"
+#include "TrackBuffer.h"
 #include "TString.h"
 
 class THaSpectrometer;
@@ -34,6 +35,7 @@ protected:
   TString                 fBeamName;     // Name of beam position apparatus
   THaSpectrometer*        fSpectro;      // Pointer to spectrometer object
   THaBeam*                fBeam;         // Pointer to beam position apparatus
+  Podd::TrackBuffer       fTrackBuf;     //! Track coordinates for batched vertexing
 
   virtual Int_t DefineVariables( EMode mode = kDefine );
 
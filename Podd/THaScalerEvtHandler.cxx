@@ -22,6 +22,32 @@
 //   To use in the analyzer, your setup script needs something like this
 //       gHaEvtHandlers->Add (new THaScalerEvtHandler("Left","HA scaler event type 140"));
 //
+//   Scaler events are decoded in a single pass over the event buffer.
+//   At Init, the header words of all scalers are put into a lookup
+//   table, so that each data word is matched with at most one
+//   comparison per distinct header mask, and the mapping of each
+//   variable to its scaler and channel is resolved once.
+//
+//   Optional database keywords:
+//      accumulate  <mode>     0 = fill the TS tree at every scaler event
+//                                 (default)
+//                             1 = only accumulate counts and times for
+//                                 the whole run; no per-event tree fill
+//                             2 = both
+//      helicity  <var> <var+> <var->
+//                             <var+> and <var-> count the same signal
+//                             as <var>, but gated by the + and -
+//                             helicity windows (helicity-gated scaler
+//                             inputs). Accumulated sums are then also
+//                             kept per helicity window. The window times
+//                             come from the gated copies of the clock of
+//                             the normalization scaler, which therefore
+//                             needs its own "helicity" line.
+//   Accumulated sums are printed and written to tree "TS<fName>sum"
+//   at End(), one entry per window (0 = all, -1 = minus, +1 = plus).
+//   Count variables hold the summed counts, rate variables the mean rate.
+//   In the -/+ entries, variables without gated copies are zero.
+//
 //   To enable debugging you may try this in the setup script
 //
 //     THaScalerEvtHandler *lscaler = new THaScalerEvtHandler("Left","HA scaler event type 140");
@@ -48,6 +74,8 @@
 #include "Textvars.h"  // Podd::vsplit
 #include "Helper.h"
 #include "TTree.h"
+#include "Checkpoint.h"
+#include <algorithm>
 
 using namespace std;
 using namespace Decoder;
@@ -59,8 +87,13 @@ THaScalerEvtHandler::THaScalerEvtHandler(const char *name, const char* descripti
   , evcount(0)
   , fNormIdx(kMaxUInt)
   , fNormSlot(kMaxUInt)
+  , fNormClkChan(kMaxUInt)
   , dvars(nullptr)
   , fScalerTree(nullptr)
+  , fAccMode(kFillTree)
+  , fNsum(0)
+  , fSumTime{}
+  , fHelClock(-1)
 {}
 
 THaScalerEvtHandler::~THaScalerEvtHandler()
@@ -75,6 +108,47 @@ Int_t THaScalerEvtHandler::End( THaRunBase* )
 {
   if( fScalerTree )
     fScalerTree->Write();
+  if( fAccMode != kFillTree )
+    WriteSums();
+  return 0;
+}
+
+Int_t THaScalerEvtHandler::WriteCheckpoint( TDirectory* dir )
+{
+  // Save the scaler tree and the accumulated sums
+
+  Podd::Checkpoint::SaveTree(fScalerTree);
+  vector<Double_t> state{evcount, fNsum};
+  state.insert(state.end(), fSumTime, fSumTime+kNsum);
+  state.insert(state.end(), ALL(fPrevCount));
+  state.insert(state.end(), ALL(fSum));
+  return Podd::Checkpoint::WriteArray(dir, Form("%sstate",GetPrefix()), state);
+}
+
+Int_t THaScalerEvtHandler::ReadCheckpoint( TDirectory* dir )
+{
+  // Continue the scaler tree and the sums saved by WriteCheckpoint
+
+  if( fScalerTree ) {
+    TTree* tree = Podd::Checkpoint::ResumeTree(fScalerTree);
+    if( !tree )
+      return -1;
+    fScalerTree = tree;
+  }
+  vector<Double_t> state;
+  size_t nvar = fPrevCount.size();
+  if( Podd::Checkpoint::ReadArray(dir, Form("%sstate",GetPrefix()), state)
+      != Podd::SINT(2 + kNsum + (kNsum+1)*nvar) ) {
+    Error( Here("ReadCheckpoint"), "Saved scaler state not found or "
+           "inconsistent with scaler definitions" );
+    return -1;
+  }
+  auto it = state.begin();
+  evcount = *it++;
+  fNsum = *it++;
+  copy_n(it, kNsum, fSumTime);  it += kNsum;
+  copy_n(it, nvar, fPrevCount.begin());  it += nvar;
+  copy(it, state.end(), fSum.begin());
   return 0;
 }
 
@@ -89,7 +163,7 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
     EvDump(evdata);
   }
 
-  if( !fScalerTree ) {
+  if( !fScalerTree && fAccMode != kAccumulate ) {
 
     TString sname1 = "TS";
     TString sname2 = sname1 + fName;
@@ -138,17 +212,19 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
                   << "   " << hex << *p << "   " << dec << endl;
     }
     Int_t nskip = 1;
-    for( size_t j = 0; j < scalers.size(); j++ ) {
-      nskip = scalers[j]->Decode(p);
+    GenScaler* scaler = FindScaler(*p);
+    if( scaler ) {
+      nskip = scaler->Decode(p);
       if( fDebugFile && nskip > 1 ) {
-        *fDebugFile << "\n===== Scaler # " << j << "     fName = " << fName
+        *fDebugFile << "\n===== Scaler slot " << scaler->GetSlot()
+                    << "     fName = " << fName
                     << "   nskip = " << nskip << endl;
-        scalers[j]->DebugPrint(fDebugFile);
+        scaler->DebugPrint(fDebugFile);
       }
-      if( nskip > 1 ) {
+      if( nskip > 1 )
         ifound = true;
-        break;
-      }
+      else
+        nskip = 1;
     }
     p = p + nskip;
   }
@@ -168,25 +244,22 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
   // The correspondence between dvars and the scaler and the channel
   // will be driven by a scaler.map file, or could be hard-coded.
 
-  for( size_t i = 0; i < scalerloc.size(); i++ ) {
-    UInt_t idx = scalerloc[i]->index;
-    UInt_t ichan = scalerloc[i]->ichan;
+  for( size_t i = 0; i < fChanMap.size(); i++ ) {
+    const auto& loc = fChanMap[i];
+    if( !loc.scaler )
+      continue;
+    if( loc.ikind == ICOUNT )
+      dvars[i] = loc.scaler->GetData(loc.ichan);
+    else if( loc.ikind == IRATE )
+      dvars[i] = loc.scaler->GetRate(loc.ichan);
     if( fDebugFile )
-      *fDebugFile << "Debug dvars " << i << "  " << idx << "  " << ichan << endl;
-    if( idx < scalers.size() && ichan < MAXCHAN ) {
-      if( scalerloc[i]->ikind == ICOUNT )
-        dvars[i] = scalers[idx]->GetData(ichan);
-      if( scalerloc[i]->ikind == IRATE )
-        dvars[i] = scalers[idx]->GetRate(ichan);
-      if( fDebugFile )
-        *fDebugFile << "   dvars  " << scalerloc[i]->ikind
-                    << "  " << dvars[i] << endl;
-    } else {
-      cout << "THaScalerEvtHandler:: ERROR:: incorrect index " << i
-           << "  " << idx << "  " << ichan << endl;
-    }
+      *fDebugFile << "Debug dvars " << i << "  " << loc.ikind
+                  << "  " << loc.ichan << "  " << dvars[i] << endl;
   }
 
+  if( fAccMode != kFillTree )
+    Accumulate();
+
   evcount += 1.0;
 
   for( auto* s: scalers )
@@ -201,6 +274,123 @@ Int_t THaScalerEvtHandler::Analyze(THaEvData *evdata)
   return 1;
 }
 
+GenScaler* THaScalerEvtHandler::FindScaler( UInt_t word ) const
+{
+  // Return the not-yet-decoded scaler whose header matches the given data
+  // word, or nullptr if there is none. If several scalers share a header,
+  // they are assigned in the order in which they were defined.
+
+  for( const auto& group : fHeaderMap ) {
+    UInt_t key = word & group.mask;
+    auto it = lower_bound(ALL(group.keys), key,
+                          []( const HeaderKey_t& k, UInt_t h ) {
+                            return k.header < h;
+                          });
+    for( ; it != group.keys.end() && it->header == key; ++it ) {
+      GenScaler* scaler = scalers[it->index];
+      if( !scaler->IsDecoded() )
+        return scaler;
+    }
+  }
+  return nullptr;
+}
+
+void THaScalerEvtHandler::Accumulate()
+{
+  // Add the count increments since the previous reading to the run sums.
+  // The first reading of each channel only sets the baseline. Unsigned
+  // subtraction takes care of counter rollover.
+  //
+  // The helicity window sums of a variable are the increments of its
+  // helicity-gated copies, and the window times are the time since the
+  // previous reading times the fraction of clock counts in each window.
+  // A reading spans many helicity windows; the gated scaler inputs do
+  // the binning by window in hardware.
+
+  Double_t dtime = 0;
+  if( fNsum > 0 )
+    dtime = ( fNormIdx < scalers.size() )
+            ? scalers[fNormIdx]->GetTimeSincePrev() : defaultDT;
+
+  size_t nvar = fChanMap.size();
+  for( size_t i = 0; i < nvar; i++ ) {
+    const auto& loc = fChanMap[i];
+    fDelta[i] = 0;
+    if( !loc.scaler || !loc.scaler->IsDecoded() )
+      continue;
+    UInt_t counts = loc.scaler->GetData(loc.ichan);
+    if( fPrevCount[i] >= 0 )
+      fDelta[i] = counts - static_cast<UInt_t>(fPrevCount[i]);
+    fPrevCount[i] = counts;
+    fSum[i] += fDelta[i];
+  }
+  Double_t* summinus = fSum.data() + kSumMinus*nvar;
+  Double_t* sumplus  = fSum.data() + kSumPlus*nvar;
+  for( const auto& pair : fHelPairs ) {
+    summinus[pair.var] += fDelta[pair.minus];
+    sumplus[pair.var]  += fDelta[pair.plus];
+  }
+  fSumTime[kSumAll] += dtime;
+  if( fHelClock >= 0 ) {
+    const auto& clk = fHelPairs[fHelClock];
+    if( fDelta[clk.var] > 0 ) {
+      fSumTime[kSumMinus] += dtime * fDelta[clk.minus] / fDelta[clk.var];
+      fSumTime[kSumPlus]  += dtime * fDelta[clk.plus]  / fDelta[clk.var];
+    }
+  }
+  fNsum += 1.0;
+}
+
+void THaScalerEvtHandler::WriteSums()
+{
+  // Print the accumulated sums and write them to the summary tree
+
+  if( fNsum == 0 )
+    return;
+
+  size_t nvar = fChanMap.size();
+  Int_t nwin = fHelPairs.empty() ? 1 : kNsum;
+  const Int_t helval[kNsum] = { 0, -1, 1 };
+  vector<bool> gated(nvar, false);
+  for( const auto& pair : fHelPairs )
+    gated[pair.var] = true;
+
+  TString tname = "TS" + fName + "sum";
+  TString title = fName + "  Accumulated Scaler Data";
+  TTree sumtree(tname.Data(), title.Data());
+  Int_t hel = 0;
+  Double_t time = 0;
+  vector<Double_t> vals(nvar);
+  sumtree.Branch("helicity", &hel, "helicity/I");
+  sumtree.Branch("time", &time, "time/D");
+  for( size_t i = 0; i < nvar; i++ ) {
+    TString name = scalerloc[i]->name;
+    TString tinfo = name + "/D";
+    sumtree.Branch(name.Data(), &vals[i], tinfo.Data());
+  }
+
+  cout << "THaScalerEvtHandler " << fName << ": accumulated "
+       << fNsum << " readings" << endl;
+  for( Int_t iw = 0; iw < nwin; iw++ ) {
+    const Double_t* sum = fSum.data() + iw*nvar;
+    hel = helval[iw];
+    time = fSumTime[iw];
+    if( nwin > 1 )
+      cout << " helicity " << hel << ":";
+    cout << " time = " << time << " s" << endl;
+    for( size_t i = 0; i < nvar; i++ ) {
+      if( fChanMap[i].ikind == IRATE )
+        vals[i] = (time > 0) ? sum[i]/time : 0;
+      else
+        vals[i] = sum[i];
+      if( iw == kSumAll || gated[i] )
+        cout << "   " << scalerloc[i]->name << " = " << vals[i] << endl;
+    }
+    sumtree.Fill();
+  }
+  sumtree.Write();
+}
+
 // Helper functions for Init()
 void THaScalerEvtHandler::ParseVariable( const vector<string>& dbline )
 {
@@ -270,6 +460,7 @@ void THaScalerEvtHandler::ParseMap( const char* cbuf, const vector<string>& dbli
     if( clkchan != kMaxUInt ) {
       scalers[idx]->SetClock(defaultDT, clkchan, clkfreq);
       fNormIdx = idx;
+      fNormClkChan = clkchan;
       if( islot != fNormSlot )
         cout << "THaScalerEvtHandler:: WARN: contradictory norm slot ! "
              << islot << endl;
@@ -315,6 +506,102 @@ void THaScalerEvtHandler::SetIndices()
   }
 }
 
+void THaScalerEvtHandler::BuildHeaderMap()
+{
+  // Build the header word -> scaler lookup table. Scalers are grouped by
+  // header mask; within each group, headers are sorted for binary search.
+  // Scalers with the same header keep their order of definition.
+
+  fHeaderMap.clear();
+  for( UInt_t i = 0; i < scalers.size(); i++ ) {
+    UInt_t mask = scalers[i]->GetHeaderMask();
+    UInt_t header = scalers[i]->GetHeader() & mask;
+    auto it = find_if(ALL(fHeaderMap),
+                      [mask]( const HeaderGroup_t& g ) {
+                        return g.mask == mask;
+                      });
+    if( it == fHeaderMap.end() ) {
+      fHeaderMap.push_back({mask, {}});
+      it = fHeaderMap.end() - 1;
+    }
+    it->keys.push_back({header, i});
+  }
+  for( auto& group : fHeaderMap ) {
+    stable_sort(ALL(group.keys),
+                []( const HeaderKey_t& a, const HeaderKey_t& b ) {
+                  return a.header < b.header;
+                });
+  }
+  if( fDebugFile ) {
+    for( const auto& group : fHeaderMap ) {
+      *fDebugFile << "Header mask 0x" << hex << group.mask << dec << endl;
+      for( const auto& key : group.keys )
+        *fDebugFile << "   header 0x" << hex << key.header << dec
+                    << "  scaler # " << key.index << endl;
+    }
+  }
+}
+
+void THaScalerEvtHandler::BuildChanMap()
+{
+  // Resolve the scaler and channel of each variable. Variables with an
+  // invalid mapping are reported here once and then left at zero.
+
+  fChanMap.clear();
+  fChanMap.reserve(scalerloc.size());
+  for( size_t i = 0; i < scalerloc.size(); i++ ) {
+    const auto* loc = scalerloc[i];
+    GenScaler* scaler = nullptr;
+    if( loc->index < scalers.size() && loc->ichan < MAXCHAN ) {
+      scaler = scalers[loc->index];
+    } else {
+      cout << "THaScalerEvtHandler:: ERROR:: incorrect index " << i
+           << "  " << loc->index << "  " << loc->ichan << endl;
+    }
+    fChanMap.push_back({scaler, loc->ichan, loc->ikind});
+  }
+  size_t nvar = fChanMap.size();
+  fPrevCount.assign(nvar, -1);
+  fDelta.assign(nvar, 0);
+  fSum.assign(kNsum*nvar, 0);
+  fill_n(fSumTime, kNsum, 0);
+  fNsum = 0;
+}
+
+void THaScalerEvtHandler::BuildHelPairs()
+{
+  // Resolve the variable names of the "helicity" lines to indices into
+  // fChanMap and find the gated copies of the normalization clock
+
+  fHelPairs.clear();
+  fHelClock = -1;
+  auto find_var = [this]( const string& name ) -> UInt_t {
+    TString fullname = fName + name.c_str();
+    for( UInt_t i = 0; i < scalerloc.size(); i++ ) {
+      if( scalerloc[i]->name == fullname )
+        return i;
+    }
+    cout << "THaScalerEvtHandler:: WARN: helicity: unknown variable "
+         << name << endl;
+    return kMaxUInt;
+  };
+  for( size_t j = 0; j+2 < fHelNames.size(); j += 3 ) {
+    HelPair_t pair{ find_var(fHelNames[j]), find_var(fHelNames[j+1]),
+                    find_var(fHelNames[j+2]) };
+    if( pair.var == kMaxUInt || pair.plus == kMaxUInt ||
+        pair.minus == kMaxUInt )
+      continue;
+    const auto& loc = fChanMap[pair.var];
+    if( fHelClock < 0 && fNormIdx < scalers.size() &&
+        loc.scaler == scalers[fNormIdx] && loc.ichan == fNormClkChan )
+      fHelClock = static_cast<Int_t>(fHelPairs.size());
+    fHelPairs.push_back(pair);
+  }
+  if( !fHelPairs.empty() && fHelClock < 0 )
+    cout << "THaScalerEvtHandler:: WARN: no helicity-gated copies of the "
+         << "normalization clock. Helicity window times will be zero." << endl;
+}
+
 THaAnalysisObject::EStatus THaScalerEvtHandler::Init(const TDatime& date)
 {
   const int LEN = 200;
@@ -342,6 +629,12 @@ THaAnalysisObject::EStatus THaScalerEvtHandler::Init(const TDatime& date)
   const char comment = '#';
   const string svariable = "variable";
   const string smap = "map";
+  const string saccumulate = "accumulate";
+  const string shelicity = "helicity";
+
+  fAccMode = kFillTree;
+  fNormClkChan = kMaxUInt;
+  fHelNames.clear();
 
   while( fgets(cbuf, LEN, fi) ) {
     if (fDebugFile) *fDebugFile << "string input "<<cbuf<<endl;
@@ -358,6 +651,17 @@ THaAnalysisObject::EStatus THaScalerEvtHandler::Init(const TDatime& date)
     else if( dbline.size() > 6 && CmpNoCase(dbline.front(), smap) == 0 ) {
       ParseMap(cbuf, dbline);
     }
+    else if( dbline.size() > 1 && CmpNoCase(dbline.front(), saccumulate) == 0 ) {
+      fAccMode = atoi(dbline[1].c_str());
+      if( fAccMode < kFillTree || fAccMode > kBoth ) {
+        cout << "THaScalerEvtHandler:: WARN: invalid accumulate mode "
+             << fAccMode << ", using 0" << endl;
+        fAccMode = kFillTree;
+      }
+    }
+    else if( dbline.size() > 3 && CmpNoCase(dbline.front(), shelicity) == 0 ) {
+      fHelNames.insert(fHelNames.end(), dbline.begin()+1, dbline.begin()+4);
+    }
   }
   // need to do LoadNormScaler after scalers created and if fNormIdx found.
   AssignNormScaler();
@@ -417,6 +721,11 @@ THaAnalysisObject::EStatus THaScalerEvtHandler::Init(const TDatime& date)
   // Identify indices of scalers[] vector to variables.
   SetIndices();
 
+  // Precompute header lookup and variable -> channel mapping
+  BuildHeaderMap();
+  BuildChanMap();
+  BuildHelPairs();
+
   if(fDebugFile) {
     *fDebugFile << "THaScalerEvtHandler:: Name of scaler bank "<<fName<<endl;
     for (size_t i=0; i<scalers.size(); i++) {
@@ -50,6 +50,8 @@ public:
    virtual Int_t Analyze(THaEvData *evdata);
    virtual EStatus Init( const TDatime& run_time);
    virtual Int_t End( THaRunBase* r=nullptr );
+   virtual Int_t WriteCheckpoint( TDirectory* dir );
+   virtual Int_t ReadCheckpoint( TDirectory* dir );
 
 
 protected:
@@ -62,14 +64,57 @@ protected:
    void VerifySlots();
    void SetIndices();
    void AssignNormScaler();
+   void BuildHeaderMap();
+   void BuildChanMap();
+   void BuildHelPairs();
+   Decoder::GenScaler* FindScaler( UInt_t word ) const;
+   void Accumulate();
+   void WriteSums();
+
+   // Accumulation modes (database keyword "accumulate")
+   enum EAccMode { kFillTree = 0, kAccumulate = 1, kBoth = 2 };
+   // Helicity windows of the accumulated sums
+   enum { kSumAll = 0, kSumMinus, kSumPlus, kNsum };
+
+   struct HeaderKey_t {     // Header word -> index into scalers[]
+     UInt_t header;
+     UInt_t index;
+   };
+   struct HeaderGroup_t {   // Header keys sharing the same header mask
+     UInt_t mask;
+     std::vector<HeaderKey_t> keys;  // sorted by header
+   };
+   struct ScalerChan_t {    // Resolved data source of each variable
+     Decoder::GenScaler* scaler;
+     UInt_t ichan;
+     UInt_t ikind;
+   };
+   struct HelPair_t {       // Helicity-gated copies of a variable
+     UInt_t var;            // Indices into fChanMap
+     UInt_t plus;
+     UInt_t minus;
+   };
 
    std::vector<Decoder::GenScaler*> scalers;
    std::vector<ScalerLoc*> scalerloc;
    Double_t evcount;
    UInt_t fNormIdx, fNormSlot;
+   UInt_t fNormClkChan;     // Clock channel of the normalization scaler
    Double_t *dvars;
    TTree *fScalerTree;
 
+   std::vector<HeaderGroup_t> fHeaderMap; // Header lookup, built in Init
+   std::vector<ScalerChan_t>  fChanMap;   // Parallel to scalerloc/dvars
+   Int_t    fAccMode;       // Accumulation mode (EAccMode)
+   Double_t fNsum;          // Number of readings accumulated
+   std::vector<Long64_t> fPrevCount;  // Previous counts (-1: none yet)
+   std::vector<Double_t> fDelta;      // Counts since previous reading
+   std::vector<Double_t> fSum;        // Count sums [kNsum][nvars]
+   Double_t fSumTime[kNsum];          // Time integrals per window [s]
+   std::vector<std::string> fHelNames; // Variable names of "helicity" lines
+   std::vector<HelPair_t> fHelPairs;  // Resolved helicity-gated pairs
+   Int_t    fHelClock;      // Index of the clock in fHelPairs (-1: none)
+
    ClassDef(THaScalerEvtHandler,0)  // Scaler Event handler
 
 };
@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// THaShmRun
+//
+// Online run reading CODA events from a local shared-memory ring
+// published by a producer such as shmprod. See Decoder::THaShmClient.
+//
+// Example:
+//
+//   THaShmRun run("/podd_ring");
+//   analyzer->Process(run);
+//
+// Like THaOnlRun, the run date is the current time.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "THaShmRun.h"
+#include "THaShmClient.h"
+#include "TDatime.h"
+#include <stdexcept>
+
+using namespace std;
+
+//______________________________________________________________________________
+THaShmRun::THaShmRun( const char* ringname, Int_t mode )
+  : THaCodaRun(ringname), fRingName(ringname), fMode(mode)
+{
+  // Normal & default constructor
+
+  // NOW is the correct time
+  TDatime now;
+  SetDate(now);
+
+  fCodaData.reset(new Decoder::THaShmClient(fMode));
+}
+
+//______________________________________________________________________________
+THaShmRun::THaShmRun( const THaShmRun& rhs )
+  : THaCodaRun(rhs), fRingName(rhs.fRingName), fMode(rhs.fMode)
+{
+  // Copy constructor
+
+  TDatime now;
+  SetDate(now);
+
+  fCodaData.reset(new Decoder::THaShmClient(fMode));
+}
+
+//______________________________________________________________________________
+THaShmRun& THaShmRun::operator=( const THaRunBase& rhs )
+{
+  // Assignment operator
+
+  if( this != &rhs ) {
+    THaCodaRun::operator=(rhs);
+    try {
+      const auto& obj = dynamic_cast<const THaShmRun&>(rhs);
+      fRingName = obj.fRingName;
+      fMode     = obj.fMode;
+    }
+    catch( const std::bad_cast& e ) {}
+    fCodaData.reset(new Decoder::THaShmClient(fMode));
+  }
+  return *this;
+}
+
+//______________________________________________________________________________
+Int_t THaShmRun::Open()
+{
+  // Connect to the shared-memory ring
+
+  if( fRingName.IsNull() ) {
+    Error( "Open", "Ring name not set. Cannot open shared-memory run." );
+    return -2;
+  }
+
+  Int_t st = ReturnCode( fCodaData->codaOpen(fRingName, fMode) );
+  if( st == READ_OK )
+    fOpened = true;
+  return st;
+}
+
+//______________________________________________________________________________
+ClassImp(THaShmRun)
@@ -0,0 +1,33 @@
+#ifndef Podd_THaShmRun_h_
+#define Podd_THaShmRun_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// THaShmRun
+//
+// Online run reading CODA events from a local shared-memory ring.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "THaCodaRun.h"
+#include "TString.h"
+
+class THaShmRun : public THaCodaRun {
+
+public:
+  explicit THaShmRun( const char* ringname = "", Int_t mode = 1 );
+  THaShmRun( const THaShmRun& rhs );
+  virtual THaShmRun& operator=( const THaRunBase& rhs );
+
+  virtual Int_t  Open();
+  const char*    GetRingName() const { return fRingName.Data(); }
+  void           SetRingName( const char* name ) { fRingName = name; }
+
+protected:
+  TString  fRingName;   // Name of shared memory ring, e.g. "/podd_ring"
+  Int_t    fMode;       // 0 = wait forever for data, 1 = time out
+
+  ClassDef(THaShmRun,1)  // Online run from a shared-memory event ring
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include "THaNonTrackingDetector.h"
 #include "THaPIDinfo.h"
 #include "THaTrack.h"
+#include "TrackBuffer.h"
+#include "ModuleProfiler.h"
 #include "TClass.h"
 #include "TList.h"
 #include "TMath.h"
@@ -31,6 +33,7 @@
 #endif
 
 using namespace std;
+using Podd::ModuleProfiler;
 
 //_____________________________________________________________________________
 THaSpectrometer::THaSpectrometer( const char* name, const char* desc ) :
@@ -47,6 +50,10 @@ THaSpectrometer::THaSpectrometer( const char* name, const char* desc ) :
   fSinThSph{0.0}, fCosThSph{1.0}, fSinPhSph{0.0}, fCosPhSph{1.0},
   fPcentral{1.0},
   fCollDist{0.0},
+  fToLabMat{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0},
+  fToTraMat{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0},
+  fOwnToLab{false},
+  fOwnToTra{false},
   fStagesDone{0},
   fPID{false}
 {
@@ -178,6 +185,19 @@ THaAnalysisObject::EStatus THaSpectrometer::Init( const TDatime& run_time )
   if( IsPID() )
     PidInit();
 
+  // The batched transformations use the rotation matrices directly unless
+  // this class has its own per-track transformations
+  const char* const toLabProto = "Double_t,Double_t,Double_t,TVector3&";
+  const char* const toTraProto =
+    "const TVector3&,const TVector3&,TVector3&,Double_t*";
+  TClass* base = THaSpectrometer::Class();
+  fOwnToLab =
+    IsA()->GetMethodWithPrototype("TransportToLab", toLabProto, true) !=
+    base->GetMethodWithPrototype("TransportToLab", toLabProto, true);
+  fOwnToTra =
+    IsA()->GetMethodWithPrototype("LabToTransport", toTraProto, true) !=
+    base->GetMethodWithPrototype("LabToTransport", toTraProto, true);
+
   // TODO: Set up vertex objects that can be associated with tracks?
 
   return kOK;
@@ -317,7 +337,10 @@ Int_t THaSpectrometer::CoarseTrack()
     if( fDebug>1 ) cout << "Call CoarseTrack() for " 
 			<< theTrackDetector->GetName() << "... ";
 #endif
-    theTrackDetector->CoarseTrack( *fTracks );
+    {
+      ModuleProfiler::Span span(theTrackDetector, ModuleProfiler::kCoarseTrack);
+      theTrackDetector->CoarseTrack( *fTracks );
+    }
 #ifdef WITH_DEBUG
     if( fDebug>1 ) cout << "done.\n";
 #endif
@@ -346,7 +369,11 @@ Int_t THaSpectrometer::CoarseReconstruct()
     if( fDebug>1 ) cout << "Call CoarseProcess() for " 
 			<< theNonTrackDetector->GetName() << "... ";
 #endif
-    theNonTrackDetector->CoarseProcess( *fTracks );
+    {
+      ModuleProfiler::Span span(theNonTrackDetector,
+                                ModuleProfiler::kCoarseReconstruct);
+      theNonTrackDetector->CoarseProcess( *fTracks );
+    }
 #ifdef WITH_DEBUG
     if( fDebug>1 ) cout << "done.\n";
 #endif
@@ -374,7 +401,10 @@ Int_t THaSpectrometer::Track()
     if( fDebug>1 ) cout << "Call FineTrack() for " 
 			<< theTrackDetector->GetName() << "... ";
 #endif
-    theTrackDetector->FineTrack( *fTracks );
+    {
+      ModuleProfiler::Span span(theTrackDetector, ModuleProfiler::kTrack);
+      theTrackDetector->FineTrack( *fTracks );
+    }
 #ifdef WITH_DEBUG
     if( fDebug>1 ) cout << "done.\n";
 #endif
@@ -428,7 +458,11 @@ Int_t THaSpectrometer::Reconstruct()
     if( fDebug>1 ) cout << "Call FineProcess() for " 
 			<< theNonTrackDetector->GetName() << "... ";
 #endif
-    theNonTrackDetector->FineProcess( *fTracks );
+    {
+      ModuleProfiler::Span span(theNonTrackDetector,
+                                ModuleProfiler::kReconstruct);
+      theNonTrackDetector->FineProcess( *fTracks );
+    }
 #ifdef WITH_DEBUG
     if( fDebug>1 ) cout << "done.\n";
 #endif
@@ -520,6 +554,136 @@ void THaSpectrometer::LabToTransport( const TVector3& vertex,
   ray[5] = pt.Mag() / fPcentral - 1.0;
 }
 
+//_____________________________________________________________________________
+void THaSpectrometer::TracksToLab( Podd::TrackBuffer& buf ) const
+{
+  // Batched version of TransportToLab(p,th,ph,pvect) for all tracks in 'buf'.
+  // Inputs:  buf.p, buf.th, buf.ph
+  // Outputs: buf.px, buf.py, buf.pz
+  //
+  // If a derived class overrides the per-track TransportToLab, that version
+  // is called for each track. Otherwise, all tracks are transformed in one
+  // pass with the rotation matrix computed in SetCentralAngles.
+
+  const UInt_t n = buf.GetSize();
+  if( fOwnToLab ) {
+    TVector3 pvect;
+    for( UInt_t i = 0; i < n; ++i ) {
+      TransportToLab( buf.p[i], buf.th[i], buf.ph[i], pvect );
+      buf.px[i] = pvect.X();
+      buf.py[i] = pvect.Y();
+      buf.pz[i] = pvect.Z();
+    }
+    return;
+  }
+  const Double_t* m = fToLabMat;
+  const Double_t* p  = buf.p.data();
+  const Double_t* th = buf.th.data();
+  const Double_t* ph = buf.ph.data();
+  Double_t* px = buf.px.data();
+  Double_t* py = buf.py.data();
+  Double_t* pz = buf.pz.data();
+  for( UInt_t i = 0; i < n; ++i ) {
+    Double_t pn = p[i] / TMath::Sqrt( 1.0 + th[i]*th[i] + ph[i]*ph[i] );
+    Double_t x = th[i]*pn, y = ph[i]*pn;
+    px[i] = m[0]*x + m[1]*y + m[2]*pn;
+    py[i] = m[3]*x + m[4]*y + m[5]*pn;
+    pz[i] = m[6]*x + m[7]*y + m[8]*pn;
+  }
+}
+
+//_____________________________________________________________________________
+void THaSpectrometer::TracksToTransport( Podd::TrackBuffer& buf ) const
+{
+  // Batched version of LabToTransport(vertex,pvect,ray) for all tracks
+  // in 'buf'.
+  // Inputs:  buf.vx, buf.vy, buf.vz, buf.px, buf.py, buf.pz
+  // Outputs: buf.x, buf.th, buf.y, buf.ph, buf.dp (ray elements 0-3 and 5)
+  //          and buf.p (momentum magnitude)
+  //
+  // If a derived class overrides the per-track LabToTransport, that version
+  // is called for each track. Otherwise, all tracks are transformed in one
+  // pass with the rotation matrix computed in SetCentralAngles.
+
+  const UInt_t n = buf.GetSize();
+  if( fOwnToTra ) {
+    TVector3 vertex, pvect, tvertex;
+    Double_t ray[6];
+    for( UInt_t i = 0; i < n; ++i ) {
+      vertex.SetXYZ( buf.vx[i], buf.vy[i], buf.vz[i] );
+      pvect.SetXYZ( buf.px[i], buf.py[i], buf.pz[i] );
+      LabToTransport( vertex, pvect, tvertex, ray );
+      buf.x[i]  = ray[0];
+      buf.th[i] = ray[1];
+      buf.y[i]  = ray[2];
+      buf.ph[i] = ray[3];
+      buf.dp[i] = ray[5];
+      buf.p[i]  = pvect.Mag();
+    }
+    return;
+  }
+  const Double_t* m = fToTraMat;
+  const Double_t ox = fPointingOffset.X(), oy = fPointingOffset.Y(),
+    oz = fPointingOffset.Z();
+  const Double_t pc = fPcentral;
+  for( UInt_t i = 0; i < n; ++i ) {
+    Double_t dx = buf.vx[i]-ox, dy = buf.vy[i]-oy, dz = buf.vz[i]-oz;
+    Double_t tx = m[0]*dx + m[1]*dy + m[2]*dz;
+    Double_t ty = m[3]*dx + m[4]*dy + m[5]*dz;
+    Double_t tz = m[6]*dx + m[7]*dy + m[8]*dz;
+    Double_t qx = m[0]*buf.px[i] + m[1]*buf.py[i] + m[2]*buf.pz[i];
+    Double_t qy = m[3]*buf.px[i] + m[4]*buf.py[i] + m[5]*buf.pz[i];
+    Double_t qz = m[6]*buf.px[i] + m[7]*buf.py[i] + m[8]*buf.pz[i];
+    Double_t q  = TMath::Sqrt( qx*qx + qy*qy + qz*qz );
+    if( qz != 0.0 ) {
+      Double_t th = qx/qz, ph = qy/qz;
+      buf.th[i] = th;
+      buf.ph[i] = ph;
+      buf.x[i]  = tx - tz*th;
+      buf.y[i]  = ty - tz*ph;
+    } else
+      buf.x[i] = buf.th[i] = buf.y[i] = buf.ph[i] = 0.0;
+    buf.p[i]  = q;
+    buf.dp[i] = q/pc - 1.0;
+  }
+}
+
+//_____________________________________________________________________________
+void THaSpectrometer::TrackVertices( Podd::TrackBuffer& buf,
+                                     const TVector3& beam_org,
+                                     const TVector3& beam_ray ) const
+{
+  // Vertices of all tracks in 'buf' with buf.ok set: intersection of the
+  // beam ray ('beam_org', 'beam_ray') with the plane spanned by the lab
+  // momentum of the track and the lab y-axis, passing through the y_tg
+  // point of the track. This is the same calculation as done by
+  // THaReactionPoint with IntersectPlaneWithRay().
+  // Inputs:  buf.y, buf.px, buf.pz, buf.ok
+  // Outputs: buf.vx, buf.vy, buf.vz. buf.ok is cleared for tracks
+  //          parallel to the beam.
+
+  // Lab position of a point (0,y_tg,0) is offset + y_tg * (second column
+  // of the TRANSPORT-to-lab rotation). The plane normal, pvect x y_lab,
+  // has no y-component, so y-coordinates do not enter.
+  const Double_t* m = fToLabMat;
+  const Double_t ox = fPointingOffset.X(), oz = fPointingOffset.Z();
+  const Double_t bx = beam_org.X(), by = beam_org.Y(), bz = beam_org.Z();
+  const Double_t rx = beam_ray.X(), ry = beam_ray.Y(), rz = beam_ray.Z();
+  const UInt_t n = buf.GetSize();
+  for( UInt_t i = 0; i < n; ++i ) {
+    Double_t nx = -buf.pz[i], nz = buf.px[i];
+    Double_t den = nx*rx + nz*rz;
+    Double_t y = buf.y[i];
+    Double_t num = nx*(ox + m[1]*y - bx) + nz*(oz + m[7]*y - bz);
+    Bool_t good = buf.ok[i] && TMath::Abs(den) >= 1e-5;
+    Double_t t = good ? num/den : 0.0;
+    buf.ok[i] = good;
+    buf.vx[i] = bx + t*rx;
+    buf.vy[i] = by + t*ry;
+    buf.vz[i] = bz + t*rz;
+  }
+}
+
 //_____________________________________________________________________________
 void THaSpectrometer::SetCentralAngles( Double_t th, Double_t ph,
 					Bool_t bend_down )
@@ -548,6 +712,14 @@ void THaSpectrometer::SetCentralAngles( Double_t th, Double_t ph,
   if( bend_down ) { nx *= -1.0; ny *= -1.0; }
   fToLabRot.SetToIdentity().RotateAxes( nx, ny, nz );
   fToTraRot = fToLabRot.Inverse();
+
+  // Plain copies of the matrices for the batched transformations
+  for( Int_t i = 0; i < 3; ++i ) {
+    for( Int_t j = 0; j < 3; ++j ) {
+      fToLabMat[3*i+j] = fToLabRot(i,j);
+      fToTraMat[3*i+j] = fToTraRot(i,j);
+    }
+  }
 }
 
 //_____________________________________________________________________________
@@ -20,6 +20,7 @@
 class THaTrack;
 class TList;
 class THaCut;
+namespace Podd { class TrackBuffer; }
 
 class THaSpectrometer : public THaApparatus, public THaTrackingModule,
                         public THaVertexModule {
@@ -86,6 +87,15 @@ public:
           void             LabToTransport( const TVector3& vertex, 
                                            const TVector3& pvect,
                                            Double_t* ray ) const;
+
+  // Batched versions for all tracks in a TrackBuffer. If a derived class
+  // overrides the per-track TransportToLab/LabToTransport, its version is
+  // called for each track instead of the matrix-based default.
+  virtual void             TracksToLab( Podd::TrackBuffer& buf ) const;
+  virtual void             TracksToTransport( Podd::TrackBuffer& buf ) const;
+          void             TrackVertices( Podd::TrackBuffer& buf,
+                                          const TVector3& beam_org,
+                                          const TVector3& beam_ray ) const;
   enum EStagesDone {
     kCoarseTrack = BIT(0),
     kCoarseRecon = BIT(1),
@@ -118,6 +128,10 @@ protected:
   Double_t        fSinPhSph, fCosPhSph;   // spherical coordinates
   Double_t        fPcentral;              //Central momentum (GeV)
   Double_t        fCollDist;              //Distance from collimator to target center (m)
+  Double_t        fToLabMat[9];           //! fToLabRot as plain array (row-major)
+  Double_t        fToTraMat[9];           //! fToTraRot as plain array (row-major)
+  Bool_t          fOwnToLab;              //! Per-track TransportToLab overridden
+  Bool_t          fOwnToTra;              //! Per-track LabToTransport overridden
 
   // Status flags
   UInt_t          fStagesDone;            //Bitfield of completed analysis stages
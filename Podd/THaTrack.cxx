@@ -20,7 +20,8 @@ THaTrack::~THaTrack()
 {
   // Destructor. Delete objects owned by this track.
 
-  delete fID;
+  if( !TestBit(kExternalID) )
+    delete fID;
 }
 
 //_____________________________________________________________________________
@@ -48,7 +49,10 @@ void THaTrack::Clear( Option_t* opt )
     fChi2 = kBig; fNDoF = 0;
     memset( fClusters, 0, kMAXCL*sizeof(void*) );
   }
-  delete fID; fID = nullptr;
+  if( !TestBit(kExternalID) )
+    delete fID;
+  fID = nullptr;
+  ResetBit(kExternalID);
 }
 
 //_____________________________________________________________________________
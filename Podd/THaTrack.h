@@ -31,6 +31,11 @@ public:
     kHasVertex     = BIT(4)   // Vertex reconstructed
   };
 
+  // Object status bits
+  enum {
+    kExternalID    = BIT(14)  // fID is not owned by this track
+  };
+
   // Default constructor
   THaTrack()
     : TObject(),
@@ -164,7 +169,9 @@ public:
 
   void              SetChi2( Double_t chi2, Int_t ndof ) { fChi2=chi2; fNDoF=ndof; }
 
-  void              SetID( THaTrackID* id )   { fID   = id; }
+  // If 'owner' is false, the ID must remain valid until the track is cleared
+  void              SetID( THaTrackID* id, Bool_t owner = true )
+  { fID = id; SetBit(kExternalID, !owner); }
   void              SetFlag( UInt_t flag )    { fFlag = flag; }
   void              SetType( UInt_t flag )    { fType = flag; }
   void              SetMomentum( Double_t p ) { fP    = p; }
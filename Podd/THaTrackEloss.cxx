@@ -53,15 +53,7 @@ void THaTrackEloss::CalcEloss( THaTrackInfo* trkifo )
   //
   // May be overridden by derived classes as necessary.
 
-  Double_t p0 = trkifo->GetP();
-  Double_t beta = p0 / TMath::Sqrt(p0*p0 + fM*fM);
-  if( fElectronMode ) {
-    fEloss = ElossElectron( beta, fZmed, fAmed, 
-			    fDensity, fPathlength );
-  } else {
-    fEloss = ElossHadron( fZ, beta, fZmed, fAmed, 
-			  fDensity, fPathlength );
-  }
+  fEloss = ElossForMomentum( trkifo->GetP() );
 }
 
 //_____________________________________________________________________________
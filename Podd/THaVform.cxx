@@ -560,6 +560,15 @@ Int_t THaVform::SetOutput(TTree *tree)
 
 }
 
+//_____________________________________________________________________________
+void THaVform::ResetOutput(TTree *tree)
+{
+  // Tell our array buffer, if any, that the output tree changed, so that
+  // branch addresses are updated in the new tree when the buffer grows.
+  // Called by THaOutput::ReadCheckpoint.
+  if (fOdata) fOdata->tree = tree;
+}
+
 //_____________________________________________________________________________
 Int_t THaVform::Process()
 {
@@ -49,6 +49,8 @@ public:
 // Must 'SetOutput' at initialization if output to appear in tree.
 // Normally not desired for THaVforms that belong to THaVhist's
   Int_t SetOutput(TTree *tree);
+// Switch to another tree with the same branches (checkpoint resume)
+  void ResetOutput(TTree *tree);
 // Must 'Process' once per event before processing the things
 // that use this object.
   Int_t Process();
@@ -28,6 +28,7 @@
 #include "TH1.h"
 #include "TH2.h"
 #include "TFile.h"
+#include "TKey.h"
 #include "TRegexp.h"
 #include "TError.h"
 #include "TROOT.h"
@@ -200,6 +201,20 @@ Int_t THaVhist::Init( )
   return fInitStat;
 }
 
+//_____________________________________________________________________________
+vector<string> THaVhist::GetVars() const
+{
+  // Get names of variables used by the x, y and cut formulas.
+  vector<string> vars;
+  for( const auto* form : {fFormX, fFormY, fCut} ) {
+    if( form ) {
+      vector<string> v = form->GetVars();
+      vars.insert(vars.end(), v.begin(), v.end());
+    }
+  }
+  return vars;
+}
+
 //_____________________________________________________________________________
 void THaVhist::ReAttach( ) 
 {
@@ -543,6 +558,39 @@ Int_t THaVhist::End()
   return 0;
 }
 
+//_____________________________________________________________________________
+Int_t THaVhist::WriteCheckpoint()
+{
+  // Write the histograms to the current directory, replacing the
+  // previous checkpoint's copies
+  for( auto& ith : fH1 ) ith->Write(nullptr, TObject::kOverwrite);
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t THaVhist::ReadCheckpoint(TDirectory *dir)
+{
+  // Add the contents of the histograms saved in 'dir' at a checkpoint to
+  // ours. Vector histograms are extended to the size they had grown to.
+  if (!dir || !fProc) return 0;
+  if (fEye == 0 && fScalar == 0 && fSize > 1) {
+    Int_t size = fSize;
+    while (size < fgVHIST_HUGE && dir->GetKey(Form("%s%d",fName.c_str(),size)))
+      ++size;
+    if (size > fSize) BookHisto(fSize, size);
+  }
+  for( auto& ith : fH1 ) {
+    // Not Get(): that would find our own histogram in memory
+    TKey* key = dir->GetKey(ith->GetName());
+    if (!key) continue;
+    auto* saved = dynamic_cast<TH1*>(key->ReadObj());
+    if (!saved) continue;
+    ith->Add(saved);
+    delete saved;
+  }
+  return 0;
+}
+
 
 //_____________________________________________________________________________
 void THaVhist::ErrPrint() const
@@ -16,6 +16,7 @@ class THaVar;
 class TH1F;
 class TH2F;
 class THaCut;
+class TDirectory;
 
 using std::string;
 
@@ -37,6 +38,8 @@ public:
    const string& GetVarX() const { return fVarX; };
    const string& GetVarY() const { return fVarY; };
    const string& GetCutStr() const  { return fScut; };
+// Names of the variables used by the formulas and the cut
+   std::vector<string> GetVars() const;
    Int_t CheckCut(Int_t index=0);
    Bool_t HasCut() const { return !fScut.empty(); };
    Bool_t IsValid() const { return fProc; };
@@ -48,6 +51,9 @@ public:
    Int_t Process();
 // Must End() to write histogram to output at end of analysis.
    Int_t End();
+// Save histograms at a checkpoint. Add saved contents when resuming.
+   Int_t WriteCheckpoint();
+   Int_t ReadCheckpoint(TDirectory *dir);
 // Self-explanatory printouts.
    void  Print() const;
    void  ErrPrint() const;
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::TrackBuffer
+//
+// Per-event copy of the target and lab coordinates of a spectrometer's
+// tracks, one array per quantity ("structure of arrays"). Coordinate
+// transformations that are applied to every track, such as those in
+// THaSpectrometer, can then run over all tracks in one tight loop
+// without TVector3/TRotation temporaries and be vectorized by the
+// compiler. The results are copied back to the THaTrack objects at the
+// end.
+//
+// The arrays are only ever grown, so a buffer kept as a member of the
+// using class does not allocate once it has seen the largest event.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TrackBuffer.h"
+#include "THaTrack.h"
+#include "TClonesArray.h"
+#include "TMath.h"
+
+using namespace std;
+
+namespace Podd {
+
+//_____________________________________________________________________________
+void TrackBuffer::Resize( UInt_t n )
+{
+  // Set number of tracks to n. Array contents are undefined afterwards.
+
+  if( n > x.size() ) {
+    for( auto* v : {&x, &th, &y, &ph, &p, &dp, &px, &py, &pz, &vx, &vy, &vz} )
+      v->resize(n);
+    ok.resize(n);
+  }
+  fN = n;
+}
+
+//_____________________________________________________________________________
+UInt_t TrackBuffer::Load( const TClonesArray& tracks )
+{
+  // Fill buffer from the THaTrack objects in 'tracks'. Returns the number
+  // of tracks with target coordinates.
+
+  UInt_t n = tracks.GetLast()+1, ngood = 0;
+  Resize(n);
+  for( UInt_t i = 0; i < n; ++i ) {
+    const auto* theTrack = static_cast<const THaTrack*>( tracks.At(i) );
+    if( !theTrack || !theTrack->HasTarget() ) {
+      ok[i] = false;
+      x[i] = th[i] = y[i] = ph[i] = p[i] = dp[i] = 0.0;
+      px[i] = py[i] = pz[i] = 0.0;
+    } else {
+      ok[i] = true;
+      ++ngood;
+      x[i]  = theTrack->GetTX();
+      th[i] = theTrack->GetTTheta();
+      y[i]  = theTrack->GetTY();
+      ph[i] = theTrack->GetTPhi();
+      p[i]  = theTrack->GetP();
+      dp[i] = theTrack->GetDp();
+      px[i] = theTrack->GetLabPx();
+      py[i] = theTrack->GetLabPy();
+      pz[i] = theTrack->GetLabPz();
+    }
+    vx[i] = vy[i] = vz[i] = 0.0;
+  }
+  return ngood;
+}
+
+//_____________________________________________________________________________
+void TrackBuffer::StorePvect( TClonesArray& tracks ) const
+{
+  // Set lab momentum vectors of the tracks from px/py/pz
+
+  UInt_t n = TMath::Min(fN, static_cast<UInt_t>(tracks.GetLast()+1));
+  for( UInt_t i = 0; i < n; ++i ) {
+    auto* theTrack = static_cast<THaTrack*>( tracks.At(i) );
+    if( theTrack )
+      theTrack->GetPvect().SetXYZ(px[i], py[i], pz[i]);
+  }
+}
+
+//_____________________________________________________________________________
+void TrackBuffer::StoreVertex( TClonesArray& tracks ) const
+{
+  // Set vertices of the tracks with valid results from vx/vy/vz
+
+  UInt_t n = TMath::Min(fN, static_cast<UInt_t>(tracks.GetLast()+1));
+  for( UInt_t i = 0; i < n; ++i ) {
+    auto* theTrack = static_cast<THaTrack*>( tracks.At(i) );
+    if( theTrack && ok[i] )
+      theTrack->SetVertex(vx[i], vy[i], vz[i]);
+  }
+}
+
+} // namespace Podd
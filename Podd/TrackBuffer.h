@@ -0,0 +1,50 @@
+#ifndef Podd_TrackBuffer_h_
+#define Podd_TrackBuffer_h_
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Podd::TrackBuffer
+//
+// Track coordinates in structure-of-arrays layout for batched
+// coordinate transformations
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <vector>
+
+class TClonesArray;
+
+namespace Podd {
+
+class TrackBuffer {
+
+public:
+  TrackBuffer() : fN(0) {}
+
+  void   Resize( UInt_t n );
+  UInt_t GetSize() const { return fN; }
+
+  // Copy target and lab quantities of THaTrack objects in 'tracks' into
+  // the buffer. ok[i] is set for tracks with target coordinates.
+  UInt_t Load( const TClonesArray& tracks );
+  // Copy lab momenta and vertices back to the THaTrack objects. Vertices
+  // are stored only for tracks with ok[i] set.
+  void   StorePvect( TClonesArray& tracks ) const;
+  void   StoreVertex( TClonesArray& tracks ) const;
+
+  // TRANSPORT coordinates at the target
+  std::vector<Double_t> x, th, y, ph;  // Position (m), tangents of angles
+  std::vector<Double_t> p, dp;         // Momentum (GeV) and delta
+  // Lab frame (z = beam, y = up)
+  std::vector<Double_t> px, py, pz;    // Momentum (GeV)
+  std::vector<Double_t> vx, vy, vz;    // Vertex (m)
+  std::vector<UChar_t>  ok;            // Track usable/result valid
+
+private:
+  UInt_t fN;   // Number of tracks in buffer
+};
+
+} // namespace Podd
+
+#endif
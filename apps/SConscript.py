@@ -9,7 +9,7 @@ thisdir_fullpath = Dir('.').path
 thisdir = os.path.basename(os.path.normpath(thisdir_fullpath))
 
 # Executables
-appnames = ['analyzer', 'dbconvert']
+appnames = ['analyzer', 'dbconvert', 'replaybench']
 apps = []
 sources = []
 # SCons seems to ignore $RPATH on macOS... sigh
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  replaybench
+//
+//  The analyzer interface with memory allocation counting, for running
+//  replay benchmarks. It replaces the global operator new with a version
+//  that counts calls and registers the counter with THaBenchmark, so that
+//  THaAnalyzer::WriteBenchmarkReport can report allocation counts.
+//  Allocations made with malloc directly are not counted.
+//
+//  Usage is the same as for analyzer, e.g.
+//    replaybench -b -q 'bench/replay_bench.C("evio","run.dat","bench.json")'
+//  See bench/run_bench.sh.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "THaInterface.h"
+#include "THaBenchmark.h"
+#include <iostream>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+using namespace std;
+
+static atomic<ULong64_t> nalloc{0};
+
+static ULong64_t GetAllocCount()
+{
+  return nalloc.load(memory_order_relaxed);
+}
+
+static void* CountedAlloc( size_t size )
+{
+  nalloc.fetch_add(1, memory_order_relaxed);
+  return malloc(size ? size : 1);
+}
+
+//_____________________________________________________________________________
+void* operator new( size_t size )
+{
+  while( true ) {
+    if( void* p = CountedAlloc(size) )
+      return p;
+    new_handler handler = get_new_handler();
+    if( !handler )
+      throw bad_alloc();
+    handler();
+  }
+}
+
+void* operator new[]( size_t size )
+{
+  return operator new(size);
+}
+
+void* operator new( size_t size, const nothrow_t& ) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void* operator new[]( size_t size, const nothrow_t& ) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void operator delete( void* p ) noexcept
+{
+  free(p);
+}
+
+void operator delete[]( void* p ) noexcept
+{
+  free(p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete( void* p, size_t ) noexcept
+{
+  free(p);
+}
+
+void operator delete[]( void* p, size_t ) noexcept
+{
+  free(p);
+}
+#endif
+
+//_____________________________________________________________________________
+int main(int argc, char **argv)
+{
+  THaBenchmark::SetAllocCounter(GetAllocCount);
+
+  unique_ptr<TApplication> theApp{
+    new THaInterface("The Hall A analyzer", &argc, argv, nullptr, 0, true)};
+  theApp->Run(false);
+
+  cout << endl;
+
+  return 0;
+}
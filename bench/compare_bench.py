@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+#
+# Compare two replay benchmark reports written by
+# THaAnalyzer::WriteBenchmarkReport (see run_bench.sh).
+#
+# Usage: compare_bench.py [-t percent] baseline.json current.json
+#
+# Prints the overall event rate, peak memory, allocations per event and,
+# per analysis stage, the mean and the 50th/99th percentile latencies
+# of both reports. A quantity that got worse by more than the tolerance
+# (default 5%) is flagged as a regression, and the exit status is 1.
+# The tail (p99) latencies are noisier and are checked with twice the
+# tolerance.
+
+import argparse
+import json
+import sys
+
+
+def change(base, cur):
+    if base is None or cur is None or base == 0:
+        return None
+    return 100.0 * (cur - base) / base
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('-t', '--tolerance', type=float, default=5.0,
+                        help='allowed degradation in percent (default 5)')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        base = json.load(f)
+    with open(args.current) as f:
+        cur = json.load(f)
+
+    regressions = []
+
+    def check(name, b, c, higher_is_better, tol):
+        d = change(b, c)
+        flag = ''
+        if d is not None:
+            worse = -d if higher_is_better else d
+            if worse > tol:
+                flag = '  REGRESSION'
+                regressions.append(name)
+        fb = '-' if b is None else '%.3f' % b
+        fc = '-' if c is None else '%.3f' % c
+        fd = '' if d is None else '%+.1f%%' % d
+        print('%-36s %14s %14s %9s%s' % (name, fb, fc, fd, flag))
+
+    print('Baseline: %s (%s)' % (base.get('version', '?'), base.get('gitrev', '?')))
+    print('Current:  %s (%s)' % (cur.get('version', '?'), cur.get('gitrev', '?')))
+    if base['events']['read'] != cur['events']['read']:
+        print('WARNING: different number of events read (%d vs %d)'
+              % (base['events']['read'], cur['events']['read']))
+    print('%-36s %14s %14s %9s' % ('', 'baseline', 'current', 'change'))
+
+    tol = args.tolerance
+    check('events_per_s', base.get('events_per_s'), cur.get('events_per_s'),
+          True, tol)
+    check('peak_rss_kb', base.get('peak_rss_kb'), cur.get('peak_rss_kb'),
+          False, tol)
+    check('allocations_per_event', base.get('allocations_per_event'),
+          cur.get('allocations_per_event'), False, tol)
+
+    bstages = base.get('stages', {})
+    cstages = cur.get('stages', {})
+    for stage in bstages:
+        if stage not in cstages:
+            print('%-36s missing in current report' % stage)
+            continue
+        bl = bstages[stage]['latency_us']
+        cl = cstages[stage]['latency_us']
+        check(stage + ' mean (us)', bl['mean'], cl['mean'], False, tol)
+        check(stage + ' p50 (us)', bl['p50'], cl['p50'], False, tol)
+        check(stage + ' p99 (us)', bl['p99'], cl['p99'], False, 2 * tol)
+        if 'allocations' in bstages[stage] and 'allocations' in cstages[stage]:
+            check(stage + ' allocations', bstages[stage]['allocations'],
+                  cstages[stage]['allocations'], False, tol)
+
+    if regressions:
+        print('%d regression(s): %s' % (len(regressions), ', '.join(regressions)))
+        return 1
+    print('No regressions')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,116 @@
+#!/bin/bash
+#
+# Reproducible end-to-end replay benchmark.
+#
+# Generates canned synthetic input runs (once per event count), replays
+# each of them with replay_bench.C through a standard HRS setup using
+# replaybench, and collects the JSON benchmark reports. With -b, the
+# reports are compared against those of an earlier run (e.g. of the
+# previous release) using compare_bench.py.
+#
+# Usage: run_bench.sh [options] [workload ...]
+#   -n nevents   Number of events per workload (default 20000)
+#   -w workdir   Directory for input files and results (default ./bench_work)
+#   -o outdir    Directory for the JSON reports (default workdir/results)
+#   -b basedir   Compare the reports with those in basedir
+#   -t percent   Tolerance for the comparison (default 5)
+#
+# Workloads: evio (default) and vdcsim. The vdcsim workload needs the
+# VDCsim plugin (libVDCsim and vdcsimgen) in the library and program path.
+#
+# The programs evgen, replaybench and, for vdcsim, vdcsimgen must be in
+# PATH. DB_DIR defaults to the DB directory of this source tree.
+#
+# Exit status is 0 if all workloads ran and no regression was found.
+
+set -e
+
+benchdir=$(cd "$(dirname "$0")" && pwd)
+nev=20000
+workdir=./bench_work
+outdir=
+basedir=
+tolerance=5
+
+usage() {
+  echo "Usage: $0 [-n nevents] [-w workdir] [-o outdir] [-b basedir] [-t percent] [evio] [vdcsim]" >&2
+  exit 1
+}
+
+while getopts "n:w:o:b:t:h" opt; do
+  case $opt in
+    n) nev=$OPTARG ;;
+    w) workdir=$OPTARG ;;
+    o) outdir=$OPTARG ;;
+    b) basedir=$OPTARG ;;
+    t) tolerance=$OPTARG ;;
+    *) usage ;;
+  esac
+done
+shift $((OPTIND-1))
+workloads=${*:-evio}
+
+mkdir -p "$workdir"
+workdir=$(cd "$workdir" && pwd)
+outdir=${outdir:-$workdir/results}
+mkdir -p "$outdir"
+outdir=$(cd "$outdir" && pwd)
+export DB_DIR=${DB_DIR:-$(cd "$benchdir/../DB" && pwd)}
+
+# Run start time of the synthetic runs: 2003-04-16, selects DB/20030415
+runtime=1050451200
+
+status=0
+for w in $workloads; do
+  rundir=$workdir/$w
+  mkdir -p "$rundir"
+  case $w in
+    evio)
+      input=$workdir/bench_evio_$nev.dat
+      if [ ! -f "$input" ]; then
+        evgen -c 2 -n "$nev" -o 0.02 -m 1.2 -x 1 -t $runtime \
+              -d "$benchdir/db_cratemap.dat" "$input"
+      fi
+      ;;
+    vdcsim)
+      input=$workdir/bench_vdcsim_$nev.root
+      if [ ! -f "$input" ]; then
+        vdcsimgen -a "$nev" -x 1 -s "$input" -f "$workdir/trackInfo.data" \
+                  -d "$DB_DIR/20030415/db_L.vdc.dat"
+      fi
+      # THaVDCSimDecoder puts the VDC hits into crate 3, slots 3-11 and
+      # 16-22. Local copy of the VDC database with the detector map moved
+      # there. Files in the current directory take precedence over DB_DIR.
+      awk '/^\[ L\.vdc\.[uv][12] \]/ { n = 4; print; next }
+           n > 0 && $1 == 3 { n--; s = $2 - 3; if( s > 11 ) s += 4; $2 = s }
+           { print }' "$DB_DIR/20030415/db_L.vdc.dat" > "$rundir/db_L.vdc.dat"
+      ;;
+    *)
+      echo "Unknown workload $w" >&2
+      status=1
+      continue
+      ;;
+  esac
+
+  report=$outdir/$w.json
+  rm -f "$report"
+  (cd "$rundir" && replaybench -b -q \
+    "$benchdir/replay_bench.C(\"$w\",\"$input\",\"$report\",$nev)") || true
+  if [ ! -f "$report" ]; then
+    echo "Workload $w: no benchmark report written" >&2
+    status=1
+    continue
+  fi
+  echo "Workload $w: report in $report"
+
+  if [ -n "$basedir" ]; then
+    if [ -f "$basedir/$w.json" ]; then
+      python3 "$benchdir/compare_bench.py" -t "$tolerance" \
+              "$basedir/$w.json" "$report" || status=1
+    else
+      echo "Workload $w: no baseline $basedir/$w.json" >&2
+    fi
+  fi
+done
+
+exit $status
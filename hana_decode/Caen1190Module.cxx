@@ -70,14 +70,76 @@ UInt_t Caen1190Module::LoadSlot( THaSlotData* sldat, const UInt_t* evbuffer,
   // Read until out of data or until Decode() says that the slot is finished.
   // len = ndata in event, pos = word number for block header in event
 
-  fSlotData = sldat;    // Used in Decode()
+  if( sldat != fSlotData ) {
+    fSlotData = sldat;    // Used in Decode()
+    // Decode() uses the fast hit loading methods, which leave the type alone
+    fSlotData->setDevType("tdc");
+  }
   const auto* p = evbuffer + pos;
-  const auto* const q = p + len;
-  while( p != q ) {
-    if( Decode(p++) != 0 )
+  return fWordsSeen = DecodeBlock(p, p + len) - p;
+}
+
+//_____________________________________________________________________________
+const UInt_t* Caen1190Module::DecodeBlock( const UInt_t* p, const UInt_t* q )
+{
+  // Decode the words in [p,q) up to and including the global trailer
+  // of this slot. The fields of TDC measurement words are extracted for
+  // the entire block at once into the SoA arrays fBlkChan/fBlkTime/fBlkEdge
+  // and passed to fSlotData in one call. All other words go to Decode().
+  // Returns pointer one past the last word decoded.
+
+  const auto n = static_cast<UInt_t>(q - p);
+  if( fBlkChan.size() < n ) {
+    fBlkChan.resize(n);
+    fBlkTime.resize(n);
+    fBlkEdge.resize(n);
+  }
+  UInt_t* chan = fBlkChan.data();
+  UInt_t* time = fBlkTime.data();
+  UInt_t* edge = fBlkEdge.data();
+
+  // Extract data fields from every word. This loop has no branches,
+  // so the compiler can vectorize it.
+  for( UInt_t i = 0; i < n; ++i ) {
+    const UInt_t w = p[i];
+    chan[i] = (w & 0x03f80000) >> 19; // bits 25-19
+    time[i] = w & 0x0007ffff;         // bits 18-0
+    edge[i] = (w & 0x04000000) >> 26; // bit 26
+  }
+
+  // Keep measurements for this slot, compacting the arrays in place.
+  // Headers, trailers etc. are decoded as usual.
+  const UInt_t nchan = fSlotData->getNchan();
+  UInt_t nhits = 0, i = 0;
+  while( i < n ) {
+    if( (p[i] >> 27) == kTDCData ) {
+      chan[nhits] = chan[i];
+      time[nhits] = time[i];
+      edge[nhits] = edge[i];
+      nhits += (tdc_data.glb_hdr_slno == fSlot && chan[i] < nchan);
+#ifdef WITH_DEBUG
+      if( fDebugFile )
+        *fDebugFile << "Caen1190Module:: 1190 MEASURED DATA >> data = "
+                    << hex << p[i] << " >> channel = " << dec
+                    << chan[i] << " >> edge = "
+                    << edge[i] << " >> raw time = "
+                    << time[i] << endl;
+#endif
+    } else if( Decode(p + i) != 0 ) {
+      ++i;
       break;  // global trailer found
+    }
+    ++i;
+  }
+
+  fSlotData->loadHitBlock(nhits, chan, time, edge);
+  for( UInt_t k = 0; k < nhits; ++k ) {
+    if( fNumHits[chan[k]] < MAXHIT ) {
+      fTdcData[chan[k] * MAXHIT + fNumHits[chan[k]]] = time[k];
+      fTdcOpt[chan[k] * MAXHIT + fNumHits[chan[k]]++] = edge[k];
+    }
   }
-  return fWordsSeen = p - (evbuffer + pos);
+  return p + i;
 }
 
 //_____________________________________________________________________________
@@ -122,7 +184,11 @@ Int_t Caen1190Module::Decode( const UInt_t* p )
         tdc_data.chan = (*p & 0x03f80000) >> 19; // bits 25-19
         tdc_data.raw = *p & 0x0007ffff;      // bits 18-0
         tdc_data.opt = (*p & 0x04000000) >> 26;      // bit 26
-        tdc_data.status = fSlotData->loadData("tdc", tdc_data.chan, tdc_data.raw, tdc_data.opt);
+        if( tdc_data.chan < fSlotData->getNchan() ) {
+          fSlotData->pushHit(tdc_data.chan, tdc_data.raw, tdc_data.opt);
+          tdc_data.status = SD_OK;
+        } else
+          tdc_data.status = SD_WARN;
 #ifdef WITH_DEBUG
         if( fDebugFile )
           *fDebugFile << "Caen1190Module:: 1190 MEASURED DATA >> data = "
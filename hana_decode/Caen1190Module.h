@@ -44,6 +44,7 @@ public:
 
 private:
   virtual UInt_t LoadNextEvBuffer( THaSlotData* sldat );
+  const UInt_t* DecodeBlock( const UInt_t* p, const UInt_t* q );
   std::string Here( const char* function );
 
   enum EDataType {
@@ -56,6 +57,9 @@ private:
   std::vector<UInt_t> fNumHits;
   std::vector<UInt_t> fTdcData; // Raw data
   std::vector<UInt_t> fTdcOpt;  // Edge flag =0 Leading edge, = 1 Trailing edge
+  std::vector<UInt_t> fBlkChan; // Block decoding scratch: channel numbers
+  std::vector<UInt_t> fBlkTime; //  ... measured times
+  std::vector<UInt_t> fBlkEdge; //  ... edge flags
 
   THaSlotData*  fSlotData; // Need to fix if multi-threading becomes available
   const UInt_t* fEvBuf;    // Pointer to current event buffer (for multi-block)
@@ -10,6 +10,7 @@
 #include "CodaDecoder.h"
 #include "THaCrateMap.h"
 #include "THaBenchmark.h"
+#include "THaTimelineTrace.h"
 #include "THaUsrstrutils.h"
 #include "DAQconfig.h"
 #include "Helper.h"
@@ -43,6 +44,7 @@ CodaDecoder::CodaDecoder()
   , blkidx(0)
   , fMultiBlockMode{false}
   , fBlockIsDone{false}
+  , fPhysDecoded{false}
   , tsEvType{0}
   , bank_tag{0}
   , block_size{0}
@@ -204,6 +206,59 @@ Int_t CodaDecoder::LoadEvent( const UInt_t* evbuffer )
   return ret;
 }
 
+//_____________________________________________________________________________
+Int_t CodaDecoder::PreDecode( const UInt_t* evbuffer )
+{
+  // Extract event type, event number, trigger bits and event time, and,
+  // for physics events, locate the ROC data banks in 'evbuffer' without
+  // decoding any modules. This is enough for GetRocLength(), GetRawData()
+  // and friends. A subsequent LoadEvent() for the same buffer repeats
+  // these steps.
+  //
+  // Multiblock data cannot be pre-decoded since the header information
+  // refers to the entire block. As multiblock mode is only detected while
+  // decoding the modules, pre-decoding is refused until at least one
+  // physics event has been decoded in full.
+
+  assert(evbuffer);
+
+  if( fDataVersion != 2 && fDataVersion != 3 )
+    return HED_WARN;  // LoadEvent will complain
+  if( DataCached() || fMultiBlockMode || !fPhysDecoded )
+    return HED_WARN;
+
+  buffer = evbuffer;
+  event_length = evbuffer[0]+1;
+  event_type = 0;
+  data_type = 0;
+  trigger_bits = 0;
+  evt_time = 0;
+  blkidx = 0;
+
+  if( fDataVersion == 2 ) {
+    event_type = evbuffer[1]>>16;
+  } else {
+    interpretCoda3(evbuffer);
+  }
+  if( event_type == 0 || event_type > MAX_PHYS_EVTYPE )
+    return HED_OK;
+
+  Int_t ret = HED_OK;
+  if( fDataVersion == 3 ) {
+    if( block_size > 1 )
+      return HED_WARN;
+    if( (ret = trigBankDecode(evbuffer)) != HED_OK )
+      return ret;
+    event_num = tbank.evtNum;
+    if( FindRocsCoda3(evbuffer) == HED_ERR )
+      return HED_ERR;
+  } else {
+    event_num = evbuffer[4];
+    ret = FindRocs(evbuffer);
+  }
+  return ret;
+}
+
 //_____________________________________________________________________________
 Int_t CodaDecoder::physics_decode( const UInt_t* evbuffer )
 {
@@ -260,6 +315,7 @@ Int_t CodaDecoder::physics_decode( const UInt_t* evbuffer )
                     << iroc << "  " << ipt << "  " << iptmax
                     << endl;
       try {
+        THaTimelineTrace::Span span("bank_decode", "decode", "roc", iroc);
         status = bank_decode(iroc, evbuffer, ipt, iptmax);
       }
       catch( const logic_error& e ) {
@@ -277,6 +333,7 @@ Int_t CodaDecoder::physics_decode( const UInt_t* evbuffer )
                     << endl;
 
       try {
+        THaTimelineTrace::Span span("roc_decode", "decode", "roc", iroc);
         status = roc_decode(iroc, evbuffer, ipt, iptmax);
       }
       catch( const logic_error& e ) {
@@ -287,6 +344,8 @@ Int_t CodaDecoder::physics_decode( const UInt_t* evbuffer )
         return status;
     }
   }
+  fPhysDecoded = true;
+
   // Print summary of discovered banks
   constexpr UInt_t bankinfo_bit = 65;
   if( !fMsgPrinted.TestBitNumber(bankinfo_bit) ) {
@@ -1355,7 +1414,28 @@ int CodaDecoder::init_slotdata()
     *fDebugFile << "CodaDecode:: fNSlotUsed "<<fSlotUsed.size()<<endl;
 
   // Update lists of used/clearable slots in case crate map changed
-  return THaEvData::init_slotdata();
+  Int_t ret = THaEvData::init_slotdata();
+  for( auto i : fSlotUsed )
+    crateslot[i]->SetBlockCache(BlockCacheEnabled());
+  return ret;
+}
+
+//_____________________________________________________________________________
+void CodaDecoder::EnableBlockCache( Bool_t enable )
+{
+  // Enable/disable block caching for multiblock data. If enabled, each
+  // multiblock module decodes all events of a block when the first event
+  // of the block is loaded. The hits of the remaining events are then
+  // served from a per-slot cache, which avoids re-entering the module
+  // decoders for every event.
+  //
+  // Only use this if detectors get their data via GetData() and friends.
+  // Data retrieved directly from module objects (GetModule()) refer to the
+  // last event of the block when caching is enabled.
+
+  SetBit(kBlockCache, enable);
+  for( auto i : fSlotUsed )
+    crateslot[i]->SetBlockCache(enable);
 }
 
 
@@ -26,6 +26,7 @@ public:
   virtual Int_t  Init();
 
   virtual Int_t  LoadEvent(const UInt_t* evbuffer);
+  virtual Int_t  PreDecode(const UInt_t* evbuffer);
 
   virtual UInt_t GetPrescaleFactor( UInt_t trigger ) const;
   virtual void   SetRunTime( ULong64_t tloc );
@@ -37,6 +38,8 @@ public:
   virtual Int_t  LoadFromMultiBlock();
           Bool_t IsMultiBlockMode() const { return fMultiBlockMode; };
           Bool_t BlockIsDone() const { return fBlockIsDone; };
+          void   EnableBlockCache( Bool_t enable=true );
+          Bool_t BlockCacheEnabled() const { return TestBit(kBlockCache); }
 
   virtual Int_t  FillBankData( UInt_t* rdat, UInt_t roc, Int_t bank,
                                UInt_t offset = 0, UInt_t num = 1 ) const;
@@ -85,6 +88,10 @@ public:
   }
 
 protected:
+  enum {
+    kBlockCache = BIT(17)  // Decode multiblock buffers in one go
+  };
+
   virtual Int_t  LoadIfFlagData(const UInt_t* evbuffer);
 
   Int_t FindRocs(const UInt_t *evbuffer);  // CODA2 version
@@ -132,6 +139,7 @@ protected:
   // CODA3 stuff
   UInt_t blkidx;  // Event block index (0 <= blkidx < block_size)
   Bool_t fMultiBlockMode, fBlockIsDone;
+  Bool_t fPhysDecoded;  // At least one physics event fully decoded
   UInt_t tsEvType, bank_tag, block_size;
 
 public:
@@ -52,6 +52,7 @@ namespace Decoder {
   static const UInt_t SCALER_EVTYPE    = 140;
   static const UInt_t SBSSCALER_EVTYPE = 141;
   static const UInt_t HV_DATA_EVTYPE   = 150;
+  static const UInt_t MAX_EVTYPE       = 255; // Largest type in dispatch tables
 
   // Access processed data for multi-function modules
   enum EModuleType { kSampleADC, kPulseIntegral, kPulseTime,
@@ -106,67 +106,89 @@ UInt_t F1TDCModule::LoadSlot( THaSlotData *sldat, const UInt_t *evbuffer,
    const UInt_t F1_RES_LOCK = BIT(26); // good
    const UInt_t DATA_CHK = F1_HIT_OFLW | F1_OUT_OFLW | F1_RES_LOCK;
    const UInt_t DATA_MARKER = BIT(23);
-   // look at all the data
-   const UInt_t *loc = evbuffer;
+   // loadHitBlock() below does not set the device type
+   if( !*sldat->devType() )
+     sldat->setDevType("tdc");
 #ifdef WITH_DEBUG
    if(fDebug > 1 && fDebugFile)
      *fDebugFile<< "Debug of F1TDC data, fResol =  "<<fResol<<"  model num  "<<fModelNum<<endl;
 #endif
-   while ( loc <= pstop && IsSlot(*loc) ) {
-     if ( !( (*loc) & DATA_MARKER ) ) {
-       // header/trailer word, to be ignored
+   // Find the end of this slot's data
+   const UInt_t *loc = evbuffer;
+   while ( loc <= pstop && IsSlot(*loc) )
+     loc++;
+   const auto n = static_cast<UInt_t>(loc - evbuffer);
+   if( fBlkChan.size() < n ) {
+     fBlkChan.resize(n);
+     fBlkRaw.resize(n);
+   }
+   UInt_t* chan = fBlkChan.data();
+   UInt_t* raw  = fBlkRaw.data();
+
+   // Extract channel and time from all words of the block. These loops
+   // have no branches, so the compiler can vectorize them.
+   if( IsHiResolution() ) {
+     for( UInt_t i = 0; i < n; i++ ) {
+       // drop last bit for channel renumbering
+       chan[i] = (evbuffer[i] >> 17) & 0x1f;
+       raw[i]  = evbuffer[i] & 0xffff;
+     }
+   } else {
+     for( UInt_t i = 0; i < n; i++ ) {
+       // do the reordering of the channels, for contiguous groups
+       // odd numbered TDC channels from the board -> +16
+       UInt_t ch = (evbuffer[i] >> 16) & 0x3f;  // internal channel number
+       chan[i] = (ch & 0x20) + ((ch & 0x01) << 4) + ((ch & 0x1e) >> 1);
+       raw[i]  = evbuffer[i] & 0xffff;
+     }
+   }
+
+   // Keep the data words, compacting the arrays in place.
+   // Header/trailer words are ignored.
+   const UInt_t nchan = sldat->getNchan();
+   UInt_t nhits = 0;
+   for( UInt_t i = 0; i < n; i++ ) {
+     const UInt_t w = evbuffer[i];
+     if ( !(w & DATA_MARKER) ) {
 #ifdef WITH_DEBUG
        if(fDebug > 1 && fDebugFile)
-         *fDebugFile<< "[" << (loc-evbuffer) << "] header/trailer  0x"
-         <<hex<<*loc<<dec<<endl;
-#endif
-     } else {
-       UInt_t chan = ((*loc) >> 16) & 0x3f;  // internal channel number
-#ifdef WITH_DEBUG
-       UInt_t chn = chan; // save original for debug message below
-       if (fDebug > 1 && fDebugFile)
-         *fDebugFile<< "[" << (loc-evbuffer) << "] data            0x"
-         <<hex<<*loc<<dec<<endl;
+         *fDebugFile<< "[" << i << "] header/trailer  0x"
+         <<hex<<w<<dec<<endl;
 #endif
-       if( IsHiResolution() ) {
-         // drop last bit for channel renumbering
-         chan >>= 1;
-       } else {
-         // do the reordering of the channels, for contiguous groups
-         // odd numbered TDC channels from the board -> +16
-         chan = (chan & 0x20) + ((chan & 0x01) << 4) + ((chan & 0x1e) >> 1);
+       continue;
+     }
+     //FIXME: cross-check slot number here
+     if( (w & DATA_CHK) != F1_RES_LOCK ) {
+       UInt_t f1slot = (w & 0xf8000000) >> 27;
+       cout << "\tWarning: F1 TDC " << hex << w << dec;
+       cout << "\tSlot (Ch) = " << f1slot << "(" << chan[i] << ")";
+       if( w & F1_HIT_OFLW ) {
+         cout << "\tHit-FIFO overflow";
        }
-       //FIXME: cross-check slot number here
-       if( ((*loc) & DATA_CHK) != F1_RES_LOCK ) {
-         UInt_t f1slot = ((*loc) & 0xf8000000) >> 27;
-         cout << "\tWarning: F1 TDC " << hex << (*loc) << dec;
-         cout << "\tSlot (Ch) = " << f1slot << "(" << chan << ")";
-         if( (*loc) & F1_HIT_OFLW ) {
-           cout << "\tHit-FIFO overflow";
-         }
-         if( (*loc) & F1_OUT_OFLW ) {
-           cout << "\tOutput FIFO overflow";
-         }
-         if( !((*loc) & F1_RES_LOCK) ) {
-           cout << "\tResolution lock failure!";
-         }
-         cout << endl;
+       if( w & F1_OUT_OFLW ) {
+         cout << "\tOutput FIFO overflow";
        }
-
-       UInt_t raw = (*loc) & 0xffff;
-#ifdef WITH_DEBUG
-       if(fDebug > 1 && fDebugFile) {
-         *fDebugFile<<" int_chn chan data "<<dec<<chn<<"  "<<chan
-             <<"  0x"<<hex<<raw<<dec<<endl;
+       if( !(w & F1_RES_LOCK) ) {
+         cout << "\tResolution lock failure!";
        }
-#endif
-       /*Int_t status = */sldat->loadData("tdc",chan,raw,raw);
-       UInt_t idx = chan * MAXHIT + 0;  // 1 hit per chan ???
-       if( idx < MAXHIT * NTDCCHAN ) fTdcData[idx] = raw;
-       fWordsSeen++;
+       cout << endl;
      }
-     loc++;
+#ifdef WITH_DEBUG
+     if(fDebug > 1 && fDebugFile) {
+       *fDebugFile<< "[" << i << "] data            0x"
+       <<hex<<w<<dec<<endl;
+       *fDebugFile<<" chan data "<<dec<<chan[i]
+       <<"  0x"<<hex<<raw[i]<<dec<<endl;
+     }
+#endif
+     UInt_t idx = chan[i] * MAXHIT + 0;  // 1 hit per chan ???
+     if( idx < MAXHIT * NTDCCHAN ) fTdcData[idx] = raw[i];
+     fWordsSeen++;
+     chan[nhits] = chan[i];
+     raw[nhits]  = raw[i];
+     nhits += (chan[i] < nchan);
    }
+   sldat->loadHitBlock(nhits, chan, raw, raw);
 
   return fWordsSeen;
 }
@@ -50,6 +50,8 @@ private:
    UInt_t fNumHits;
    EResolution fResol;
    std::vector<UInt_t> fTdcData;  // Raw data (either samples or pulse integrals)
+   std::vector<UInt_t> fBlkChan;  // Block decoding scratch: channel numbers
+   std::vector<UInt_t> fBlkRaw;   //  ... measured times
    Bool_t IsInit;
    UInt_t slotmask, chanmask, datamask;
 
@@ -100,6 +100,8 @@ namespace Decoder {
 
     virtual UInt_t GetCrate() const { return fCrate; };
     virtual UInt_t GetSlot()  const { return fSlot; };
+    UInt_t GetHeader()        const { return fHeader; }
+    UInt_t GetHeaderMask()    const { return fHeaderMask; }
 
     virtual void   SetDebugFile( std::ofstream* file )
     {
@@ -29,12 +29,17 @@ Scaler1151.cxx
 Scaler3800.cxx
 Scaler3801.cxx
 Scaler560.cxx
+ShmEventRing.cxx
 THaCodaData.cxx
 THaCodaFile.cxx
 THaCrateMap.cxx
 THaEpics.cxx
 THaEvData.cxx
+THaLatencyHistogram.cxx
+THaPerfCounters.cxx
 THaSlotData.cxx
+THaShmClient.cxx
+THaTimelineTrace.cxx
 THaUsrstrutils.cxx
 VmeModule.cxx
 """
@@ -50,6 +55,9 @@ dcenv.Append(CPPPATH = dcenv.subst('$EVIO_INC'))
 dcenv.Replace(LIBS = [evioname,'PoddDB'],
               LIBPATH = [dcenv.subst('$EVIO_LIB'),dcenv.subst('$HA_DB')],
               RPATH = [dcenv.subst('$EVIO_LIB'),dcenv.subst('$HA_DB')])
+if dcenv['PLATFORM'] == 'posix':
+    # shm_open for ShmEventRing, needed with glibc < 2.17
+    dcenv.Append(LIBS = ['rt'])
 if local_evio:
     dc_install_rpath = []  # analyzer already contains the installation libdir
 else:
@@ -0,0 +1,262 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   ShmEventRing
+//   Ring buffer of CODA events in POSIX shared memory
+//
+//   One producer writes events into a fixed number of slots of fixed
+//   size. Any number of consumers may read them. Consumers do not
+//   hold up the producer: if a consumer falls more than one ring length
+//   behind, the events it missed are lost to it, just as with a
+//   non-blocking ET station.
+//
+//   Each slot carries a sequence number that is odd while the producer
+//   is writing the slot and even once the event is complete. A consumer
+//   checks the sequence number before and after copying an event (see
+//   Peek and IsValid) to detect events overwritten in the meantime.
+//
+//   See THaShmClient for the consumer and apps/shmprod_main.cxx for a
+//   producer that replays a CODA file.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "ShmEventRing.h"
+#include <iostream>
+#include <cstring>
+#include <new>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "Shared memory ring requires plain 64-bit atomics");
+
+namespace Decoder {
+
+//_____________________________________________________________________________
+static inline size_t RoundUp( size_t n, size_t align )
+{
+  return (n + align - 1) / align * align;
+}
+
+//_____________________________________________________________________________
+ShmEventRing::ShmEventRing()
+  : fHeader(nullptr), fSize(0), fStride(0), fOwner(false)
+{
+  // Constructor. Call Create() or Attach() to use the ring.
+}
+
+//_____________________________________________________________________________
+ShmEventRing::~ShmEventRing()
+{
+  // Destructor. The producer removes the shared memory object.
+  // Consumers still attached keep their mapping until they detach.
+
+  Detach();
+}
+
+//_____________________________________________________________________________
+Int_t ShmEventRing::Create( const char* name, UInt_t nslots, UInt_t slotwords,
+                            Int_t coda_version )
+{
+  // Create shared memory object 'name' (e.g. "/podd_ring") holding 'nslots'
+  // events of up to 'slotwords' 32-bit words each, replacing any existing
+  // object of this name. Returns 0 on success, -1 on error.
+
+  Detach();
+  if( !name || !*name || nslots == 0 || slotwords < 2 ) {
+    cerr << "ShmEventRing::Create: invalid arguments" << endl;
+    return -1;
+  }
+  shm_unlink(name);
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+  if( fd < 0 ) {
+    cerr << "ShmEventRing::Create: cannot create " << name << ": "
+         << strerror(errno) << endl;
+    return -1;
+  }
+  fStride = RoundUp(sizeof(SlotHeader) + slotwords * sizeof(UInt_t), 64);
+  fSize = sizeof(Header) + nslots * fStride;
+  void* addr = MAP_FAILED;
+  if( ftruncate(fd, static_cast<off_t>(fSize)) == 0 )
+    addr = mmap(nullptr, fSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int err = errno;
+  close(fd);
+  if( addr == MAP_FAILED ) {
+    cerr << "ShmEventRing::Create: cannot map " << name << ": "
+         << strerror(err) << endl;
+    shm_unlink(name);
+    return -1;
+  }
+  fName = name;
+  fOwner = true;
+  // A new object is zero-filled, so all sequence numbers start out as 0
+  fHeader = new(addr) Header;
+  fHeader->version = kVersion;
+  fHeader->nslots = nslots;
+  fHeader->slotwords = slotwords;
+  fHeader->coda_version = coda_version;
+  fHeader->wpos.store(0);
+  fHeader->eor.store(0);
+  // Written last. Consumers refuse to attach until they see it.
+  std::atomic_thread_fence(std::memory_order_release);
+  fHeader->magic = kMagic;
+  return 0;
+}
+
+//_____________________________________________________________________________
+Int_t ShmEventRing::Attach( const char* name )
+{
+  // Attach to existing ring 'name' for reading.
+  // Returns 0 on success, -1 if the ring does not exist (yet) or is invalid.
+
+  Detach();
+  if( !name || !*name )
+    return -1;
+  int fd = shm_open(name, O_RDONLY, 0);
+  if( fd < 0 )
+    return -1;
+  struct stat st{};
+  void* addr = MAP_FAILED;
+  if( fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header) )
+    addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if( addr == MAP_FAILED )
+    return -1;
+  auto* hdr = static_cast<Header*>(addr);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  size_t stride = RoundUp(sizeof(SlotHeader) + hdr->slotwords * sizeof(UInt_t), 64);
+  if( hdr->magic != kMagic || hdr->version != kVersion ||
+      sizeof(Header) + hdr->nslots * stride > static_cast<size_t>(st.st_size) ) {
+    munmap(addr, st.st_size);
+    return -1;
+  }
+  fName = name;
+  fHeader = hdr;
+  fSize = st.st_size;
+  fStride = stride;
+  fOwner = false;
+  return 0;
+}
+
+//_____________________________________________________________________________
+void ShmEventRing::Detach()
+{
+  // Unmap the ring. The producer also removes the shared memory object.
+
+  if( !fHeader )
+    return;
+  munmap(fHeader, fSize);
+  if( fOwner )
+    shm_unlink(fName.c_str());
+  fHeader = nullptr;
+  fSize = fStride = 0;
+  fOwner = false;
+  fName.clear();
+}
+
+//_____________________________________________________________________________
+ShmEventRing::SlotHeader* ShmEventRing::Slot( ULong64_t seq ) const
+{
+  auto* base = reinterpret_cast<char*>(fHeader) + sizeof(Header);
+  return reinterpret_cast<SlotHeader*>(base + (seq % fHeader->nslots) * fStride);
+}
+
+//_____________________________________________________________________________
+Int_t ShmEventRing::Put( const UInt_t* evbuffer )
+{
+  // Publish the CODA event in 'evbuffer'. Returns 0 on success, -1 if
+  // the event does not fit into a slot or the ring was not created here.
+
+  if( !fHeader || !fOwner )
+    return -1;
+  UInt_t len = evbuffer[0] + 1;
+  if( len > fHeader->slotwords )
+    return -1;
+  ULong64_t seq = fHeader->wpos.load(std::memory_order_relaxed);
+  SlotHeader* slot = Slot(seq);
+  slot->seq.store(2*seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->len = len;
+  memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), evbuffer,
+         len * sizeof(UInt_t));
+  slot->seq.store(2*seq + 2, std::memory_order_release);
+  fHeader->wpos.store(seq + 1, std::memory_order_release);
+  return 0;
+}
+
+//_____________________________________________________________________________
+void ShmEventRing::SetEndOfRun()
+{
+  // Tell consumers that no more events will follow
+  if( fHeader && fOwner )
+    fHeader->eor.store(1, std::memory_order_release);
+}
+
+//_____________________________________________________________________________
+const UInt_t* ShmEventRing::Peek( ULong64_t seq, UInt_t& len ) const
+{
+  // Return pointer to the data of event number 'seq' in shared memory and
+  // set 'len' to its length. Returns nullptr if this event has not been
+  // published yet or has already been overwritten. After copying the data,
+  // call IsValid(seq) to make sure the producer did not overwrite the
+  // event while it was being copied.
+
+  len = 0;
+  if( !fHeader || seq >= GetWritePos() )
+    return nullptr;
+  const SlotHeader* slot = Slot(seq);
+  if( slot->seq.load(std::memory_order_acquire) != 2*seq + 2 )
+    return nullptr;
+  len = slot->len;
+  if( len > fHeader->slotwords )
+    return nullptr;
+  return reinterpret_cast<const UInt_t*>(
+    reinterpret_cast<const char*>(slot) + sizeof(SlotHeader));
+}
+
+//_____________________________________________________________________________
+Bool_t ShmEventRing::IsValid( ULong64_t seq ) const
+{
+  // Check that the slot of event 'seq' still holds that event
+  if( !fHeader )
+    return false;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return Slot(seq)->seq.load(std::memory_order_relaxed) == 2*seq + 2;
+}
+
+//_____________________________________________________________________________
+Bool_t ShmEventRing::IsEndOfRun() const
+{
+  return fHeader && fHeader->eor.load(std::memory_order_acquire) != 0;
+}
+
+//_____________________________________________________________________________
+ULong64_t ShmEventRing::GetWritePos() const
+{
+  // Number of events published so far
+  return fHeader ? fHeader->wpos.load(std::memory_order_acquire) : 0;
+}
+
+//_____________________________________________________________________________
+UInt_t ShmEventRing::GetNslots() const
+{
+  return fHeader ? fHeader->nslots : 0;
+}
+
+//_____________________________________________________________________________
+UInt_t ShmEventRing::GetSlotWords() const
+{
+  return fHeader ? fHeader->slotwords : 0;
+}
+
+//_____________________________________________________________________________
+Int_t ShmEventRing::GetCodaVersion() const
+{
+  return fHeader ? fHeader->coda_version : 0;
+}
+
+} // namespace Decoder
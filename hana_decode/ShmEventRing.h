@@ -0,0 +1,81 @@
+#ifndef Podd_ShmEventRing_h_
+#define Podd_ShmEventRing_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   ShmEventRing
+//   Ring buffer of CODA events in POSIX shared memory
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Decoder {
+
+class ShmEventRing {
+
+public:
+  ShmEventRing();
+  ShmEventRing( const ShmEventRing& ) = delete;
+  ShmEventRing& operator=( const ShmEventRing& ) = delete;
+  ~ShmEventRing();
+
+  // Producer side
+  Int_t  Create( const char* name, UInt_t nslots, UInt_t slotwords,
+                 Int_t coda_version );
+  Int_t  Put( const UInt_t* evbuffer );
+  void   SetEndOfRun();
+
+  // Consumer side
+  Int_t  Attach( const char* name );
+  const UInt_t* Peek( ULong64_t seq, UInt_t& len ) const;
+  Bool_t IsValid( ULong64_t seq ) const;
+  Bool_t IsEndOfRun() const;
+
+  void   Detach();
+  Bool_t IsAttached() const { return fHeader != nullptr; }
+
+  ULong64_t GetWritePos()    const;
+  UInt_t    GetNslots()      const;
+  UInt_t    GetSlotWords()   const;
+  Int_t     GetCodaVersion() const;
+  const char* GetName()      const { return fName.c_str(); }
+
+  static const UInt_t kMagic   = 0x52455650; // Identifies a ring segment
+  static const UInt_t kVersion = 1;
+
+private:
+  // Layout of the shared memory segment. The header is followed by
+  // nslots slots, each consisting of a SlotHeader and slotwords data words.
+  struct alignas(64) Header {
+    uint32_t magic;          // kMagic
+    uint32_t version;        // kVersion
+    uint32_t nslots;         // Number of event slots
+    uint32_t slotwords;      // Capacity of each slot (32-bit words)
+    int32_t  coda_version;   // CODA version of the events
+    uint32_t reserved;
+    std::atomic<uint64_t> wpos; // Number of events published
+    std::atomic<uint32_t> eor;  // Set by producer at end of run
+  };
+  struct alignas(8) SlotHeader {
+    std::atomic<uint64_t> seq; // 2*event+1 while writing, 2*event+2 when done
+    uint32_t len;              // Event length (words)
+    uint32_t reserved;
+  };
+
+  std::string fName;       // Name of shared memory object
+  Header*     fHeader;     // Start of mapped segment
+  size_t      fSize;       // Size of mapped segment (bytes)
+  size_t      fStride;     // Size of one slot (bytes)
+  Bool_t      fOwner;      // We created the segment (producer)
+
+  SlotHeader* Slot( ULong64_t seq ) const;
+};
+
+} // namespace Decoder
+
+#endif
@@ -6,21 +6,37 @@
 // THaBenchmark utility class
 //
 // Provides start/stop mode for ROOT's TBenchmark class
+//
+// With EnableLatency(), the duration of each individual Begin/Stop
+// interval is also recorded in a THaLatencyHistogram, from which
+// percentiles can be obtained. If the program counts memory allocations
+// and has registered a counter function via SetAllocCounter(), the
+// number of allocations within the intervals is recorded as well.
+//
+// With SetPerfCounters(), the hardware performance counters (cycles,
+// instructions, cache and branch misses) are read at Begin and Stop,
+// and their increments accumulated per benchmark.
 //_____________________________________________________________________________
 
 #include "TBenchmark.h"
 #include "TMath.h"
+#include "THaLatencyHistogram.h"
+#include "THaPerfCounters.h"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <vector>
+#include <chrono>
 
 //_____________________________________________________________________________
 class THaBenchmark : public TBenchmark {
 public:
-  THaBenchmark() { fNmax = 50; }
+  THaBenchmark() : fDoLatency(false), fPerf(nullptr) { fNmax = 50; }
   virtual ~THaBenchmark() = default;
 
+  // Function returning the number of memory allocations made so far
+  typedef ULong64_t (*AllocCounter_t)();
+
   virtual void Begin(const char *name) {
     if (!fNbench)
       TBenchmark::Start(name);
@@ -33,6 +49,102 @@ public:
       else
         Warning("Start","too many benches");
     }
+    if( fDoLatency ) {
+      Int_t bench = GetBench(name);
+      if( bench >= 0 ) {
+        AllocCounter_t counter = GetAllocCounter();
+        fAlloc0[bench] = counter ? counter() : 0;
+        fT0[bench] = Now();
+      }
+    }
+    if( fPerf ) {
+      Int_t bench = GetBench(name);
+      if( bench >= 0 )
+        fPerf->Read(fPerf0[bench]);
+    }
+  }
+
+  virtual void Stop(const char *name) {
+    if( fPerf ) {
+      Int_t bench = GetBench(name);
+      if( bench >= 0 ) {
+        THaPerfCounters::Sample_t now;
+        fPerf->Read(now);
+        fPerfSum[bench].Add(fPerf0[bench], now);
+      }
+    }
+    TBenchmark::Stop(name);
+    if( fDoLatency ) {
+      Int_t bench = GetBench(name);
+      if( bench >= 0 && fT0[bench] != 0 ) {
+        fLatency[bench].Fill(Now() - fT0[bench]);
+        fT0[bench] = 0;
+        if( AllocCounter_t counter = GetAllocCounter() )
+          fAllocs[bench] += counter() - fAlloc0[bench];
+      }
+    }
+  }
+
+  virtual void Reset() {
+    TBenchmark::Reset();
+    for( auto& h : fLatency ) h.Reset();
+    fT0.assign(fT0.size(), 0);
+    fAllocs.assign(fAllocs.size(), 0);
+    fPerfSum.assign(fPerfSum.size(), THaPerfCounters::Sum_t());
+  }
+
+  void EnableLatency( Bool_t enable = true ) {
+    fDoLatency = enable;
+    if( fDoLatency && fLatency.empty() ) {
+      fLatency.resize(fNmax);
+      fT0.assign(fNmax, 0);
+      fAlloc0.assign(fNmax, 0);
+      fAllocs.assign(fNmax, 0);
+    }
+  }
+  Bool_t LatencyEnabled() const { return fDoLatency; }
+
+  // Read the hardware counters 'pc' in each interval. The counters must
+  // be open and measure the thread calling Begin/Stop. nullptr disables.
+  void SetPerfCounters( THaPerfCounters* pc ) {
+    fPerf = (pc && pc->IsOpen()) ? pc : nullptr;
+    if( fPerf && fPerfSum.empty() ) {
+      fPerf0.resize(fNmax);
+      fPerfSum.resize(fNmax);
+    }
+  }
+  THaPerfCounters* GetPerfCounters() const { return fPerf; }
+
+  // Histogram of the durations of the intervals of benchmark 'name'.
+  // nullptr if latency recording was never enabled or 'name' is unknown.
+  const THaLatencyHistogram* GetLatency(const char *name) const {
+    Int_t bench = GetBench(name);
+    if( bench < 0 || fLatency.empty() ) return nullptr;
+    return &fLatency[bench];
+  }
+  // Number of allocations within the intervals of benchmark 'name'
+  ULong64_t GetAllocations(const char *name) const {
+    Int_t bench = GetBench(name);
+    if( bench < 0 || fAllocs.empty() ) return 0;
+    return fAllocs[bench];
+  }
+  // Hardware counts within the intervals of benchmark 'name'.
+  // nullptr if counters were never set or 'name' is unknown.
+  const THaPerfCounters::Sum_t* GetPerfCounts(const char *name) const {
+    Int_t bench = GetBench(name);
+    if( bench < 0 || fPerfSum.empty() ) return nullptr;
+    return &fPerfSum[bench];
+  }
+
+  // Register the allocation counter. Set by programs that replace the
+  // global operator new to count allocations, e.g. replaybench.
+  static void SetAllocCounter( AllocCounter_t f ) { AllocCounterRef() = f; }
+  static AllocCounter_t GetAllocCounter() { return AllocCounterRef(); }
+
+  // Monotonic time in ns
+  static ULong64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
   }
 
   void PrintByName(const std::vector<TString>& names) const {
@@ -53,6 +165,20 @@ public:
   }
 
 private:
+  Bool_t fDoLatency;                           //! Record latency histograms
+  std::vector<THaLatencyHistogram> fLatency;   //! Interval durations
+  std::vector<ULong64_t> fT0;                  //! Start of current interval
+  std::vector<ULong64_t> fAlloc0;              //! Allocations at start
+  std::vector<ULong64_t> fAllocs;              //! Allocations in intervals
+  THaPerfCounters*       fPerf;                //! Hardware counters (not owned)
+  std::vector<THaPerfCounters::Sample_t> fPerf0;   //! Counts at start
+  std::vector<THaPerfCounters::Sum_t>    fPerfSum; //! Counts in intervals
+
+  static AllocCounter_t& AllocCounterRef() {
+    static AllocCounter_t counter = nullptr;
+    return counter;
+  }
+
   void PrintBenchmark( const char* name, int width = 10 ) const {
     auto fmt =  std::cout.flags();
     auto prec = std::cout.precision();
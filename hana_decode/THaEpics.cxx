@@ -11,9 +11,16 @@
 //   All data are received as characters and are parsed.
 //   'tags' remain characters, 'values' are either character 
 //   or double, and 'units' are characters.
-//   Data are stored in an STL map and retrievable by
-//   'tag' (e.g. IPM1H04B.XPOS) and by proximity to
-//   a physics event number (closest one is picked).
+//   Data are retrievable by 'tag' (e.g. IPM1H04B.XPOS) and by
+//   proximity to a physics event number (closest one is picked).
+//
+//   Each tag is interned once and identified by a handle (an index).
+//   The readings of a tag are kept in a contiguous array ordered by
+//   event number, so lookups by event use a binary search. Strings
+//   (values, units, dates) live in a single pool and are referenced by
+//   offset. Clients that access the same tags repeatedly should obtain
+//   handles with GetHandle() once and use the handle-based accessors,
+//   which involve no string lookups or copies.
 //
 //   Replaces THaEpicsStack (obsolete)
 //
@@ -25,6 +32,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <algorithm>
 #ifdef __GLIBC__
 #include "Textvars.h"   // for Podd::Tokenize
 #endif
@@ -36,14 +44,13 @@ static int DEBUGL = 0;  // FIXME: -> fDebug member variable
 namespace Decoder {
 
 //_____________________________________________________________________________
-void EpicsChan::MakeTime()
+static time_t ParseEpicsTime( const string& dtime )
 {
   // Convert dtime string (formatted as "%a %b %e %H:%M:%S %Z %Y", see
-  // strftime(3)) to Unix time.
+  // strftime(3)) to Unix time. Returns -1 on error.
 
   struct tm ts{};
   string dt{dtime};
-  timestamp = -1;
 #ifdef __GLIBC__
   // Simple workaround for lack of time zone support in Linux's strptime.
   // This assumes that the current machine's local time zone is the same as
@@ -54,7 +61,7 @@ void EpicsChan::MakeTime()
   vector<string> tok;
   Podd::Tokenize(dtime, " ", tok);
   if( tok.size() != 6 )
-    return;
+    return -1;
   dt = tok[0]+" "+tok[1]+" "+tok[2]+" "+tok[3]+" "+tok[5];
   const char* r = strptime(dt.c_str(), "%a %b %e %H:%M:%S %Y", &ts);
   ts.tm_isdst = -1;
@@ -62,8 +69,16 @@ void EpicsChan::MakeTime()
   const char* r = strptime(dt.c_str(), "%a %b %e %H:%M:%S %Z %Y", &ts);
 #endif
   if( !r || r-dt.c_str()-dt.length() != 0 )
-    return;
-  timestamp = mktime(&ts);
+    return -1;
+  return mktime(&ts);
+}
+
+//_____________________________________________________________________________
+void EpicsChan::MakeTime()
+{
+  // Convert dtime string to Unix time
+
+  timestamp = ParseEpicsTime(dtime);
 }
 
 //_____________________________________________________________________________
@@ -72,91 +87,157 @@ void THaEpics::Print()
   cout << "\n\n====================== \n";
   cout << "Print of Epics Data : "<<endl;
   Int_t j = 0;
-  for( auto& pm : epicsData ) {
-    const vector<EpicsChan>& vepics = pm.second;
+  for( const auto& pm : fTagIndex ) {
+    const Channel_t& ch = fChan[pm.second];
     const string& tag = pm.first;
     j++;
     cout << "\n\nEpics Var #" << j;
     cout << "   Var Name =  \""<<tag<<"\""<<endl;
-    cout << "Size of epics vector "<<vepics.size();
-    for( const auto& chan : vepics ) {
-      cout << "\n Tag = " << chan.GetTag();
-      cout << "   Evnum = " << chan.GetEvNum();
-      cout << "   Date = " << chan.GetDate();
-      cout << "   Timestamp = " << chan.GetTimeStamp();
-      cout << "   Data = " << chan.GetData();
-      cout << "   String = " << chan.GetString();
-      cout << "   Units = " << chan.GetUnits();
+    cout << "Size of epics vector "<<ch.entries.size();
+    for( const auto& e : ch.entries ) {
+      cout << "\n Tag = " << tag;
+      cout << "   Evnum = " << e.evnum;
+      cout << "   Date = " << &fStrings[e.doff];
+      cout << "   Timestamp = " << e.timestamp;
+      cout << "   Data = " << e.dvalue;
+      cout << "   String = " << &fStrings[e.soff];
+      cout << "   Units = " << &fStrings[e.uoff];
     }
     cout << endl;
   }
 }
 
+//_____________________________________________________________________________
+THaEpics::Handle_t THaEpics::GetHandle( const char* tag )
+{
+  // Return the handle for 'tag'. If the tag is not yet known, it is
+  // added without data, so that data arriving later can be accessed
+  // with the same handle.
+
+  auto ins = fTagIndex.emplace(tag, fChan.size());
+  if( ins.second )
+    fChan.emplace_back(ins.first->first);
+  return ins.first->second;
+}
+
+//_____________________________________________________________________________
+THaEpics::Handle_t THaEpics::FindHandle( const char* tag ) const
+{
+  // Return the handle for 'tag', or kNoHandle if the tag is unknown
+
+  auto pm = fTagIndex.find(tag);
+  return ( pm != fTagIndex.end() ) ? pm->second : kNoHandle;
+}
+
+//_____________________________________________________________________________
+const char* THaEpics::GetTag( Handle_t h ) const
+{
+  return ( h < fChan.size() ) ? fChan[h].tag.c_str() : "";
+}
+
 //_____________________________________________________________________________
 Bool_t THaEpics::IsLoaded(const char* tag) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  return !ep.empty();
+  return IsLoaded(FindHandle(tag));
 }
 
 //_____________________________________________________________________________
 Double_t THaEpics::GetData ( const char* tag, UInt_t event) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return 0;
-  return ep[k].GetData();
+  return GetData(FindHandle(tag), event);
 }
 
 //_____________________________________________________________________________
 string THaEpics::GetString ( const char* tag, UInt_t event) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return "";
-  return ep[k].GetString();
+  return GetCString(FindHandle(tag), event);
 }
 
 //_____________________________________________________________________________
 time_t THaEpics::GetTimeStamp( const char* tag, UInt_t event) const
 {
-  const vector<EpicsChan> ep = GetChan(tag);
-  UInt_t k = FindEvent(ep, event);
-  if( k == kMaxUInt ) return 0;
-  return ep[k].GetTimeStamp();
+  return GetTimeStamp(FindHandle(tag), event);
 }
 
 //_____________________________________________________________________________
-vector<EpicsChan> THaEpics::GetChan(const char *tag) const
+Double_t THaEpics::GetData( Handle_t h, UInt_t event ) const
 {
-  // Return the vector of Epics data for 'tag' 
-  // where 'tag' is the name of the Epics variable.
-  auto pm = epicsData.find(string(tag));
-  if (pm != epicsData.end())
-    return pm->second;
-  else
-    return {};
+  // Value of tag 'h' nearest 'event'. 0 if not loaded.
+
+  const Entry_t* e = FindEntry(h, event);
+  return e ? e->dvalue : 0;
+}
+
+//_____________________________________________________________________________
+const char* THaEpics::GetCString( Handle_t h, UInt_t event ) const
+{
+  // String value of tag 'h' nearest 'event'. Empty if not loaded.
+  // The pointer is valid until the next call to LoadData().
+
+  const Entry_t* e = FindEntry(h, event);
+  return e ? &fStrings[e->soff] : "";
 }
 
 //_____________________________________________________________________________
-UInt_t THaEpics::FindEvent( const vector<EpicsChan>& ep, UInt_t event )
+time_t THaEpics::GetTimeStamp( Handle_t h, UInt_t event ) const
 {
-  // Return the index in the vector of Epics data 
-  // nearest in event number to event 'event'.
-  if (ep.empty())
-    return kMaxUInt;
+  const Entry_t* e = FindEntry(h, event);
+  return e ? e->timestamp : 0;
+}
+
+//_____________________________________________________________________________
+const THaEpics::Entry_t* THaEpics::FindEntry( Handle_t h, UInt_t event ) const
+{
+  if( !IsLoaded(h) )
+    return nullptr;
+  const Channel_t& ch = fChan[h];
+  return &ch.entries[FindEvent(ch, event)];
+}
+
+//_____________________________________________________________________________
+UInt_t THaEpics::FindEvent( const Channel_t& ch, UInt_t event )
+{
+  // Return the index of the entry of 'ch' nearest in event number to
+  // event 'event'. For equal distances, the earliest entry wins.
+  // event = 0 returns the most recent entry. 'ch' must not be empty.
+
+  const auto& ep = ch.entries;
   UInt_t myidx = ep.size()-1;
-  if (event == 0) return myidx;  // return last event 
-  Long64_t min = 9999999;
-  for( size_t k = 0; k < ep.size(); k++ ) {
-    Long64_t diff = event - ep[k].GetEvNum();
-    if( diff < 0 ) diff = -diff;
-    if( diff < min ) {
-      min = diff;
-      myidx = k;
+  if (event == 0) return myidx;  // return last event
+  auto dist = [event]( UInt_t ev ) -> UInt_t {
+    return (ev > event) ? ev - event : event - ev;
+  };
+  if( !ch.sorted ) {
+    // Event numbers went backwards at some point (e.g. new run),
+    // so fall back to a linear search
+    UInt_t min = kMaxUInt;
+    for( size_t k = 0; k < ep.size(); k++ ) {
+      UInt_t diff = dist(ep[k].evnum);
+      if( diff < min ) {
+        min = diff;
+        myidx = k;
+      }
     }
+    return myidx;
+  }
+  auto before = []( const Entry_t& e, UInt_t ev ) { return e.evnum < ev; };
+  auto it = lower_bound(ep.begin(), ep.end(), event, before);
+  if( it != ep.begin() ) {
+    auto lo = lower_bound(ep.begin(), it, (it-1)->evnum, before);
+    if( it == ep.end() || dist(lo->evnum) <= dist(it->evnum) )
+      it = lo;
   }
-  return myidx;
+  return it - ep.begin();
+}
+
+//_____________________________________________________________________________
+UInt_t THaEpics::AddString( const string& str )
+{
+  // Append 'str' to the string pool and return its offset
+
+  auto off = static_cast<UInt_t>(fStrings.size());
+  fStrings.append(str.c_str(), str.size()+1);
+  return off;
 }
 
 //_____________________________________________________________________________
@@ -186,6 +267,9 @@ int THaEpics::LoadData( const UInt_t* evbuffer, UInt_t event)
     return 0;
   }
   if(DEBUGL>1) cout << "Timestamp: " << date <<endl;
+  // The date is the same for all tags in this event
+  UInt_t doff = AddString(date);
+  time_t timestamp = ParseEpicsTime(date);
 
   string line;
   istringstream il, iv;
@@ -217,8 +301,17 @@ int THaEpics::LoadData( const UInt_t* evbuffer, UInt_t event)
     if(DEBUGL>2) cout << "wtag = "<<wtag<<"   wval = "<<wval
 		      << "   dval = "<<dval<<"   wunits = "<<wunits<<endl;
 
-    // Add tag/value/units to the EPICS data.    
-    epicsData[wtag].push_back( EpicsChan(wtag, date, event, wval, wunits, dval) );
+    // Add tag/value/units to the EPICS data.
+    Channel_t& ch = fChan[GetHandle(wtag.c_str())];
+    if( !ch.entries.empty() && event < ch.entries.back().evnum )
+      ch.sorted = false;
+    UInt_t uoff;
+    if( !ch.entries.empty() && wunits == &fStrings[ch.entries.back().uoff] )
+      uoff = ch.entries.back().uoff;
+    else
+      uoff = AddString(wunits);
+    UInt_t soff = AddString(wval);
+    ch.entries.push_back( {event, soff, dval, timestamp, uoff, doff} );
   }
   if(DEBUGL) Print();
   return 1;
@@ -58,6 +58,11 @@ class THaEpics {
 
 public:
 
+   // Handle to an EPICS tag. Handles are stable for the lifetime of
+   // the object and may be obtained before any data for the tag arrive.
+   typedef UInt_t Handle_t;
+   static const Handle_t kNoHandle = kMaxUInt;
+
    THaEpics() = default;
    virtual ~THaEpics() = default;
 // Get tagged value nearest 'event'
@@ -69,11 +74,41 @@ public:
    Bool_t IsLoaded(const char* tag) const;
    void Print();
 
+// Handle-based access, avoids tag lookups
+   Handle_t    GetHandle( const char* tag );         // creates tag if new
+   Handle_t    FindHandle( const char* tag ) const;  // kNoHandle if unknown
+   Bool_t      IsLoaded( Handle_t h ) const
+   { return h < fChan.size() && !fChan[h].entries.empty(); }
+   Double_t    GetData( Handle_t h, UInt_t event= 0 ) const;
+   const char* GetCString( Handle_t h, UInt_t event= 0 ) const;
+   time_t      GetTimeStamp( Handle_t h, UInt_t event= 0 ) const;
+   const char* GetTag( Handle_t h ) const;
+
 private:
 
-   std::map< std::string, std::vector<EpicsChan> > epicsData;
-   std::vector<EpicsChan> GetChan(const char *tag) const;
-   static UInt_t FindEvent( const std::vector<EpicsChan>& ep, UInt_t event );
+   // One reading of a tag. Strings are offsets into fStrings.
+   struct Entry_t {
+     UInt_t   evnum;     // Most recent physics event number seen
+     UInt_t   soff;      // String data
+     Double_t dvalue;    // Numerical value of string data (0 if cannot convert)
+     time_t   timestamp; // Unix time of the EPICS event
+     UInt_t   uoff;      // Data units
+     UInt_t   doff;      // Timestamp as string
+   };
+   struct Channel_t {
+     explicit Channel_t( std::string tg ) : tag(std::move(tg)), sorted(true) {}
+     std::string          tag;
+     std::vector<Entry_t> entries;  // in order of arrival
+     Bool_t               sorted;   // entries ordered by evnum
+   };
+
+   std::vector<Channel_t>          fChan;     // Data, indexed by handle
+   std::map<std::string, Handle_t> fTagIndex; // Tag -> handle
+   std::string                     fStrings;  // Pool of '\0'-terminated strings
+
+   UInt_t AddString( const std::string& str );
+   const Entry_t* FindEntry( Handle_t h, UInt_t event ) const;
+   static UInt_t FindEvent( const Channel_t& ch, UInt_t event );
 
    ClassDef(THaEpics,0)  // EPICS data
 
@@ -79,6 +79,8 @@ THaEvData::THaEvData() :
   fInstance{fgInstances.FirstNullBit()},
   fNeedInit{true},
   fDebug{0},
+  fEvtTypeHandled(Decoder::MAX_EVTYPE+1),
+  fHaveEvtTypes{false},
   fExtra{nullptr}
 {
   fSlotUsed.reserve(MAXROCSLOT/4);  // Generous space for a typical setup
@@ -98,6 +100,23 @@ THaEvData::~THaEvData() {
   fgInstances.ResetBitNumber(fInstance);
 }
 
+//_____________________________________________________________________________
+void THaEvData::SetEvtTypesHandled( const TBits* handled )
+{
+  // Set the event types that have registered event type handlers. Bits
+  // above MAX_EVTYPE are ignored. A null pointer makes all types count
+  // as handled again.
+
+  fEvtTypeHandled.ResetAllBits();
+  fHaveEvtTypes = (handled != nullptr);
+  if( !handled )
+    return;
+  for( UInt_t itype = 0; itype <= Decoder::MAX_EVTYPE; ++itype ) {
+    if( handled->TestBitNumber(itype) )
+      fEvtTypeHandled.SetBitNumber(itype);
+  }
+}
+
 //_____________________________________________________________________________
 const char* THaEvData::DevType( UInt_t crate, UInt_t slot) const {
 // Device type in crate, slot
@@ -431,6 +450,78 @@ void THaEvData::SetRunInfo( UInt_t num, UInt_t type, ULong64_t tloc )
   SetRunTime(tloc);
 }
 
+//_____________________________________________________________________________
+UInt_t THaEvData::PackHits( vector<UInt_t>& buf ) const
+{
+  // Append the hits of all active slots to 'buf'. Format:
+  //
+  //   number of slots with hits
+  //   for each slot:  (crate << 16) | slot
+  //                   number of hits
+  //                   channel, data, raw data   (for each hit)
+  //
+  // Hits are ordered by channel in the order the channels were first seen,
+  // then by hit number, so that UnpackHits() reproduces the slot data
+  // exactly.
+
+  size_t ipos = buf.size();
+  buf.push_back(0);
+  UInt_t nslots = 0;
+  for( auto i : fSlotUsed ) {
+    const auto& sd = crateslot[i];
+    UInt_t nchan = sd->getNumChan();
+    if( nchan == 0 )
+      continue;
+    size_t ihdr = buf.size();
+    buf.push_back( (sd->getCrate() << 16) | sd->getSlot() );
+    buf.push_back(0);
+    UInt_t nhits = 0;
+    for( UInt_t j = 0; j < nchan; ++j ) {
+      UInt_t chan = sd->getNextChan(j);
+      UInt_t n = sd->getNumHits(chan);
+      for( UInt_t k = 0; k < n; ++k ) {
+        buf.push_back(chan);
+        buf.push_back(sd->getData(chan, k));
+        buf.push_back(sd->getRawData(chan, k));
+      }
+      nhits += n;
+    }
+    buf[ihdr+1] = nhits;
+    ++nslots;
+  }
+  buf[ipos] = nslots;
+  return nslots;
+}
+
+//_____________________________________________________________________________
+Int_t THaEvData::UnpackHits( const UInt_t* p, const UInt_t* pend )
+{
+  // Load hits in the format written by PackHits() into the slot data.
+  // Slots not defined in the current crate map are skipped.
+  // Returns HED_ERR if the data are truncated.
+
+  assert(fMap);
+  if( p >= pend )
+    return HED_ERR;
+  UInt_t nslots = *p++;
+  for( UInt_t i = 0; i < nslots; ++i ) {
+    if( pend - p < 2 )
+      return HED_ERR;
+    UInt_t crate = p[0] >> 16, slot = p[0] & 0xffff, nhits = p[1];
+    p += 2;
+    if( static_cast<size_t>(pend - p) < 3 * static_cast<size_t>(nhits) )
+      return HED_ERR;
+    if( GoodCrateSlot(crate, slot) && crateslot[idx(crate, slot)] &&
+        fMap->slotUsed(crate, slot) ) {
+      auto& sd = crateslot[idx(crate, slot)];
+      for( UInt_t k = 0; k < nhits; ++k, p += 3 )
+        sd->loadData(p[0], p[1], p[2]);
+    } else
+      p += 3 * nhits;
+  }
+  return HED_OK;
+}
+
 //_____________________________________________________________________________
 ClassImp(THaEvData)
 ClassImp(THaBenchmark)
@@ -37,6 +37,12 @@ public:
   // Derived classes MUST implement this function.
   virtual Int_t LoadEvent( const UInt_t* evbuffer ) = 0;
 
+  // Quick look at an event before LoadEvent(): get event type and number,
+  // trigger bits and the location of the crate data in 'evbuffer', but do
+  // not decode any modules. Returns HED_OK if these data are available,
+  // HED_WARN if this event cannot be pre-decoded.
+  virtual Int_t PreDecode( const UInt_t* /*evbuffer*/ ) { return HED_WARN; }
+
   // return a pointer to a full event
   const UInt_t*  GetRawDataBuffer() const { return buffer;}
 
@@ -47,6 +53,14 @@ public:
   // Set the EPICS event type
   void      SetEpicsEvtType( UInt_t itype) { fEpicsEvtType = itype; };
 
+  // Event types for which event type handlers are registered, as set up by
+  // the analyzer from its dispatch table. Until set up (or after a call
+  // with a null pointer), and for types > MAX_EVTYPE, all types count
+  // as handled.
+  void      SetEvtTypesHandled( const TBits* handled );
+  Bool_t    IsEvtTypeHandled( UInt_t itype ) const;
+  Bool_t    IsEvtTypeHandled() const { return IsEvtTypeHandled(event_type); }
+
   void      SetEvTime( ULong64_t evtime ) { evt_time = evtime; }
 
   // Basic access to the decoded data
@@ -159,6 +173,10 @@ public:
   // For THaRun to set info found during prescan FIXME BCI make virtual?
   void SetRunInfo( UInt_t num, UInt_t type, ULong64_t tloc );
 
+  // Append the decoded hits of all slots to 'buf', for caching decoded
+  // events. Returns number of slots with hits. See UnpackHits().
+  UInt_t PackHits( std::vector<UInt_t>& buf ) const;
+
 protected:
   // Control bits in TObject::fBits used by decoders
   enum {
@@ -173,6 +191,9 @@ protected:
   virtual void  makeidx( UInt_t crate, UInt_t slot );
   virtual void  FindUsedSlots();
 
+  // Load hits saved by PackHits() from [p,pend) into the slot data
+  Int_t UnpackHits( const UInt_t* p, const UInt_t* pend );
+
   // Helper functions
   UInt_t idx( UInt_t crate, UInt_t slot ) const;
   UInt_t idx( UInt_t crate, UInt_t slot );
@@ -229,6 +250,9 @@ protected:
 
   TBits fMsgPrinted; // Flags indicating one-time warnings printed
 
+  TBits  fEvtTypeHandled;  // Event types with registered handlers
+  Bool_t fHaveEvtTypes;    // fEvtTypeHandled has been set up
+
   TObject* fExtra;   // additional member data, for binary compatibility
 
   ClassDef(THaEvData,0)  // Base class for raw data decoders
@@ -374,6 +398,12 @@ Bool_t THaEvData::IsPrescaleEvent() const {
 	  event_type == Decoder::PRESCALE_EVTYPE);
 }
 
+inline
+Bool_t THaEvData::IsEvtTypeHandled( UInt_t itype ) const {
+  return ( !fHaveEvtTypes || itype > Decoder::MAX_EVTYPE ||
+           fEvtTypeHandled.TestBitNumber(itype) );
+}
+
 inline
 Bool_t THaEvData::IsSpecialEvent() const {
   return ( (event_type == Decoder::DETMAP_FILE) ||
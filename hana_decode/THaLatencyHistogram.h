@@ -0,0 +1,67 @@
+#ifndef Podd_THaLatencyHistogram_h_
+#define Podd_THaLatencyHistogram_h_
+
+//_____________________________________________________________________________
+//
+// THaLatencyHistogram
+//
+// Fixed-bucket logarithmic histogram of time intervals in nanoseconds
+//_____________________________________________________________________________
+
+#include "Rtypes.h"
+#include <array>
+
+class THaLatencyHistogram {
+public:
+  THaLatencyHistogram() { Reset(); }
+
+  // Values below 2^kSubBits are counted exactly. Each following octave
+  // is split into 2^kSubBits buckets, so the bucket width is at most
+  // 1/2^kSubBits (12.5%) of the value. The last bucket holds all
+  // values >= 2^kMaxBits ns (about 18 minutes).
+  static const UInt_t kSubBits  = 3;
+  static const UInt_t kMaxBits  = 40;
+  static const UInt_t kNbuckets = ((kMaxBits - kSubBits + 1) << kSubBits) + 1;
+
+  void Fill( ULong64_t ns ) {
+    ++fCount[Bucket(ns)];
+    ++fN;
+    fSum += ns;
+    if( ns < fMin ) fMin = ns;
+    if( ns > fMax ) fMax = ns;
+  }
+  void Add( const THaLatencyHistogram& rhs );
+  void Reset();
+
+  ULong64_t GetEntries() const { return fN; }
+  ULong64_t GetSum()     const { return fSum; }
+  ULong64_t GetMin()     const { return fN ? fMin : 0; }
+  ULong64_t GetMax()     const { return fMax; }
+  Double_t  GetMean()    const { return fN ? Double_t(fSum)/Double_t(fN) : 0; }
+  Double_t  GetPercentile( Double_t q ) const;
+
+  static UInt_t    Bucket( ULong64_t ns );
+  static ULong64_t BucketLow( UInt_t ibucket );
+
+private:
+  std::array<ULong64_t,kNbuckets> fCount;  // Entries per bucket
+  ULong64_t fN;                            // Total number of entries
+  ULong64_t fSum;                          // Sum of all values (ns)
+  ULong64_t fMin;                          // Smallest value (ns)
+  ULong64_t fMax;                          // Largest value (ns)
+};
+
+//_____________________________________________________________________________
+inline UInt_t THaLatencyHistogram::Bucket( ULong64_t ns )
+{
+  // Index of the bucket holding 'ns'
+  if( ns < (1ULL << kSubBits) )
+    return static_cast<UInt_t>(ns);
+  if( ns >= (1ULL << kMaxBits) )
+    return kNbuckets - 1;
+  UInt_t e = 63 - __builtin_clzll(ns);   // Octave: 2^e <= ns < 2^(e+1)
+  UInt_t sub = static_cast<UInt_t>(ns >> (e - kSubBits)) & ((1U << kSubBits) - 1);
+  return ((e - kSubBits + 1) << kSubBits) + sub;
+}
+
+#endif
@@ -0,0 +1,248 @@
+//_____________________________________________________________________________
+//
+// THaPerfCounters
+//
+// Reads the CPU's hardware performance counters for the calling thread
+// using the Linux perf_event_open system call: cycles, instructions,
+// last-level cache misses and branch mispredictions, counted in user
+// space only. The four counters are opened as one group so that they
+// are always scheduled together and can be read with a single read().
+// If the kernel multiplexes the group with other events, the counts of
+// each measured interval are scaled by the fraction of that interval
+// during which the group was actually counting (see Sum_t::Add).
+//
+// A reading costs one system call, typically below a microsecond. This
+// is fine for whole analysis stages, but measurably slows down decoding
+// when counting per decoder module. The counters are therefore intended
+// for targeted diagnosis, e.g. whether tracking is limited by cache
+// misses or a module's decoding by branch mispredictions.
+//
+// Where the counters cannot be opened (other operating systems, virtual
+// machines without a virtual PMU, perf_event_paranoid too restrictive),
+// Open() returns false and GetError() gives the reason.
+//
+// See THaAnalyzer::EnablePerfCounters.
+//_____________________________________________________________________________
+
+#include "THaPerfCounters.h"
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+THaPerfCounters* THaPerfCounters::fgActive = nullptr;
+
+//_____________________________________________________________________________
+THaPerfCounters::THaPerfCounters()
+{
+  // Constructor. The counters are not yet open.
+
+  for( auto& fd : fFd )
+    fd = -1;
+}
+
+//_____________________________________________________________________________
+THaPerfCounters::~THaPerfCounters()
+{
+  // Destructor
+
+  Close();
+  if( fgActive == this )
+    fgActive = nullptr;
+}
+
+#ifdef __linux__
+//_____________________________________________________________________________
+static int PerfEventOpen( UInt_t type, ULong64_t config, int group_fd )
+{
+  // Open one counter of the calling thread, on any CPU, user space only
+
+  struct perf_event_attr pe{};
+  pe.size = sizeof(pe);
+  pe.type = type;
+  pe.config = config;
+  pe.disabled = (group_fd == -1) ? 1 : 0;
+  pe.exclude_kernel = 1;
+  pe.exclude_hv = 1;
+  pe.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(__NR_perf_event_open, &pe, 0, -1,
+                                  group_fd, 0));
+}
+#endif
+
+//_____________________________________________________________________________
+Bool_t THaPerfCounters::Open()
+{
+  // Open and start the counters for the calling thread.
+  // Returns true on success.
+
+  if( IsOpen() )
+    return true;
+  fError.clear();
+#ifdef __linux__
+  static const ULong64_t config[kNcounters] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+  };
+  for( Int_t i = 0; i < kNcounters; ++i ) {
+    fFd[i] = PerfEventOpen(PERF_TYPE_HARDWARE, config[i], fFd[0]);
+    if( fFd[i] < 0 ) {
+      fError = string("cannot open ") + GetCounterName(ECounter(i)) +
+        " counter: " + strerror(errno);
+      if( errno == EACCES || errno == EPERM )
+        fError += " (check /proc/sys/kernel/perf_event_paranoid)";
+      else if( errno == ENOENT || errno == EOPNOTSUPP )
+        fError += " (no hardware performance counters)";
+      Close();
+      return false;
+    }
+  }
+  ioctl(fFd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fFd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  fError = "perf_event_open is only available on Linux";
+  return false;
+#endif
+}
+
+//_____________________________________________________________________________
+void THaPerfCounters::Close()
+{
+  // Close the counters
+
+#ifdef __linux__
+  for( Int_t i = kNcounters-1; i >= 0; --i ) {
+    if( fFd[i] >= 0 )
+      close(fFd[i]);
+    fFd[i] = -1;
+  }
+#endif
+}
+
+//_____________________________________________________________________________
+Bool_t THaPerfCounters::Read( Sample_t& sample ) const
+{
+  // Read the current raw counter values and enabled/running times
+
+#ifdef __linux__
+  if( IsOpen() ) {
+    // Layout for PERF_FORMAT_GROUP with both time fields
+    struct {
+      ULong64_t nr;
+      ULong64_t time_enabled;
+      ULong64_t time_running;
+      ULong64_t values[kNcounters];
+    } buf;
+    if( read(fFd[0], &buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf))
+        && buf.nr == kNcounters ) {
+      for( Int_t i = 0; i < kNcounters; ++i )
+        sample.v[i] = buf.values[i];
+      sample.enabled = buf.time_enabled;
+      sample.running = buf.time_running;
+      return true;
+    }
+  }
+#endif
+  for( auto& v : sample.v )
+    v = 0;
+  sample.enabled = sample.running = 0;
+  return false;
+}
+
+//_____________________________________________________________________________
+vector<string>& THaPerfCounters::ModuleTypes()
+{
+  static vector<string> types;
+  return types;
+}
+
+//_____________________________________________________________________________
+Int_t THaPerfCounters::GetModuleType( const char* classname )
+{
+  // Index of the decoder module type with the given class name
+
+  auto& types = ModuleTypes();
+  for( size_t i = 0; i < types.size(); ++i ) {
+    if( types[i] == classname )
+      return static_cast<Int_t>(i);
+  }
+  types.emplace_back(classname);
+  return static_cast<Int_t>(types.size() - 1);
+}
+
+//_____________________________________________________________________________
+const char* THaPerfCounters::GetCounterName( ECounter i )
+{
+  static const char* const names[kNcounters] = {
+    "cycles", "instructions", "cache-misses", "branch-misses"
+  };
+  return (i >= 0 && i < kNcounters) ? names[i] : "unknown";
+}
+
+//_____________________________________________________________________________
+void THaPerfCounters::PrintHeader( ostream& os, const char* title,
+                                   Int_t width, Bool_t per_event )
+{
+  // Print the header of a summary table
+
+  os << left << setw(width) << title << right
+     << setw(10) << "Calls"
+     << setw(12) << "Mcycles"
+     << setw(7)  << "IPC"
+     << setw(14) << (per_event ? "CacheMiss/ev" : "CacheMiss/call")
+     << setw(14) << (per_event ? "BrMiss/ev" : "BrMiss/call")
+     << endl;
+}
+
+//_____________________________________________________________________________
+void THaPerfCounters::PrintRow( ostream& os, const char* name, Int_t width,
+                                const Sum_t& sum, Double_t nevents )
+{
+  // Print the counts 'sum' as a row of a summary table, normalized to
+  // 'nevents' or, if nevents <= 0, to the number of calls
+
+  Double_t norm = (nevents > 0) ? nevents : Double_t(sum.calls);
+  if( norm <= 0 ) norm = 1;
+  auto fmt = os.flags();
+  auto prec = os.precision();
+  os << left << setw(width) << name << right << fixed
+     << setw(10) << sum.calls
+     << setw(12) << setprecision(1) << 1e-6 * Double_t(sum.v[kCycles])
+     << setw(7)  << setprecision(2) << sum.GetIPC()
+     << setw(14) << setprecision(1) << Double_t(sum.v[kCacheMisses]) / norm
+     << setw(14) << setprecision(1) << Double_t(sum.v[kBranchMisses]) / norm
+     << endl;
+  os.flags(fmt);
+  os.precision(prec);
+}
+
+//_____________________________________________________________________________
+void THaPerfCounters::PrintModules( ostream& os, Double_t nevents ) const
+{
+  // Print the counts of the decoder modules, per module type
+
+  const auto& types = ModuleTypes();
+  Int_t width = 20;
+  for( size_t i = 0; i < fModuleSums.size() && i < types.size(); ++i )
+    width = max(width, static_cast<Int_t>(types[i].length()) + 1);
+  bool header = false;
+  for( size_t i = 0; i < fModuleSums.size() && i < types.size(); ++i ) {
+    if( fModuleSums[i].calls == 0 )
+      continue;
+    if( !header ) {
+      PrintHeader(os, "Decoder module", width, nevents > 0);
+      header = true;
+    }
+    PrintRow(os, types[i].c_str(), width, fModuleSums[i], nevents);
+  }
+}
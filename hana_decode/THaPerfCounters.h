@@ -0,0 +1,123 @@
+#ifndef Podd_THaPerfCounters_h_
+#define Podd_THaPerfCounters_h_
+
+//_____________________________________________________________________________
+//
+// THaPerfCounters
+//
+// Hardware performance counters (cycles, instructions, cache misses,
+// branch misses) of the calling thread, via Linux perf_event_open
+//_____________________________________________________________________________
+
+#include "Rtypes.h"
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+class THaPerfCounters {
+public:
+  enum ECounter { kCycles = 0, kInstructions, kCacheMisses, kBranchMisses,
+                  kNcounters };
+
+  // Raw counter values at one point in time, and the times (ns) the group
+  // has been enabled and actually counting
+  struct Sample_t {
+    ULong64_t v[kNcounters];
+    ULong64_t enabled;
+    ULong64_t running;
+  };
+  // Counts accumulated over a number of intervals
+  struct Sum_t {
+    Sum_t() : calls(0), v() {}
+    void Add( const Sample_t& start, const Sample_t& stop ) {
+      // Scale the counts of this interval for the time the group was
+      // multiplexed out during it
+      ++calls;
+      ULong64_t enabled = stop.enabled - start.enabled;
+      ULong64_t running = stop.running - start.running;
+      Double_t scale = (running > 0 && running < enabled)
+        ? Double_t(enabled) / Double_t(running) : 1.0;
+      for( Int_t i = 0; i < kNcounters; ++i ) {
+        ULong64_t d = (stop.v[i] > start.v[i]) ? stop.v[i] - start.v[i] : 0;
+        v[i] += (scale == 1.0) ? d : static_cast<ULong64_t>(scale * Double_t(d));
+      }
+    }
+    Double_t GetIPC() const {
+      return v[kCycles] ? Double_t(v[kInstructions])/Double_t(v[kCycles]) : 0;
+    }
+    ULong64_t calls;
+    ULong64_t v[kNcounters];
+  };
+
+  THaPerfCounters();
+  THaPerfCounters( const THaPerfCounters& ) = delete;
+  THaPerfCounters& operator=( const THaPerfCounters& ) = delete;
+  ~THaPerfCounters();
+
+  // Open and start the counters for the calling thread. Returns false if
+  // they are not available, e.g. not on Linux, no hardware counters (as in
+  // many virtual machines), or not permitted (perf_event_paranoid > 2).
+  Bool_t Open();
+  void   Close();
+  Bool_t IsOpen() const { return fFd[0] >= 0; }
+  const char* GetError() const { return fError.c_str(); }
+
+  // Current counter values. Returns false and zeros if not open.
+  Bool_t Read( Sample_t& sample ) const;
+
+  // Counts of the decoder modules, by module type
+  static Int_t GetModuleType( const char* classname );
+  void   AddModule( Int_t type, const Sample_t& start, const Sample_t& stop ) {
+    if( type >= static_cast<Int_t>(fModuleSums.size()) )
+      fModuleSums.resize(type+1);
+    fModuleSums[type].Add(start, stop);
+  }
+  void   Reset() { fModuleSums.clear(); }
+
+  // Counters used by the decoder modules (see Scope)
+  static THaPerfCounters* GetActive()  { return fgActive; }
+  static void SetActive( THaPerfCounters* pc ) { fgActive = pc; }
+
+  // Summary tables. Counts are given per event if nevents > 0, else
+  // per call.
+  static void PrintHeader( std::ostream& os, const char* title, Int_t width,
+                           Bool_t per_event );
+  static void PrintRow( std::ostream& os, const char* name, Int_t width,
+                        const Sum_t& sum, Double_t nevents = 0 );
+  void   PrintModules( std::ostream& os, Double_t nevents ) const;
+
+  static const char* GetCounterName( ECounter i );
+
+  // Counts the code in its scope for the given decoder module type.
+  // Costs a single test if no counters are active.
+  class Scope {
+  public:
+    explicit Scope( Int_t type ) : fPC(fgActive), fType(type) {
+      if( fPC ) fPC->Read(fStart);
+    }
+    Scope( const Scope& ) = delete;
+    Scope& operator=( const Scope& ) = delete;
+    ~Scope() {
+      if( fPC ) {
+        Sample_t stop;
+        fPC->Read(stop);
+        fPC->AddModule(fType, fStart, stop);
+      }
+    }
+  private:
+    THaPerfCounters* fPC;
+    Int_t            fType;
+    Sample_t         fStart;
+  };
+
+private:
+  Int_t    fFd[kNcounters];   // Event file descriptors, fFd[0]: group leader
+  std::string fError;         // Reason why counters are not available
+  std::vector<Sum_t> fModuleSums;  // Counts per decoder module type
+
+  static std::vector<std::string>& ModuleTypes();
+
+  static THaPerfCounters* fgActive;  // Counters used by decoder modules
+};
+
+#endif
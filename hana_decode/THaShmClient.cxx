@@ -0,0 +1,174 @@
+/////////////////////////////////////////////////////////////////////
+//
+//   THaShmClient
+//   CODA events from a local shared-memory ring buffer
+//
+//   Reads the CODA events that a producer publishes in a ShmEventRing,
+//   e.g. shmprod, which replays a CODA file into a ring at a given
+//   rate. This is an alternative to THaEtClient that needs neither an
+//   ET system nor a network connection, so online analysis can be run
+//   and benchmarked on any Linux box.
+//
+//   Like a non-blocking ET station, the client only sees events
+//   published after it connected, and it never slows down the
+//   producer. Events overwritten before the client gets to them are
+//   skipped and counted in GetNdropped().
+//
+//   The ring name is that of a POSIX shared memory object, e.g.
+//   "/podd_ring". In mode 0, codaRead waits forever for new events.
+//   In mode 1, it gives up with CODA_ERROR after SetTimeout() seconds.
+//   After the producer has signalled the end of the run and all
+//   remaining events have been read, codaRead returns CODA_EOF.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaShmClient.h"
+#include "ShmEventRing.h"
+#include <iostream>
+#include <cstring>
+#include <ctime>
+
+using namespace std;
+
+namespace Decoder {
+
+static const UInt_t kDefaultTimeout = 10; // seconds
+
+//_____________________________________________________________________________
+THaShmClient::THaShmClient( Int_t mode )
+  : fRing(new ShmEventRing)
+  , fNext(0), fNread(0), fNdropped(0)
+  , fMode(mode)
+  , fTimeout(kDefaultTimeout)
+{
+  // Default constructor. Call codaOpen to connect to a ring.
+}
+
+//_____________________________________________________________________________
+THaShmClient::THaShmClient( const char* ringname, Int_t mode )
+  : THaShmClient(mode)
+{
+  // Constructor. Connect to ring 'ringname'.
+  THaShmClient::codaOpen(ringname, mode);
+}
+
+//_____________________________________________________________________________
+THaShmClient::~THaShmClient()
+{
+  THaShmClient::codaClose();
+}
+
+//_____________________________________________________________________________
+Int_t THaShmClient::codaOpen( const char* ringname, Int_t mode )
+{
+  // Connect to ring 'ringname'. The ring must exist, i.e. the producer
+  // must have been started.
+
+  codaClose();
+  fMode = mode;
+  if( fRing->Attach(ringname) != 0 ) {
+    if( verbose > 0 )
+      cerr << "THaShmClient: cannot attach to shared memory ring \""
+           << (ringname ? ringname : "") << "\". Is the producer running?"
+           << endl;
+    fIsGood = false;
+    return CODA_ERROR;
+  }
+  filename = ringname;
+  fNext = fRing->GetWritePos();
+  fNread = fNdropped = 0;
+  fIsGood = true;
+  return CODA_OK;
+}
+
+//_____________________________________________________________________________
+Int_t THaShmClient::codaOpen( const char* ringname, const char* /* session */,
+                              Int_t mode )
+{
+  // Same as codaOpen(ringname, mode). The session name is not used.
+  return codaOpen(ringname, mode);
+}
+
+//_____________________________________________________________________________
+Int_t THaShmClient::codaClose()
+{
+  if( fRing->IsAttached() && verbose > 0 && fNdropped > 0 )
+    cout << "THaShmClient: " << fNread << " events read, " << fNdropped
+         << " events dropped" << endl;
+  fRing->Detach();
+  return CODA_OK;
+}
+
+//_____________________________________________________________________________
+Int_t THaShmClient::codaRead()
+{
+  // Copy the next event from the ring into the event buffer.
+  // Must be called once per event.
+
+  if( !fRing->IsAttached() ) {
+    if( verbose > 0 )
+      cerr << "THaShmClient::codaRead ERROR: not connected. "
+           << "Call codaOpen(ringname) first." << endl;
+    fIsGood = false;
+    return CODA_ERROR;
+  }
+
+  evbuffer.updateSize();
+  const struct timespec pause = { 0, 100000 };  // 100 us
+  const time_t start = time(nullptr);
+  const ULong64_t nslots = fRing->GetNslots();
+  while( true ) {
+    ULong64_t wpos = fRing->GetWritePos();
+    if( fNext >= wpos ) {
+      // Caught up with the producer
+      if( fRing->IsEndOfRun() && fNext == fRing->GetWritePos() )
+        return CODA_EOF;
+      if( fMode != 0 && time(nullptr) - start >= (time_t)fTimeout ) {
+        if( verbose > 0 )
+          cerr << "THaShmClient: timeout waiting for events" << endl;
+        return CODA_ERROR;
+      }
+      nanosleep(&pause, nullptr);
+      continue;
+    }
+    if( wpos - fNext > nslots ) {
+      // Lapped by the producer
+      fNdropped += wpos - nslots - fNext;
+      fNext = wpos - nslots;
+    }
+    UInt_t len = 0;
+    const UInt_t* data = fRing->Peek(fNext, len);
+    if( data && len > getBuffSize() )
+      evbuffer.grow(len);
+    if( data && len <= getBuffSize() ) {
+      memcpy(getEvBuffer(), data, len * sizeof(UInt_t));
+      if( fRing->IsValid(fNext) ) {
+        ++fNext;
+        ++fNread;
+        evbuffer.recordSize();
+        fIsGood = true;
+        return CODA_OK;
+      }
+    }
+    // Event overwritten while we were looking at it
+    ++fNext;
+    ++fNdropped;
+  }
+}
+
+//_____________________________________________________________________________
+Bool_t THaShmClient::isOpen() const
+{
+  return fRing->IsAttached();
+}
+
+//_____________________________________________________________________________
+Int_t THaShmClient::getCodaVersion()
+{
+  // CODA version as announced by the producer
+  return fRing->GetCodaVersion();
+}
+
+} // namespace Decoder
+
+ClassImp(Decoder::THaShmClient)
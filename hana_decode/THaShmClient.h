@@ -0,0 +1,50 @@
+#ifndef Podd_THaShmClient_h_
+#define Podd_THaShmClient_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//   THaShmClient
+//   CODA events from a local shared-memory ring buffer
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaCodaData.h"
+#include <memory>
+
+namespace Decoder {
+
+class ShmEventRing;
+
+class THaShmClient : public THaCodaData {
+
+public:
+
+  explicit THaShmClient( Int_t mode=1 );
+  explicit THaShmClient( const char* ringname, Int_t mode=1 );
+  virtual ~THaShmClient();
+
+  virtual Int_t  codaOpen( const char* ringname, Int_t mode=1 );
+  virtual Int_t  codaOpen( const char* ringname, const char* session, Int_t mode=1 );
+  virtual Int_t  codaClose();
+  virtual Int_t  codaRead();
+  virtual Bool_t isOpen() const;
+  virtual Int_t  getCodaVersion();
+
+  void      SetTimeout( UInt_t seconds ) { fTimeout = seconds; }
+  ULong64_t GetNread()    const { return fNread; }
+  ULong64_t GetNdropped() const { return fNdropped; }
+
+private:
+  std::unique_ptr<ShmEventRing> fRing;  // Shared memory ring
+  ULong64_t fNext;      // Sequence number of next event to read
+  ULong64_t fNread;     // Number of events read
+  ULong64_t fNdropped;  // Number of events overwritten before we got them
+  Int_t     fMode;      // 0 = wait forever for data, 1 = time out
+  UInt_t    fTimeout;   // Timeout (s) for mode 1
+
+  ClassDef(THaShmClient,0)   // Shared-memory ring client for online data
+};
+
+} // namespace Decoder
+
+#endif
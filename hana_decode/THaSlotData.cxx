@@ -20,6 +20,7 @@
 #include "Module.h"
 #include "THaSlotData.h"
 #include "THaCrateMap.h"
+#include "THaPerfCounters.h"
 #include "TClass.h"
 #include <iostream>
 #include <stdexcept>
@@ -38,13 +39,13 @@ const UInt_t THaSlotData::DEFNHITCHAN = 1; // Default number of hits per channel
 THaSlotData::THaSlotData() :
   crate(-1), slot(-1), fModule(nullptr), numhitperchan(0), numraw(0), numchanhit(0),
   firstfreedataidx(0), numholesdataidx(0), fDebugFile(nullptr),
-  didini(false), fNchan(0) {}
+  didini(false), fNchan(0), fPerfType(-1), fCacheBlock(false), fCacheNext(0) {}
 
 //_____________________________________________________________________________
 THaSlotData::THaSlotData(UInt_t cra, UInt_t slo) :
   crate(cra), slot(slo), fModule(nullptr), numhitperchan(0), numraw(0), numchanhit(0),
   firstfreedataidx(0), numholesdataidx(0), fDebugFile(nullptr),
-  didini(false), fNchan(0)
+  didini(false), fNchan(0), fPerfType(-1), fCacheBlock(false), fCacheNext(0)
 {
 }
 
@@ -55,9 +56,12 @@ THaSlotData::~THaSlotData() = default;
 void THaSlotData::define(UInt_t cra, UInt_t slo, UInt_t nchan,
                          UInt_t /*ndata*/, // legacy parameter, no longer needed
                                            // since data arrays grow as needed
-			 UInt_t nhitperchan ) {
+			 UInt_t nhitperchan, const char* devtype ) {
   // Must call define once if you are really going to use this slot.
   // Otherwise its an empty slot which does not use much memory.
+  // If given, 'devtype' sets the device type ("adc", "tdc" etc.).
+  // Decoders using the fast loading methods should set it here or
+  // via setDevType().
   crate = cra;
   slot = slo;
   didini = true;
@@ -66,13 +70,15 @@ void THaSlotData::define(UInt_t cra, UInt_t slo, UInt_t nchan,
   numHits.resize(fNchan);
   chanlist.resize(fNchan);
   idxlist.resize(fNchan);
-  chanindex.resize(fNchan);
+  chanindex.assign(fNchan,0);  // see isListed()
   rawData.resize(fNchan);
   data.resize(fNchan);
   dataindex.resize(fNchan);
   numMaxHits.resize(fNchan);
+  blockcount.assign(fNchan,0);
   numchanhit = numraw = firstfreedataidx = numholesdataidx= 0;
   numHits.assign(numHits.size(),0);
+  setDevType(devtype);
 }
 
 //_____________________________________________________________________________
@@ -112,6 +118,7 @@ int THaSlotData::loadModule(const THaCrateMap *map) {
     if (fDebugFile) *fDebugFile << "THaSlotData:: Creating fModule"<<endl;
     if( !fModule || fModule->IsA() != loctype.fTClass ) {
       fModule.reset(static_cast<Module*>( loctype.fTClass->New() ));
+      fPerfType = -1;
     } else if (fDebugFile) {
       *fDebugFile << "THaSlotData:: Reusing existing fModule" << endl;
     }
@@ -182,7 +189,11 @@ UInt_t THaSlotData::LoadIfSlot( const UInt_t* evbuffer, const UInt_t *pstop) {
   }
   if (fDebugFile) fModule->DoPrint();
   fModule->Clear();
+  fCacheIdx.clear();
+  THaPerfCounters::Scope perf(PerfType());
   UInt_t wordseen = fModule->LoadBlock(this, evbuffer, pstop);
+  if( fCacheBlock && wordseen > 0 )
+    CacheBlock();
   if (fDebugFile)
     *fDebugFile << "THaSlotData:: after LoadIfSlot:  wordseen =  "
                 << dec << "  " << wordseen << endl;
@@ -204,7 +215,11 @@ UInt_t THaSlotData::LoadBank( const UInt_t* p, UInt_t pos, UInt_t len) {
                 << hex << *p << "  module ptr  " << fModule.get() << dec << endl;
   if (fDebugFile) fModule->DoPrint();
   fModule->Clear();
+  fCacheIdx.clear();
+  THaPerfCounters::Scope perf(PerfType());
   UInt_t wordseen = fModule->LoadBank(this, p, pos, len);
+  if( fCacheBlock && wordseen > 0 )
+    CacheBlock();
   if (fDebugFile) *fDebugFile << "THaSlotData:: after LoadBank:  wordseen =  "<<dec<<"  "<<wordseen<<endl;
   return wordseen;
 }
@@ -216,9 +231,89 @@ UInt_t THaSlotData::LoadNextEvBuffer() {
     cerr << "THaSlotData::ERROR:   No module defined for slot. "<<crate<<"  "<<slot<<endl;
     return 0;
   }
+  if( !fCacheIdx.empty() ) {
+    // Block already decoded by CacheBlock(). Returns number of hits loaded.
+    if( BlockIsDone() )
+      return 0;
+    UInt_t nhits = fCacheIdx[fCacheNext+1] - fCacheIdx[fCacheNext];
+    RestoreHits(fCacheNext++);
+    return nhits;
+  }
+  THaPerfCounters::Scope perf(PerfType());
   return fModule->LoadNextEvBuffer(this);
 }
 
+//_____________________________________________________________________________
+Int_t THaSlotData::PerfType()
+{
+  // Index of this slot's module type for the hardware counters. Only
+  // looked up while counters are active.
+
+  if( fPerfType < 0 && THaPerfCounters::GetActive() )
+    fPerfType = THaPerfCounters::GetModuleType(fModule->ClassName());
+  return fPerfType;
+}
+
+//_____________________________________________________________________________
+void THaSlotData::CacheBlock()
+{
+  // If the module has just loaded the first event of a multiblock buffer,
+  // decode all remaining events of the block right away and save the hits
+  // of each event, so that LoadNextEvBuffer() only needs to copy them back.
+  // The cache arrays keep their allocated size from block to block.
+  //
+  // CAUTION: Afterwards, the module object itself holds the data of the
+  // last event of the block. Only the hits in this THaSlotData are correct
+  // for the current event.
+
+  if( !fModule->IsMultiBlockMode() || fModule->BlockIsDone() )
+    return;
+
+  fCacheChan.clear();
+  fCacheData.clear();
+  fCacheRaw.clear();
+  SaveHits();
+  while( !fModule->BlockIsDone() ) {
+    clearEvent();
+    fModule->LoadNextEvBuffer(this);
+    SaveHits();
+  }
+  fCacheIdx.push_back(fCacheChan.size());  // end marker
+
+  // Back to the first event
+  clearEvent();
+  RestoreHits(0);
+  fCacheNext = 1;
+}
+
+//_____________________________________________________________________________
+void THaSlotData::SaveHits()
+{
+  // Append the current hits to the block cache, grouped by channel
+
+  fCacheIdx.push_back(fCacheChan.size());
+  for( UInt_t i = 0; i < numchanhit; i++ ) {
+    UInt_t chan = chanlist[i];
+    for( UInt_t j = 0; j < numHits[chan]; j++ ) {
+      UInt_t index = dataindex[idxlist[chan]+j];
+      fCacheChan.push_back(chan);
+      fCacheData.push_back(data[index]);
+      fCacheRaw.push_back(rawData[index]);
+    }
+  }
+}
+
+//_____________________________________________________________________________
+void THaSlotData::RestoreHits( UInt_t iev )
+{
+  // Load the hits of event 'iev' of the current block from the cache
+
+  assert( iev+1 < fCacheIdx.size() );
+  UInt_t beg = fCacheIdx[iev];
+  loadHitBlock( fCacheIdx[iev+1] - beg, fCacheChan.data() + beg,
+                fCacheData.data() + beg, fCacheRaw.data() + beg );
+}
+
 //_____________________________________________________________________________
 Int_t THaSlotData::loadData(const char* type, UInt_t chan, UInt_t dat, UInt_t raw) {
 
@@ -250,7 +345,7 @@ Int_t THaSlotData::loadData(const char* type, UInt_t chan, UInt_t dat, UInt_t ra
   }
   if( device.empty() && type ) device = type;
 
-  if (( numchanhit == 0 )||(numHits[chan]==0)) {
+  if( numchanhit == 0 || (numHits[chan] == 0 && !isListed(chan)) ) {
     compressdataindex(numhitperchan);
     dataindex[firstfreedataidx]=numraw;
     idxlist[chan]=firstfreedataidx;
@@ -308,6 +403,75 @@ int THaSlotData::loadData(UInt_t chan, UInt_t dat, UInt_t raw) {
   return loadData(nullptr, chan, dat, raw);
 }
 
+//_____________________________________________________________________________
+void THaSlotData::reserveHits( UInt_t chan, UInt_t nhits )
+{
+  // Set aside dataindex space for at least 'nhits' more hits on 'chan' so
+  // that they can be added with appendHit(). Channels are given at least
+  // 'numhitperchan' slots, as in loadData(). A channel whose earlier
+  // reservation has not been filled yet keeps its entry in chanlist.
+
+  assert( didini && chan < fNchan );
+  if( nhits == 0 )
+    return;
+  UInt_t nhit = numHits[chan];
+  if( nhit == 0 && !isListed(chan) ) {
+    UInt_t nmax = std::max(nhits, numhitperchan);
+    compressdataindex(nmax);
+    idxlist[chan] = firstfreedataidx;
+    numMaxHits[chan] = nmax;
+    firstfreedataidx += nmax;
+    chanindex[chan] = numchanhit;
+    chanlist[numchanhit++] = chan;
+  } else if( nhit+nhits > numMaxHits[chan] ) {
+    UInt_t nmax = nhit + std::max(nhits, numhitperchan);
+    // May reshuffle dataindex and so change idxlist[chan]
+    compressdataindex(nmax);
+    if( idxlist[chan]+numMaxHits[chan] == firstfreedataidx ) {
+      // Last channel in dataindex: simply extend it
+      firstfreedataidx = idxlist[chan] + nmax;
+    } else {
+      // Move this channel's indices to the end
+      numholesdataidx += numMaxHits[chan];
+      for( UInt_t i = 0; i < nhit; i++ )
+        dataindex[firstfreedataidx+i] = dataindex[idxlist[chan]+i];
+      idxlist[chan] = firstfreedataidx;
+      firstfreedataidx += nmax;
+    }
+    numMaxHits[chan] = nmax;
+  }
+}
+
+//_____________________________________________________________________________
+void THaSlotData::loadHitBlock( UInt_t nhits, const UInt_t* chan,
+                                const UInt_t* dat, const UInt_t* raw )
+{
+  // Load 'nhits' hits at once. Hit i is on channel chan[i] (which must be
+  // < getNchan()) with data dat[i] and raw word raw[i]. The hits are
+  // counted per channel first, so that each channel's dataindex span is
+  // allocated only once and the hits are then appended without any checks.
+  // The order of hits within a channel is preserved.
+
+  assert( didini );
+  if( nhits == 0 )
+    return;
+  for( UInt_t i = 0; i < nhits; i++ ) {
+    assert( chan[i] < fNchan );
+    ++blockcount[chan[i]];
+  }
+  reserveData(nhits);
+  // Channels are listed in order of first appearance, as with loadData()
+  for( UInt_t i = 0; i < nhits; i++ ) {
+    UInt_t& n = blockcount[chan[i]];
+    if( n > 0 ) {
+      reserveHits(chan[i], n);
+      n = 0;
+    }
+  }
+  for( UInt_t i = 0; i < nhits; i++ )
+    appendHit(chan[i], dat[i], raw[i]);
+}
+
 //_____________________________________________________________________________
 void THaSlotData::print() const
 {
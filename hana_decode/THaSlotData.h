@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>  // std::max
 
 const int SD_WARN = -2;
 const int SD_ERR = -1;
@@ -61,19 +62,44 @@ public:
        Int_t  loadData( const char* type, UInt_t chan, UInt_t dat, UInt_t raw );
        Int_t  loadData( UInt_t chan, UInt_t dat, UInt_t raw );
 
+       // Fast loading for module decoders that have already validated the
+       // slot header and channel numbers (chan < getNchan()). No checks
+       // are done except by assert(). The device type is not updated;
+       // set it once with define() or setDevType().
+       // Either reserve space for a block of hits, then append them,
+       void   reserveData( UInt_t nhits );           // for nhits more words
+       void   reserveHits( UInt_t chan, UInt_t nhits ); // for nhits on chan
+       void   appendHit( UInt_t chan, UInt_t dat, UInt_t raw );
+       // or load a channel's hits at once, or add single hits
+       void   loadHits( UInt_t chan, const UInt_t* dat, const UInt_t* raw,
+                        UInt_t nhits );
+       void   pushHit( UInt_t chan, UInt_t dat, UInt_t raw );
+       // or load a whole block of hits given as arrays (SoA)
+       void   loadHitBlock( UInt_t nhits, const UInt_t* chan,
+                            const UInt_t* dat, const UInt_t* raw );
+       void   setDevType( const char* type ) { if( type ) device = type; }
+
        // new
        UInt_t LoadIfSlot( const UInt_t* evbuffer, const UInt_t* pstop );
        UInt_t LoadBank( const UInt_t* p, UInt_t pos, UInt_t len );
        UInt_t LoadNextEvBuffer();
        Bool_t IsMultiBlockMode() { if (fModule) return fModule->IsMultiBlockMode(); return false; };
-       Bool_t BlockIsDone() { if (fModule) return fModule->BlockIsDone(); return false; };
+       Bool_t BlockIsDone() {
+         if( !fCacheIdx.empty() ) return fCacheNext+1 >= fCacheIdx.size();
+         if (fModule) return fModule->BlockIsDone(); return false;
+       };
+       // Decode all events of a multiblock buffer at once and serve
+       // subsequent events from a cache
+       void   SetBlockCache( Bool_t enable ) { fCacheBlock = enable; }
+       Bool_t IsBlockCacheEnabled() const { return fCacheBlock; }
 
        void SetDebugFile(std::ofstream *file) { fDebugFile = file; };
        Module* GetModule() { return fModule.get(); };
 
        // Define crate, slot
        void define( UInt_t crate, UInt_t slot, UInt_t nchan = DEFNCHAN,
-                    UInt_t ndata = DEFNDATA, UInt_t nhitperchan = DEFNHITCHAN );
+                    UInt_t ndata = DEFNDATA, UInt_t nhitperchan = DEFNHITCHAN,
+                    const char* devtype = nullptr );
        void print() const;
        void print_to_file() const;
        void compressdataindex(UInt_t numidx);
@@ -97,11 +123,24 @@ private:
        VectorUIntNI numMaxHits;  // [channel] current maximum number of hits
        VectorUIntNI rawData;     // rawData[hit] (all bits)
        VectorUIntNI data;        // data[hit] (only data bits)
+       VectorUInt   blockcount;  // [channel] scratch for loadHitBlock
+       bool fCacheBlock;         // Cache all events of multiblock data
+       UInt_t fCacheNext;        // Next event to load from cache
+       VectorUInt   fCacheIdx;   // [event] first hit in cache, + end marker
+       VectorUIntNI fCacheChan;  // Cached hits: channel numbers
+       VectorUIntNI fCacheData;  //  ... data words
+       VectorUIntNI fCacheRaw;   //  ... raw words
        std::ofstream *fDebugFile; // debug output to this file, if nonzero
        bool didini;         // true if object initialized via define()
        UInt_t fNchan;       // Number of channels for this device
+       Int_t  fPerfType;    // Module type index in THaPerfCounters (cache)
 
        void compressdataindexImpl(UInt_t numidx);
+       bool isListed( UInt_t chan ) const;
+       Int_t PerfType();
+       void CacheBlock();
+       void SaveHits();
+       void RestoreHits( UInt_t iev );
 
        ClassDef(THaSlotData,0)   //  Data in one slot of fastbus, vme, camac
 };
@@ -183,6 +222,61 @@ void THaSlotData::clearEvent() {
   while( numchanhit>0 ) numHits[chanlist[--numchanhit]] = 0;
 }
 
+//_____________________________________________________________________________
+inline
+bool THaSlotData::isListed( UInt_t chan ) const {
+  // True if 'chan' is in chanlist, i.e. has hits or reserved space
+  UInt_t i = chanindex[chan];
+  return i < numchanhit && chanlist[i] == chan;
+}
+
+//_____________________________________________________________________________
+inline
+void THaSlotData::reserveData( UInt_t nhits ) {
+  // Make room for 'nhits' more data words
+  if( numraw+nhits > data.size() ) {
+    size_t allocd = std::max(2*data.size(), static_cast<size_t>(numraw+nhits));
+    rawData.resize(allocd);
+    data.resize(allocd);
+  }
+}
+
+//_____________________________________________________________________________
+inline
+void THaSlotData::appendHit( UInt_t chan, UInt_t dat, UInt_t raw ) {
+  // Append a hit to 'chan'. Space must have been set aside with
+  // reserveData() and reserveHits().
+  // CAUTION: this code is critical for performance
+  assert( chan < fNchan && numHits[chan] < numMaxHits[chan] &&
+          numraw < data.size() );
+  dataindex[idxlist[chan]+numHits[chan]++] = numraw;
+  rawData[numraw] = raw;
+  data[numraw++]  = dat;
+}
+
+//_____________________________________________________________________________
+inline
+void THaSlotData::loadHits( UInt_t chan, const UInt_t* dat, const UInt_t* raw,
+                            UInt_t nhits ) {
+  // Load 'nhits' hits on 'chan' from the arrays 'dat' and 'raw'
+  reserveData(nhits);
+  reserveHits(chan, nhits);
+  for( UInt_t i = 0; i < nhits; ++i )
+    appendHit(chan, dat[i], raw[i]);
+}
+
+//_____________________________________________________________________________
+inline
+void THaSlotData::pushHit( UInt_t chan, UInt_t dat, UInt_t raw ) {
+  // Add a single hit on 'chan', reserving space as needed
+  assert( chan < fNchan );
+  if( numHits[chan] == 0 || numHits[chan] == numMaxHits[chan] )
+    reserveHits(chan, 1);
+  if( numraw == data.size() )
+    reserveData(1);
+  appendHit(chan, dat, raw);
+}
+
 //_____________________________________________________________________________
 inline
 void THaSlotData::compressdataindex(UInt_t numidx) {
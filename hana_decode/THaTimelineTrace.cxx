@@ -0,0 +1,264 @@
+//_____________________________________________________________________________
+//
+// THaTimelineTrace
+//
+// Records a timeline of the processing of a sampled subset of events,
+// e.g. every 100th event, for diagnosing stalls such as I/O waits,
+// unusually large events or slow modules.
+//
+// The code to be timed is instrumented with THaTimelineTrace::Span
+// objects, which cost a single test unless the current event is sampled.
+// Spans are appended to a buffer owned by the recording thread, so
+// recording takes no locks, except once per thread to create the buffer.
+// Write() collects the buffers of all threads into a file in Chrome Trace
+// Event JSON format, which can be opened with https://ui.perfetto.dev
+// or chrome://tracing. Each sampled event appears as an "event" span
+// containing the spans of its processing steps.
+//
+// See THaAnalyzer::EnableTimelineTrace.
+//_____________________________________________________________________________
+
+#include "THaTimelineTrace.h"
+#include "TError.h"
+#include "Textvars.h"  // Podd::JsonString
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+
+using namespace std;
+using Podd::JsonString;
+
+THaTimelineTrace*   THaTimelineTrace::fgActive = nullptr;
+atomic<bool>        THaTimelineTrace::fgSampling{false};
+atomic<UInt_t>      THaTimelineTrace::fgGeneration{0};
+
+// Buffer of the current thread, valid while 'gen' equals fgGeneration
+namespace {
+struct ThreadCache_t {
+  const THaTimelineTrace* trace;
+  UInt_t gen;
+  void*  buf;
+};
+thread_local ThreadCache_t tl_cache = { nullptr, 0, nullptr };
+}
+
+//_____________________________________________________________________________
+THaTimelineTrace::THaTimelineTrace( UInt_t every, UInt_t max_events )
+  : fEvery(every > 0 ? every : 1), fMaxEvents(max_events),
+    fMaxSpans(1000000), fNevents(0), fNsampled(0), fT0(0), fEventT0(0)
+{
+  // Constructor
+}
+
+//_____________________________________________________________________________
+THaTimelineTrace::~THaTimelineTrace()
+{
+  // Destructor
+
+  Stop();
+  ++fgGeneration;
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::SetSampling( UInt_t every, UInt_t max_events )
+{
+  // Sample every 'every'-th event, up to 'max_events' events (0: no limit)
+
+  fEvery = (every > 0) ? every : 1;
+  fMaxEvents = max_events;
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::Start()
+{
+  // Start recording. Replaces any other active trace. Spans recorded
+  // earlier are kept, so a trace may cover several Start/Stop periods.
+
+  if( fgActive == this )
+    return;
+  if( fgActive )
+    fgActive->Stop();
+  if( fT0 == 0 )
+    fT0 = THaBenchmark::Now();
+  fNevents = 0;
+  fMainThread = this_thread::get_id();
+  ++fgGeneration;
+  fgActive = this;
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::Stop()
+{
+  // Stop recording. Ends the current sampled event, if any.
+
+  if( fgActive != this )
+    return;
+  if( fgSampling.load(memory_order_relaxed) )
+    Record("event", "event", fEventT0, THaBenchmark::Now(), "seq",
+           fNevents - 1);
+  fgSampling = false;
+  fgActive = nullptr;
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::NextEvent()
+{
+  // End the span of the previous event, if it was sampled, and decide
+  // whether to sample the next one
+
+  if( fgActive != this )
+    return;
+  ULong64_t now = THaBenchmark::Now();
+  if( fgSampling.load(memory_order_relaxed) )
+    Record("event", "event", fEventT0, now, "seq", fNevents - 1);
+  bool sample = (fNevents % fEvery == 0) &&
+    (fMaxEvents == 0 || fNsampled < fMaxEvents);
+  ++fNevents;
+  if( sample ) {
+    ++fNsampled;
+    fEventT0 = now;
+  }
+  fgSampling.store(sample, memory_order_relaxed);
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::Clear()
+{
+  // Discard all recorded spans
+
+  lock_guard<mutex> lock(fMutex);
+  ++fgGeneration;
+  fBuffers.clear();
+  fNsampled = 0;
+  fT0 = (fgActive == this) ? THaBenchmark::Now() : 0;
+}
+
+//_____________________________________________________________________________
+THaTimelineTrace::Buffer_t* THaTimelineTrace::GetBuffer()
+{
+  // Buffer of the calling thread. Created when the thread first records
+  // a span.
+
+  UInt_t gen = fgGeneration.load(memory_order_acquire);
+  if( tl_cache.trace == this && tl_cache.gen == gen )
+    return static_cast<Buffer_t*>(tl_cache.buf);
+
+  lock_guard<mutex> lock(fMutex);
+  auto id = this_thread::get_id();
+  auto it = find_if(fBuffers.begin(), fBuffers.end(),
+                    [id]( const unique_ptr<Buffer_t>& b ) {
+                      return b->thread == id;
+                    });
+  Buffer_t* buf = nullptr;
+  if( it != fBuffers.end() )
+    buf = it->get();
+  else {
+    fBuffers.emplace_back(new Buffer_t);
+    buf = fBuffers.back().get();
+    buf->thread = id;
+    buf->ndropped = 0;
+    buf->spans.reserve(min(fMaxSpans, size_t(65536)));
+  }
+  tl_cache.trace = this;
+  tl_cache.gen = gen;
+  tl_cache.buf = buf;
+  return buf;
+}
+
+//_____________________________________________________________________________
+void THaTimelineTrace::Record( const char* name, const char* cat,
+                               ULong64_t t0, ULong64_t t1,
+                               const char* argname, Long64_t arg,
+                               UInt_t namelen )
+{
+  // Append a span to the buffer of the calling thread. Spans beyond the
+  // per-thread limit (SetMaxSpans) are counted, but not kept.
+
+  THaTimelineTrace* trace = fgActive;
+  if( !trace )
+    return;
+  Buffer_t* buf = trace->GetBuffer();
+  if( buf->spans.size() >= trace->fMaxSpans ) {
+    ++buf->ndropped;
+    return;
+  }
+  Span_t span = { name, cat, argname, arg, t0, (t1 > t0) ? t1 - t0 : 0,
+                  namelen };
+  buf->spans.push_back(span);
+}
+
+//_____________________________________________________________________________
+ULong64_t THaTimelineTrace::GetNspans() const
+{
+  lock_guard<mutex> lock(fMutex);
+  ULong64_t n = 0;
+  for( const auto& buf : fBuffers )
+    n += buf->spans.size();
+  return n;
+}
+
+//_____________________________________________________________________________
+ULong64_t THaTimelineTrace::GetNdropped() const
+{
+  lock_guard<mutex> lock(fMutex);
+  ULong64_t n = 0;
+  for( const auto& buf : fBuffers )
+    n += buf->ndropped;
+  return n;
+}
+
+//_____________________________________________________________________________
+Int_t THaTimelineTrace::Write( const char* filename ) const
+{
+  // Write the recorded spans in Chrome Trace Event format to 'filename'.
+  // Times are in microseconds since Start(). Threads are numbered in the
+  // order in which they first recorded a span. Returns 0 on success.
+
+  static const char* const here = "THaTimelineTrace::Write";
+
+  if( !filename || !*filename )
+    return -1;
+  ofstream ostr(filename);
+  if( !ostr ) {
+    ::Error( here, "Cannot open trace file %s", filename );
+    return -2;
+  }
+  lock_guard<mutex> lock(fMutex);
+  ULong64_t ndropped = 0;
+  ostr << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << endl
+       << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+       << "\"args\":{\"name\":\"analyzer\"}}";
+  ostr << fixed << setprecision(3);
+  UInt_t tid = 0;
+  for( const auto& buf : fBuffers ) {
+    ++tid;
+    ndropped += buf->ndropped;
+    string tname = (buf->thread == fMainThread)
+      ? string("analysis") : "thread " + to_string(tid);
+    ostr << "," << endl
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << tid << ",\"args\":{\"name\":\"" << tname << "\"}}";
+    for( const auto& s : buf->spans ) {
+      ostr << "," << endl
+           << "{\"name\":" << JsonString(s.name, s.namelen)
+           << ",\"cat\":" << JsonString(s.cat)
+           << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+           << ",\"ts\":" << 1e-3 * Double_t(s.t0 - fT0)
+           << ",\"dur\":" << 1e-3 * Double_t(s.dur);
+      if( s.argname )
+        ostr << ",\"args\":{" << JsonString(s.argname) << ":" << s.arg << "}";
+      ostr << "}";
+    }
+  }
+  ostr << endl << "]}" << endl;
+  if( !ostr ) {
+    ::Error( here, "Error writing trace file %s", filename );
+    return -3;
+  }
+  if( ndropped > 0 )
+    ::Warning( here, "%llu spans dropped (limit of %lu per thread). "
+               "Increase with SetMaxSpans().", ndropped,
+               static_cast<unsigned long>(fMaxSpans) );
+  return 0;
+}
@@ -0,0 +1,128 @@
+#ifndef Podd_THaTimelineTrace_h_
+#define Podd_THaTimelineTrace_h_
+
+//_____________________________________________________________________________
+//
+// THaTimelineTrace
+//
+// Timeline of the processing of sampled events, written in Chrome Trace
+// Event format for viewing in Perfetto (ui.perfetto.dev) or chrome://tracing
+//_____________________________________________________________________________
+
+#include "Rtypes.h"
+#include "THaBenchmark.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class THaTimelineTrace {
+public:
+  // Record every 'every'-th event, up to 'max_events' events (0: no limit)
+  explicit THaTimelineTrace( UInt_t every = 100, UInt_t max_events = 1000 );
+  THaTimelineTrace( const THaTimelineTrace& ) = delete;
+  THaTimelineTrace& operator=( const THaTimelineTrace& ) = delete;
+  ~THaTimelineTrace();
+
+  void   SetSampling( UInt_t every, UInt_t max_events = 0 );
+  void   SetMaxSpans( size_t n ) { fMaxSpans = n; }
+
+  // Start/stop recording. Only one trace can be recording at a time.
+  void   Start();
+  void   Stop();
+  // Call before reading each event. Decides whether the event is sampled.
+  void   NextEvent();
+  // Write all recorded spans to 'filename'. Call after Stop().
+  Int_t  Write( const char* filename ) const;
+  // Discard all recorded spans
+  void   Clear();
+
+  ULong64_t GetNsampled() const { return fNsampled; }
+  ULong64_t GetNspans() const;
+  ULong64_t GetNdropped() const;
+
+  static THaTimelineTrace* GetActive() { return fgActive; }
+  // True while the current event is sampled. Checked by Span.
+  static Bool_t IsSampling() {
+    return fgSampling.load(std::memory_order_relaxed);
+  }
+
+  // Record a span of the current thread. 'name' and 'cat' must remain
+  // valid until Write(). Only the first 'namelen' characters of 'name'
+  // are used, if given. Optionally, one integer argument.
+  static void Record( const char* name, const char* cat,
+                      ULong64_t t0, ULong64_t t1,
+                      const char* argname = nullptr, Long64_t arg = 0,
+                      UInt_t namelen = kMaxUInt );
+
+  // Records the time spent in its scope, if the event is sampled
+  class Span {
+  public:
+    Span( const char* name, const char* cat,
+          const char* argname = nullptr, Long64_t arg = 0 )
+      : fName(name), fCat(cat), fArgName(argname), fArg(arg),
+        fT0(IsSampling() ? THaBenchmark::Now() : 0) {}
+    Span( const Span& ) = delete;
+    Span& operator=( const Span& ) = delete;
+    ~Span() {
+      if( fT0 )
+        Record(fName, fCat, fT0, THaBenchmark::Now(), fArgName, fArg);
+    }
+    // End this span and start a new one, e.g. for the next processing step
+    void Next( const char* name, const char* argname = nullptr,
+               Long64_t arg = 0 ) {
+      if( fT0 ) {
+        ULong64_t now = THaBenchmark::Now();
+        Record(fName, fCat, fT0, now, fArgName, fArg);
+        fT0 = now;
+      }
+      fName = name; fArgName = argname; fArg = arg;
+    }
+    void SetArg( const char* argname, Long64_t arg ) {
+      fArgName = argname; fArg = arg;
+    }
+    Bool_t IsRecording() const { return fT0 != 0; }
+  private:
+    const char* fName;
+    const char* fCat;
+    const char* fArgName;
+    Long64_t    fArg;
+    ULong64_t   fT0;
+  };
+
+private:
+  struct Span_t {
+    const char* name;
+    const char* cat;
+    const char* argname;
+    Long64_t    arg;
+    ULong64_t   t0;      // Start time (ns)
+    ULong64_t   dur;     // Duration (ns)
+    UInt_t      namelen;
+  };
+  // Spans of one thread. Only the owning thread appends to it.
+  struct Buffer_t {
+    std::thread::id     thread;
+    std::vector<Span_t> spans;
+    ULong64_t           ndropped;
+  };
+  std::vector<std::unique_ptr<Buffer_t>> fBuffers; // One per thread
+  mutable std::mutex fMutex;     // Protects fBuffers
+  UInt_t     fEvery;             // Sample every fEvery-th event
+  UInt_t     fMaxEvents;         // Maximum number of sampled events
+  size_t     fMaxSpans;          // Maximum number of spans per thread
+  ULong64_t  fNevents;           // Events seen since Start()
+  ULong64_t  fNsampled;          // Events sampled
+  ULong64_t  fT0;                // Start time (ns)
+  ULong64_t  fEventT0;           // Start of current sampled event (ns)
+  std::thread::id fMainThread;   // Thread that called Start()
+
+  Buffer_t*  GetBuffer();
+
+  static THaTimelineTrace*  fgActive;    // Trace currently recording
+  static std::atomic<bool>  fgSampling;  // Current event is sampled
+  static std::atomic<UInt_t> fgGeneration; // Incremented by Start/Clear
+};
+
+#endif
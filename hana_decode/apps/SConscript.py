@@ -11,7 +11,7 @@ thisdir = os.path.basename(os.path.normpath(thisdir_fullpath))
 # Executables
 appnames = ['tstfadc', 'tstfadcblk', 'tstf1tdc', 'tstio',
             'tstoo', 'tdecpr', 'prfact', 'epicsd', 'tdecex',
-            'tst1190']
+            'tst1190', 'shmprod', 'evgen']
 apps = []
 sources = []
 env = dcenv.Clone()
@@ -0,0 +1,652 @@
+// Generate synthetic CODA events for the modules in a crate map, for
+// load testing the decoder and analyzer.
+//
+// Usage: evgen [options] output.dat
+//        evgen [options] -S ringname
+//   -c version    CODA version of the output, 2 or 3 (default 3)
+//   -n nevents    Number of physics events to generate (default 10000)
+//   -b blocklevel Events per CODA block, CODA 3 only (default 1)
+//   -o occupancy  Fraction of channels with hits (default 0.1)
+//   -m mult       Mean number of hits per channel with hits (default 1)
+//   -w nsamples   Include FADC raw window data with this many samples
+//   -d file       Crate map database file (default: db_cratemap.dat for -t)
+//   -t time       Unix time of the run, used for the control event time
+//                 stamps and the crate map lookup (default: now). With -t,
+//                 the output is the same each time for the same options.
+//   -R run        Run number (default 1)
+//   -r rate       Events per second (default: as fast as possible)
+//   -x seed       Random number seed (default 1)
+//   -S ringname   Stream the events to a shared-memory ring (see
+//                 THaShmClient) instead of writing a file
+//   -k kwords     Ring slot size in units of 1024 words (default 256)
+//   -v            Print progress
+//
+// The payloads follow the data formats expected by the corresponding
+// decoder modules: Fadc250 (pulse integral/time and optional raw window),
+// Caen1190, F1TDC (3201/6401, normal resolution), Lecroy 1875/1877/1881
+// and the scalers 560/1151/3800/3801. Modules of other types are left
+// empty. Slots with a bank number in the crate map are written into
+// banks. In multiblock mode (-b > 1), the pipelining modules (Fadc250,
+// Caen1190) carry data for every event of the block, the others are
+// read out once per block, as the decoder expects.
+
+#include "THaCrateMap.h"
+#include "THaCodaFile.h"
+#include "ShmEventRing.h"
+#include "Decoder.h"
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <ctime>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>   // for getopt
+
+using namespace std;
+using namespace Decoder;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal( int )
+{
+  stop_requested = 1;
+}
+
+static void usage( const char* prg )
+{
+  cerr << "Usage: " << prg << " [-c version] [-n nevents] [-b blocklevel]"
+       << " [-o occupancy] [-m mult] [-w nsamples] [-d file] [-t time]"
+       << " [-R run] [-r rate] [-x seed] [-k kwords] [-v]"
+       << " {output.dat | -S ringname}" << endl;
+  exit(1);
+}
+
+//_____________________________________________________________________________
+// One module to be generated
+struct SlotGen {
+  UInt_t crate;
+  UInt_t slot;
+  Int_t  model;
+  UInt_t header;    // Header from crate map
+  UInt_t mask;      // Header mask from crate map
+  UInt_t nchan;     // Number of channels
+  std::vector<UInt_t> counts;  // Scaler counts
+};
+
+// Crate with its modules, grouped by bank
+struct CrateGen {
+  UInt_t crate;
+  Bool_t fastbus;
+  Bool_t banks;     // Crate has bank structure
+  std::map<Int_t,std::vector<SlotGen*>> bankslots;  // bank -> slots (-1: no bank)
+};
+
+// Bank number for modules without bank in a bank-structured crate
+static const Int_t kRawBank = 0xfffe;
+
+//_____________________________________________________________________________
+class EventGenerator {
+public:
+  EventGenerator( Int_t coda_version, UInt_t blocklevel, Double_t occupancy,
+                  Double_t mult, UInt_t nsamples, UInt_t seed )
+    : fCodaVersion(coda_version), fBlockLevel(blocklevel), fOcc(occupancy),
+      fMult(mult), fNsamples(nsamples), fRandom(seed), fFlat(0,1),
+      fExtraHits(mult > 1 ? mult - 1 : 0), fEvNum(0), fBlkNum(0), fTime(0),
+      fTSROC(0) {}
+
+  Int_t Init( const THaCrateMap& map );
+  const std::vector<UInt_t>& Physics();
+  const std::vector<UInt_t>& Control( UInt_t type, UInt_t time, UInt_t w1,
+                                      UInt_t w2 );
+  ULong64_t GetEvNum() const { return fEvNum; }
+
+private:
+  Int_t     fCodaVersion;
+  UInt_t    fBlockLevel;
+  Double_t  fOcc;
+  Double_t  fMult;
+  UInt_t    fNsamples;
+  std::mt19937 fRandom;
+  std::uniform_real_distribution<Double_t> fFlat;
+  std::poisson_distribution<UInt_t> fExtraHits;
+  ULong64_t fEvNum;      // Number of physics events generated
+  UInt_t    fBlkNum;     // Number of blocks generated
+  ULong64_t fTime;       // Trigger time stamp (4 ns ticks)
+  UInt_t    fTSROC;
+  std::vector<SlotGen>  fSlots;
+  std::vector<CrateGen> fCrates;
+  std::vector<UInt_t>   fBuf;
+  std::vector<ULong64_t> fTimes;   // Time stamps of events in current block
+
+  UInt_t Rndm( UInt_t n ) { return static_cast<UInt_t>(fFlat(fRandom) * n); }
+  Bool_t Fires()          { return fFlat(fRandom) < fOcc; }
+  UInt_t NHits( UInt_t maxhit );
+  void   Put64( ULong64_t val );
+  void   Fill( SlotGen& s );
+  void   FillFadc250( SlotGen& s );
+  void   FillCaen1190( SlotGen& s );
+  void   FillF1TDC( SlotGen& s );
+  void   FillFastbus( SlotGen& s );
+  void   FillScaler( SlotGen& s );
+  void   TriggerBank();
+};
+
+//_____________________________________________________________________________
+Int_t EventGenerator::Init( const THaCrateMap& map )
+{
+  // Set up the list of modules from the crate map
+
+  fSlots.clear();
+  fCrates.clear();
+  fTSROC = map.getTSROC();
+  size_t nslots = 0;
+  for( auto crate : map.GetUsedCrates() )
+    nslots += map.GetUsedSlots(crate).size();
+  fSlots.reserve(nslots);  // CrateGen holds pointers into fSlots
+  for( auto crate : map.GetUsedCrates() ) {
+    CrateGen cr{ crate, map.isFastBus(crate), map.isBankStructure(crate), {} };
+    for( auto slot : map.GetUsedSlots(crate) ) {
+      fSlots.push_back({ crate, slot, map.getModel(crate, slot),
+                         map.getHeader(crate, slot), map.getMask(crate, slot),
+                         map.getNchan(crate, slot), {} });
+      Int_t bank = map.getBank(crate, slot);
+      if( bank < 0 && cr.banks )
+        bank = kRawBank;
+      cr.bankslots[bank].push_back(&fSlots.back());
+    }
+    // The decoder looks for fastbus modules in order of decreasing slot
+    if( cr.fastbus ) {
+      for( auto& bs : cr.bankslots )
+        std::reverse(bs.second.begin(), bs.second.end());
+    }
+    fCrates.push_back(std::move(cr));
+  }
+  if( fCrates.empty() ) {
+    cerr << "ERROR: No crates defined in crate map" << endl;
+    return -1;
+  }
+  return 0;
+}
+
+//_____________________________________________________________________________
+UInt_t EventGenerator::NHits( UInt_t maxhit )
+{
+  // Number of hits in a channel that fired
+  UInt_t n = 1 + (fMult > 1 ? fExtraHits(fRandom) : 0);
+  return (n < maxhit) ? n : maxhit;
+}
+
+//_____________________________________________________________________________
+void EventGenerator::Put64( ULong64_t val )
+{
+  // Append 64-bit value in the byte order the decoder reads it
+  fBuf.push_back(static_cast<UInt_t>(val));
+  fBuf.push_back(static_cast<UInt_t>(val >> 32));
+}
+
+//_____________________________________________________________________________
+static inline UInt_t WithHeader( UInt_t word, const SlotGen& s )
+{
+  // Set the bits of 'word' that identify the slot to the crate map header
+  return (word & ~s.mask) | (s.header & s.mask);
+}
+
+//_____________________________________________________________________________
+void EventGenerator::FillFadc250( SlotGen& s )
+{
+  // One block of events: block header, per event an event header, trigger
+  // time and pulse data, block trailer with the total word count
+
+  const UInt_t nblk = fBlockLevel;
+  const UInt_t nchan = (s.nchan > 0 && s.nchan < 16) ? s.nchan : 16;
+  const UInt_t slot = (s.slot & 0x1f) << 22;
+  const size_t ibeg = fBuf.size();
+  fBuf.push_back(WithHeader(0x80000000 | slot | (1 << 18) |
+                            ((fBlkNum & 0x3ff) << 8) | (nblk & 0xff), s));
+  for( UInt_t iev = 0; iev < nblk; iev++ ) {
+    ULong64_t evnum = fEvNum + iev + 1, t = fTimes[iev];
+    fBuf.push_back(0x90000000 | slot | (evnum & 0xfff));
+    fBuf.push_back(0x98000000 | (t & 0xffffff));
+    fBuf.push_back((t >> 24) & 0xffffff);
+    for( UInt_t chan = 0; chan < nchan; chan++ ) {
+      if( !Fires() )
+        continue;
+      const UInt_t ch = chan << 23;
+      if( fNsamples > 0 ) {
+        fBuf.push_back(0xA0000000 | ch | fNsamples);
+        for( UInt_t i = 0; i < fNsamples; i += 2 ) {
+          UInt_t s1 = 100 + Rndm(50), s2 = 100 + Rndm(50);
+          fBuf.push_back((s1 << 16) | s2);
+        }
+      }
+      for( UInt_t ip = 0, np = NHits(4); ip < np; ip++ ) {
+        fBuf.push_back(0xB8000000 | ch | (ip << 21) | Rndm(0x7ffff));
+        fBuf.push_back(0xC0000000 | ch | (ip << 21) | Rndm(0x7fff));
+      }
+    }
+  }
+  fBuf.push_back(0x88000000 | slot | ((fBuf.size() + 1 - ibeg) & 0x3fffff));
+}
+
+//_____________________________________________________________________________
+void EventGenerator::FillCaen1190( SlotGen& s )
+{
+  // Per event: global header, header/data/trailer of each TDC chip,
+  // trigger time tag and global trailer with the total word count
+
+  const UInt_t nchan = (s.nchan > 0 && s.nchan < 128) ? s.nchan : 128;
+  const UInt_t nchip = (nchan + 31) / 32;
+  for( UInt_t iev = 0; iev < fBlockLevel; iev++ ) {
+    ULong64_t evnum = fEvNum + iev + 1;
+    const UInt_t evid = (evnum & 0xfff) << 12;
+    const size_t ibeg = fBuf.size();
+    fBuf.push_back(WithHeader(0x40000000 | ((evnum & 0x3fffff) << 5) |
+                              (s.slot & 0x1f), s));
+    for( UInt_t chip = 0; chip < nchip; chip++ ) {
+      const size_t ichip = fBuf.size();
+      fBuf.push_back(0x08000000 | (chip << 24) | evid | (fTimes[iev] & 0xfff));
+      for( UInt_t chan = chip*32; chan < (chip+1)*32 && chan < nchan; chan++ ) {
+        if( !Fires() )
+          continue;
+        for( UInt_t ih = 0, nh = NHits(16); ih < nh; ih++ )
+          fBuf.push_back((chan << 19) | Rndm(0x7ffff));
+      }
+      fBuf.push_back(0x18000000 | (chip << 24) | evid |
+                     ((fBuf.size() + 1 - ichip) & 0xfff));
+    }
+    fBuf.push_back(0x88000000 | (fTimes[iev] & 0x7ffffff));
+    fBuf.push_back(0x80000000 | (((fBuf.size() + 1 - ibeg) & 0xffff) << 5) |
+                   (s.slot & 0x1f));
+  }
+}
+
+//_____________________________________________________________________________
+void EventGenerator::FillF1TDC( SlotGen& s )
+{
+  // Header, data words, trailer. Every word carries the slot header.
+
+  const UInt_t DATA_MARKER = BIT(23), RES_LOCK = BIT(26);
+  const UInt_t nchan = (s.nchan > 0 && s.nchan < 64) ? s.nchan : 64;
+  const UInt_t slot = (s.slot & 0x1f) << 27;
+  const UInt_t hdr = WithHeader(slot | ((fEvNum + 1) & 0x3f) << 16 |
+                                (fTimes[0] & 0xffff), s);
+  fBuf.push_back(hdr);
+  for( UInt_t chan = 0; chan < nchan; chan++ ) {
+    if( !Fires() )
+      continue;
+    // Inverse of the channel reordering in F1TDCModule::LoadSlot
+    UInt_t ich = (chan & 0x20) | ((chan & 0xf) << 1) | ((chan >> 4) & 1);
+    for( UInt_t ih = 0, nh = NHits(16); ih < nh; ih++ )
+      fBuf.push_back(WithHeader(slot | RES_LOCK | DATA_MARKER | (ich << 16) |
+                                Rndm(0xffff), s));
+  }
+  fBuf.push_back(hdr);
+}
+
+//_____________________________________________________________________________
+void EventGenerator::FillFastbus( SlotGen& s )
+{
+  // Lecroy 1877 (multihit TDC), 1881 (ADC) and 1875 (TDC). The header
+  // of the 1877/1881 holds the word count, including the header itself.
+
+  const UInt_t slot = (s.slot & 0x1f) << 27;
+  const size_t ibeg = fBuf.size();
+  switch( s.model ) {
+  case 1877: {
+    const UInt_t nchan = (s.nchan > 0 && s.nchan < 96) ? s.nchan : 96;
+    fBuf.push_back(slot);
+    for( UInt_t chan = 0; chan < nchan; chan++ ) {
+      if( !Fires() )
+        continue;
+      for( UInt_t ih = 0, nh = NHits(16); ih < nh; ih++ )
+        fBuf.push_back(slot | (chan << 17) | Rndm(0xffff));
+    }
+    fBuf[ibeg] |= (fBuf.size() - ibeg) & 0x7ff;
+    break;
+  }
+  case 1881: {
+    const UInt_t nchan = (s.nchan > 0 && s.nchan < 64) ? s.nchan : 64;
+    fBuf.push_back(slot);
+    for( UInt_t chan = 0; chan < nchan; chan++ ) {
+      if( Fires() )
+        fBuf.push_back(slot | (chan << 17) | Rndm(0x3fff));
+    }
+    fBuf[ibeg] |= (fBuf.size() - ibeg) & 0x7f;
+    break;
+  }
+  case 1875: {
+    const UInt_t nchan = (s.nchan > 0 && s.nchan < 64) ? s.nchan : 64;
+    for( UInt_t chan = 0; chan < nchan; chan++ ) {
+      if( Fires() )
+        fBuf.push_back(slot | (chan << 16) | Rndm(0xfff));
+    }
+    break;
+  }
+  }
+}
+
+//_____________________________________________________________________________
+void EventGenerator::FillScaler( SlotGen& s )
+{
+  // Header with the number of channels, followed by the counts
+
+  const UInt_t nchan = (s.nchan > 0 && s.nchan <= 0xff) ? s.nchan : 32;
+  if( s.counts.size() != nchan )
+    s.counts.assign(nchan, 0);
+  fBuf.push_back(WithHeader(nchan, s));
+  for( auto& count : s.counts ) {
+    count += Rndm(1000);
+    fBuf.push_back(count);
+  }
+}
+
+//_____________________________________________________________________________
+void EventGenerator::Fill( SlotGen& s )
+{
+  switch( s.model ) {
+  case 250:
+    FillFadc250(s);
+    break;
+  case 1190:
+    FillCaen1190(s);
+    break;
+  case 3201:
+  case 6401:
+    FillF1TDC(s);
+    break;
+  case 1875:
+  case 1877:
+  case 1881:
+    FillFastbus(s);
+    break;
+  case 560:
+  case 1151:
+  case 3800:
+  case 3801:
+    FillScaler(s);
+    break;
+  default:
+    break;  // Unsupported model. Nothing to generate.
+  }
+}
+
+//_____________________________________________________________________________
+void EventGenerator::TriggerBank()
+{
+  // CODA 3 trigger bank with time stamps, followed by one segment
+  // of per-event time stamps for each ROC
+
+  const UInt_t nblk = fBlockLevel;
+  const UInt_t nroc = fCrates.size();
+  const size_t ibeg = fBuf.size();
+  fBuf.push_back(0);
+  fBuf.push_back((0xff21U << 16) | (0x20 << 8) | (nroc & 0xff));
+  // Segment 1: event number and time stamps
+  fBuf.push_back((fTSROC << 24) | (0x0a << 16) | (2 * (1 + nblk)));
+  Put64(fEvNum + 1);
+  for( auto t : fTimes )
+    Put64(t);
+  // Segment 2: event types, 16 bits each
+  fBuf.push_back((fTSROC << 24) | (0x05 << 16) | ((nblk - 1) / 2 + 1));
+  for( UInt_t i = 0; i < nblk; i += 2 )
+    fBuf.push_back(1 | ((i + 1 < nblk) ? (1 << 16) : 0));
+  // ROC segments
+  for( const auto& cr : fCrates ) {
+    fBuf.push_back(((cr.crate & 0xff) << 24) | (0x0a << 16) | (2 * nblk));
+    for( auto t : fTimes )
+      Put64(t);
+  }
+  fBuf[ibeg] = fBuf.size() - ibeg - 1;
+}
+
+//_____________________________________________________________________________
+const std::vector<UInt_t>& EventGenerator::Physics()
+{
+  // Generate the next physics event. For CODA 3, this is a block of
+  // fBlockLevel events.
+
+  const UInt_t nblk = fBlockLevel;
+  fTimes.resize(nblk);
+  for( auto& t : fTimes )
+    t = (fTime += 250 + Rndm(250));  // 1-2 us between triggers
+
+  fBuf.clear();
+  fBuf.push_back(0);
+  if( fCodaVersion == 2 ) {
+    fBuf.push_back((1 << 16) | 0x10cc);
+    fBuf.push_back(4);
+    fBuf.push_back(0xC0000100);
+    fBuf.push_back(static_cast<UInt_t>(fEvNum + 1));
+    fBuf.push_back(0);
+    fBuf.push_back(0);
+  } else {
+    fBuf.push_back((0xff50U << 16) | (0x10 << 8) | (nblk & 0xff));
+    TriggerBank();
+  }
+
+  for( auto& cr : fCrates ) {
+    const size_t iroc = fBuf.size();
+    fBuf.push_back(0);
+    fBuf.push_back((cr.crate << 16) | ((cr.banks ? 0x10 : 0x01) << 8) |
+                   (fCodaVersion == 2 ? ((fEvNum + 1) & 0xff) : nblk));
+    for( auto& bs : cr.bankslots ) {
+      size_t ibank = 0;
+      if( cr.banks ) {
+        ibank = fBuf.size();
+        fBuf.push_back(0);
+        fBuf.push_back((UInt_t(bs.first) << 16) | (0x01 << 8) | nblk);
+      }
+      for( auto* s : bs.second )
+        Fill(*s);
+      if( cr.banks )
+        fBuf[ibank] = fBuf.size() - ibank - 1;
+    }
+    fBuf[iroc] = fBuf.size() - iroc - 1;
+  }
+  fBuf[0] = fBuf.size() - 1;
+  fEvNum += nblk;
+  ++fBlkNum;
+  return fBuf;
+}
+
+//_____________________________________________________________________________
+const std::vector<UInt_t>& EventGenerator::Control( UInt_t type, UInt_t time,
+                                                    UInt_t w1, UInt_t w2 )
+{
+  // Prestart, go or end event
+
+  UInt_t tag = type;
+  if( fCodaVersion != 2 ) {
+    switch( type ) {
+    case PRESTART_EVTYPE: tag = 0xffd1; break;
+    case GO_EVTYPE:       tag = 0xffd2; break;
+    case END_EVTYPE:      tag = 0xffd4; break;
+    }
+  }
+  fBuf.assign({ 4, (tag << 16) | (0x01 << 8) | (fCodaVersion == 2 ? 0xcc : 0),
+                time, w1, w2 });
+  return fBuf;
+}
+
+//_____________________________________________________________________________
+int main( int argc, char* argv[] )
+{
+  Int_t coda_version = 3;
+  ULong64_t nevents = 10000;
+  UInt_t blocklevel = 1, nsamples = 0, runnum = 1, seed = 1, kwords = 256;
+  Double_t occupancy = 0.1, mult = 1, rate = 0;
+  ULong64_t maptime = time(nullptr);
+  bool fixed_time = false;
+  const char* mapfile = nullptr;
+  const char* ringname = nullptr;
+  bool verbose = false;
+
+  int opt;
+  while( (opt = getopt(argc, argv, "c:n:b:o:m:w:d:t:R:r:x:S:k:vh")) != -1 ) {
+    switch( opt ) {
+    case 'c':
+      coda_version = atoi(optarg);
+      break;
+    case 'n':
+      nevents = strtoull(optarg, nullptr, 10);
+      break;
+    case 'b':
+      blocklevel = atoi(optarg);
+      break;
+    case 'o':
+      occupancy = atof(optarg);
+      break;
+    case 'm':
+      mult = atof(optarg);
+      break;
+    case 'w':
+      nsamples = atoi(optarg);
+      break;
+    case 'd':
+      mapfile = optarg;
+      break;
+    case 't':
+      maptime = strtoull(optarg, nullptr, 10);
+      fixed_time = true;
+      break;
+    case 'R':
+      runnum = atoi(optarg);
+      break;
+    case 'r':
+      rate = atof(optarg);
+      break;
+    case 'x':
+      seed = atoi(optarg);
+      break;
+    case 'S':
+      ringname = optarg;
+      break;
+    case 'k':
+      kwords = atoi(optarg);
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if( argc - optind != (ringname ? 0 : 1) )
+    usage(argv[0]);
+  if( coda_version != 2 && coda_version != 3 ) {
+    cerr << "ERROR: CODA version must be 2 or 3" << endl;
+    return 1;
+  }
+  if( blocklevel == 0 || blocklevel > 255 ||
+      (coda_version == 2 && blocklevel > 1) ) {
+    cerr << "ERROR: Block level must be 1-255, and 1 for CODA 2" << endl;
+    return 1;
+  }
+  if( occupancy < 0 || occupancy > 1 || mult < 1 || rate < 0 || kwords == 0 ) {
+    cerr << "ERROR: Invalid occupancy, multiplicity, rate or slot size" << endl;
+    return 1;
+  }
+  nsamples = (nsamples + 1) & ~1U;  // FADC samples come in pairs
+  if( nsamples > 0xfff ) {
+    cerr << "ERROR: Too many FADC samples" << endl;
+    return 1;
+  }
+
+  THaCrateMap map;
+  Int_t st;
+  if( mapfile ) {
+    FILE* fi = fopen(mapfile, "r");
+    if( !fi ) {
+      cerr << "ERROR: Cannot open crate map file " << mapfile << endl;
+      return 2;
+    }
+    st = map.init(fi, mapfile);
+    fclose(fi);
+  } else
+    st = map.init(maptime);
+  if( st != THaCrateMap::CM_OK ) {
+    cerr << "ERROR: Cannot initialize crate map" << endl;
+    return 2;
+  }
+
+  EventGenerator gen(coda_version, blocklevel, occupancy, mult, nsamples, seed);
+  if( gen.Init(map) != 0 )
+    return 2;
+
+  THaCodaFile outfile;
+  ShmEventRing ring;
+  if( ringname ) {
+    if( ring.Create(ringname, 1024, kwords * 1024, coda_version) != 0 )
+      return 3;
+  } else if( outfile.codaOpen(argv[optind], "w") != CODA_OK ) {
+    cerr << "ERROR: Cannot open output file " << argv[optind] << endl;
+    return 3;
+  }
+  auto put = [&]( const std::vector<UInt_t>& ev ) -> Int_t {
+    if( ringname )
+      return ring.Put(ev.data());
+    return outfile.codaWrite(ev.data()) == CODA_OK ? 0 : -1;
+  };
+
+  signal(SIGINT, handle_signal);
+  signal(SIGTERM, handle_signal);
+
+  const auto runtime = static_cast<UInt_t>(maptime);
+  put(gen.Control(PRESTART_EVTYPE, runtime, runnum, 0));
+  put(gen.Control(GO_EVTYPE, runtime, 0, 0));
+
+  using clock = chrono::steady_clock;
+  const auto interval = chrono::duration_cast<clock::duration>(
+    chrono::duration<double>(rate > 0 ? blocklevel/rate : 0));
+  auto next = clock::now();
+  const auto t0 = next;
+  ULong64_t nwords = 0, nskipped = 0, nextprint = 10000;
+  Int_t ret = 0;
+
+  while( gen.GetEvNum() < nevents && !stop_requested ) {
+    if( rate > 0 ) {
+      this_thread::sleep_until(next);
+      next += interval;
+    }
+    const auto& ev = gen.Physics();
+    if( put(ev) != 0 ) {
+      if( !ringname ) {
+        cerr << "ERROR: Writing event " << gen.GetEvNum() << endl;
+        ret = 4;
+        break;
+      }
+      if( nskipped++ == 0 )
+        cerr << "WARNING: event " << gen.GetEvNum() << " too large for ring "
+             << "slot (" << ev.size() << " words). Increase -k. "
+             << "Skipping large events." << endl;
+      continue;
+    }
+    nwords += ev.size();
+    if( verbose && gen.GetEvNum() >= nextprint ) {
+      cout << gen.GetEvNum() << " events" << endl;
+      nextprint += 10000;
+    }
+  }
+
+  const auto endtime = fixed_time ? runtime : static_cast<UInt_t>(time(nullptr));
+  put(gen.Control(END_EVTYPE, endtime, 0, static_cast<UInt_t>(gen.GetEvNum())));
+  if( ringname )
+    ring.SetEndOfRun();
+  else
+    outfile.codaClose();
+
+  double elapsed = chrono::duration<double>(clock::now() - t0).count();
+  cout << "evgen: " << gen.GetEvNum() << " events, "
+       << nwords * sizeof(UInt_t) / 1048576.0 << " MB in " << elapsed << " s";
+  if( elapsed > 0 )
+    cout << " (" << gen.GetEvNum() / elapsed << " Hz)";
+  if( nskipped > 0 )
+    cout << ", " << nskipped << " too large, skipped";
+  cout << endl;
+  return ret;
+}
@@ -0,0 +1,134 @@
+// Replay a CODA file into a shared-memory event ring for online
+// analysis with THaShmClient.
+//
+// Usage: shmprod [options] ringname file.dat
+//   -r rate    Events per second (default: as fast as possible)
+//   -n nslots  Number of events in the ring (default 1024)
+//   -s kwords  Maximum event size in units of 1024 words (default 256)
+//   -l loops   Replay the file this many times, 0 = forever (default 1)
+//   -v         Print progress
+
+#include "THaCodaFile.h"
+#include "ShmEventRing.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <cstdlib>
+#include <unistd.h>   // for getopt
+
+using namespace std;
+using namespace Decoder;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal( int )
+{
+  stop_requested = 1;
+}
+
+static void usage( const char* prg )
+{
+  cerr << "Usage: " << prg << " [-r rate] [-n nslots] [-s kwords] [-l loops] [-v]"
+       << " ringname file.dat" << endl;
+  exit(1);
+}
+
+int main( int argc, char* argv[] )
+{
+  double rate = 0;
+  UInt_t nslots = 1024, kwords = 256, nloops = 1;
+  bool verbose = false;
+
+  int opt;
+  while( (opt = getopt(argc, argv, "r:n:s:l:vh")) != -1 ) {
+    switch( opt ) {
+    case 'r':
+      rate = atof(optarg);
+      break;
+    case 'n':
+      nslots = atoi(optarg);
+      break;
+    case 's':
+      kwords = atoi(optarg);
+      break;
+    case 'l':
+      nloops = atoi(optarg);
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if( argc - optind != 2 || nslots == 0 || kwords == 0 || rate < 0 )
+    usage(argv[0]);
+  const char* ringname = argv[optind];
+  const char* filename = argv[optind+1];
+
+  THaCodaFile datafile;
+  if( datafile.codaOpen(filename) != CODA_OK ) {
+    cerr << "ERROR: Cannot open CODA file " << filename << endl;
+    return 2;
+  }
+  Int_t coda_version = datafile.getCodaVersion();
+  if( coda_version < 0 ) {
+    cerr << "ERROR: Cannot determine CODA version of " << filename << endl;
+    return 2;
+  }
+
+  ShmEventRing ring;
+  if( ring.Create(ringname, nslots, kwords * 1024, coda_version) != 0 )
+    return 3;
+
+  signal(SIGINT, handle_signal);
+  signal(SIGTERM, handle_signal);
+
+  using clock = chrono::steady_clock;
+  const auto interval = chrono::duration_cast<clock::duration>(
+    chrono::duration<double>(rate > 0 ? 1.0/rate : 0));
+  auto next = clock::now();
+  const auto t0 = next;
+  ULong64_t nev = 0, nskipped = 0;
+
+  for( UInt_t iloop = 0; (nloops == 0 || iloop < nloops) && !stop_requested;
+       ++iloop ) {
+    if( iloop > 0 && datafile.codaOpen(filename) != CODA_OK ) {
+      cerr << "ERROR: Cannot reopen CODA file " << filename << endl;
+      break;
+    }
+    Int_t status;
+    while( !stop_requested && (status = datafile.codaRead()) == CODA_OK ) {
+      if( rate > 0 ) {
+        this_thread::sleep_until(next);
+        next += interval;
+      }
+      if( ring.Put(datafile.getEvBuffer()) != 0 ) {
+        if( nskipped++ == 0 )
+          cerr << "WARNING: event " << nev << " too large for ring slot "
+               << "(" << datafile.getEvBuffer()[0]+1 << " words). "
+               << "Increase -s. Skipping large events." << endl;
+        continue;
+      }
+      ++nev;
+      if( verbose && nev % 10000 == 0 )
+        cout << nev << " events" << endl;
+    }
+    if( status != CODA_EOF && !stop_requested ) {
+      cerr << "ERROR: reading " << filename << ", status = " << status << endl;
+      break;
+    }
+    datafile.codaClose();
+  }
+
+  ring.SetEndOfRun();
+  double elapsed = chrono::duration<double>(clock::now() - t0).count();
+  cout << "shmprod: " << nev << " events in " << elapsed << " s";
+  if( elapsed > 0 )
+    cout << " (" << nev / elapsed << " Hz)";
+  if( nskipped > 0 )
+    cout << ", " << nskipped << " too large, skipped";
+  cout << endl;
+  return 0;
+}
@@ -30,6 +30,7 @@
 #pragma link C++ class Decoder::THaCodaFile+;
 #pragma link C++ class Decoder::THaCrateMap+;
 #pragma link C++ class Decoder::THaEpics+;
+#pragma link C++ class Decoder::THaShmClient+;
 #pragma link C++ class Decoder::THaSlotData+;
 #pragma link C++ class Decoder::THaUsrstrutils+;
 
@@ -81,7 +81,7 @@ THaVDCSimConditions::THaVDCSimConditions()
     ysigma(0.01), z0(-1.0),
     pthetamean(TMath::Pi()/4.0), pthetasigma(atan(1.1268) - TMath::Pi()/4.0),
     pphimean(0.0), pphisigma(atan(0.01846)), pmag0(1.0), tdcConvertFactor(2.0),
-    cellWidth(0.0042426), cellHeight(0.026)
+    cellWidth(0.0042426), cellHeight(0.026), seed(0)
 {
   // Constructor - determine the name of the database file
 
@@ -45,13 +45,14 @@ class THaVDCSimConditions : public TObject {
   Double_t tdcConvertFactor;  //width of single time bin (in ns), used to convert from time to tdc values
   Double_t cellWidth;  //width of cell (i.e. horizontal spacing between sense wires)
   Double_t cellHeight; //height of cell (i.e. vertical spacing between u and v wire planes)
+  ULong64_t seed;      //random number seed
 
   static void set(Double_t *something,
 	   Double_t a, Double_t b, Double_t c, Double_t d);
 
   Int_t ReadDatabase(Double_t* timeOffsets);
 
-  ClassDef (THaVDCSimConditions, 5) // Simulation Conditions
+  ClassDef (THaVDCSimConditions, 6) // Simulation Conditions
 };
 
 class THaVDCSimWireHit : public TObject {
@@ -7,6 +7,12 @@
 //        angles: tan angle
 //        mass: 1 (momentum == velocity)
 
+// Events are generated in parallel by several threads, each working on
+// consecutive chunks of events. The random numbers of each event are
+// drawn from a counter-based generator keyed by the seed and the event
+// number, so the output is the same for any number of threads. The
+// chunks are written to the tree in event order.
+
 #include "THaVDCSim.h"
 
 #include "TFile.h"
@@ -14,7 +20,7 @@
 #include "TH2.h"
 #include "TProfile.h"
 #include "TNtuple.h"
-#include "TRandom.h"
+#include "TROOT.h"
 #include "TVector3.h"
 #include "TString.h"
 #include "TMath.h"
@@ -22,8 +28,18 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <cmath>     // for lround, fabs
 #include <fstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <libgen.h>  // for basename
 
 using namespace std;
@@ -34,6 +50,7 @@ void usage();
 
 static bool verbose = false;
 static const char* progname = "";
+static UInt_t nthreads = 0;  // 0 = number of hardware threads
 
 //______________________________________________________________________________
 int main(int argc, char *argv[])
@@ -61,7 +78,9 @@ void usage()
   puts(" -r <emission rate> Target's Emission Rate (IN kHz). Default is 2 kHz");
   puts(" -c <Chamber Noise> Probability of random wires firing within the chamber. Default is 0.0");
   puts(" -t <tdc time window> Length of time the TDCs can collect data (in ns). Default is 900");
-  puts(" -v Verbose mode, print hit and track info for each plane");
+  puts(" -x <seed> Random number seed. Default is 0");
+  puts(" -j <threads> Number of threads. Default is the number of CPUs");
+  puts(" -v Verbose mode, print hit and track info for each plane (single thread)");
   exit(1);
 }
 
@@ -167,6 +186,26 @@ void getargs( int argc, char *argv[], THaVDCSimConditions* s )
 	    usage();
 	  opt = "?";
 	  break;
+	case 'x':
+	  if(!*++opt){
+	    if(argc-- <1)
+	      usage();
+	    opt = *++argv;
+	  }
+	  s->seed = strtoull(opt, nullptr, 0);
+	  opt = "?";
+	  break;
+	case 'j':
+	  if(!*++opt){
+	    if(argc-- <1)
+	      usage();
+	    opt = *++argv;
+	  }
+	  if( atoi(opt) < 1 )
+	    usage();
+	  nthreads = atoi(opt);
+	  opt = "?";
+	  break;
 	case 'v':
 	  verbose = true;
 	  break;
@@ -220,41 +259,237 @@ bool IntersectPlaneWithRay( const TVector3& xax, const TVector3& yax,
   return true;
 }
 
+
 //______________________________________________________________________________
-int vdcsimgen( THaVDCSimConditions* s )
-{
-  // Create a new ROOT binary machine independent file.
-  // This file is now becoming the current directory.
-  TFile hfile(s->filename,"RECREATE","ROOT file for VDC simulation");
+class EventRandom {
+  // Counter-based random number generator (Philox4x32-10, Salmon et al.,
+  // SC11). The random numbers of an event depend only on the seed and the
+  // event number, so events can be generated in any order by any thread.
+public:
+  explicit EventRandom( ULong64_t seed )
+    : fKey{ UInt_t(seed), UInt_t(seed >> 32) }, fCtr{}, fOut{}, fNext(4),
+      fHaveGaus(false), fGaus(0) {}
+
+  // Start the random number sequence of event 'iev'
+  void SetEvent( ULong64_t iev ) {
+    fCtr[0] = fCtr[1] = 0;
+    fCtr[2] = UInt_t(iev);
+    fCtr[3] = UInt_t(iev >> 32);
+    fNext = 4;
+    fHaveGaus = false;
+  }
+  // Uniform in (0,1)
+  Double_t Rndm() {
+    if( fNext == 4 )
+      Generate();
+    return (fOut[fNext++] + 0.5) * (1.0 / 4294967296.0);
+  }
+  // Gaussian (Box-Muller)
+  Double_t Gaus( Double_t mean = 0, Double_t sigma = 1 ) {
+    if( fHaveGaus ) {
+      fHaveGaus = false;
+      return mean + sigma * fGaus;
+    }
+    Double_t r = sqrt(-2.0 * log(Rndm())), phi = TMath::TwoPi() * Rndm();
+    fGaus = r * sin(phi);
+    fHaveGaus = true;
+    return mean + sigma * r * cos(phi);
+  }
 
-  // Define the z-positions of the wire planes
-  THaVDCSimConditions::set(s->wireHeight,
-                           0.0, 0.026, 0.3348, 0.3609);
-  
-  //calculate probability using Poisson distribution
-  Double_t probability = 1.0 - exp(-s->emissionRate*s->tdcTimeLimit);
+private:
+  UInt_t   fKey[2];
+  UInt_t   fCtr[4];
+  UInt_t   fOut[4];
+  UInt_t   fNext;      // Index of next unused word in fOut
+  Bool_t   fHaveGaus;  // Second Box-Muller value available
+  Double_t fGaus;
+
+  static void MulHiLo( UInt_t a, UInt_t b, UInt_t& hi, UInt_t& lo ) {
+    ULong64_t p = ULong64_t(a) * b;
+    hi = UInt_t(p >> 32);
+    lo = UInt_t(p);
+  }
+  void Generate() {
+    UInt_t c[4] = { fCtr[0], fCtr[1], fCtr[2], fCtr[3] };
+    UInt_t k[2] = { fKey[0], fKey[1] };
+    for( int r = 0; r < 10; r++ ) {
+      UInt_t hi0, lo0, hi1, lo1;
+      MulHiLo(0xD2511F53, c[0], hi0, lo0);
+      MulHiLo(0xCD9E8D57, c[2], hi1, lo1);
+      c[0] = hi1 ^ c[1] ^ k[0];
+      c[1] = lo1;
+      c[2] = hi0 ^ c[3] ^ k[1];
+      c[3] = lo0;
+      k[0] += 0x9E3779B9;
+      k[1] += 0xBB67AE85;
+    }
+    for( int i = 0; i < 4; i++ )
+      fOut[i] = c[i];
+    if( ++fCtr[0] == 0 )
+      ++fCtr[1];
+    fNext = 0;
+  }
+};
 
-  //hardcode prefixes for wire planes.
-  s->Prefixes[0] = "L.vdc.u1";
-  s->Prefixes[1] = "L.vdc.v1";
-  s->Prefixes[2] = "L.vdc.u2";
-  s->Prefixes[3] = "L.vdc.v2";
+//______________________________________________________________________________
+struct VDCSimHistos {
+  // Histograms filled by the generator. Each thread fills its own set.
+  explicit VDCSimHistos( const char* sfx = "" );
+  ~VDCSimHistos();
+  void Add( const VDCSimHistos& rhs );
+  void Write();
+
+  TH1 *wireU1, *wireV1, *wireU2, *wireV2;
+  TH1 *numwiresU1, *numwiresV1, *numwiresU2, *numwiresV2;
+  TH1 *timeV1, *distV1;
+  TH2 *origin;
+  TH1 *drift, *driftNoise;
+  TH2 *drift2;
+  TH1 *deltaT4, *deltaTNoise4, *deltaT5, *deltaTNoise5, *deltaT6, *deltaTNoise6;
+  TH1 *numtracks;
+  vector<TH1*> all;
+};
 
-  auto* timeOffsets = new Double_t[4*s->numWires];
- 
-  //get time offsets and drift velocities from the file (default is 20030415/L.vdc.dat)
-  Int_t getoffset = s->ReadDatabase(timeOffsets); 
-  if(getoffset != 0) {
-    cout << "Error Reading Database file: " << s->databaseFile << endl; 
-    exit(1);
+//______________________________________________________________________________
+VDCSimHistos::VDCSimHistos( const char* sfx )
+{
+  // Create the histograms. Histograms with a nonempty name suffix 'sfx'
+  // are private to one thread and not attached to any directory.
+
+  bool private_set = (*sfx != 0);
+  bool add_dir = TH1::AddDirectoryStatus();
+  if( private_set )
+    TH1::AddDirectory(false);
+  auto name = [sfx]( const char* n ) { return TString(n) + sfx; };
+
+  all = {
+    wireU1 = new TH1F(name("hwireU1"), "Wire Hit Map U1 Plane", 100, -5, 400),
+    wireV1 = new TH1F(name("hwireV1"), "Wire Hit Map V1 Plane", 100, -5, 400),
+    wireU2 = new TH1F(name("hwireU2"), "Wire Hit Map U2 Plane", 100, -5, 400),
+    wireV2 = new TH1F(name("hwireV2"), "Wire Hit Map V2 Plane", 100, -5, 400),
+    timeV1 = new TH1F(name("htimeV1"), "Drift Times for V1 Plane", 200, 0, 0.0000005),
+    distV1 = new TH1F(name("hdistV1"), "Drift Distances for V1 Plane",200, 0, 0.02),
+    numwiresU1 = new TH1F(name("hnumwiresU1"), "Number of wires triggered in U1 Plane", 10, 0, 10),
+    numwiresV1 = new TH1F(name("hnumwiresV1"), "Number of wires triggered in V1 Plane", 10, 0, 10),
+    numwiresU2 = new TH1F(name("hnumwiresU2"), "Number of wires triggered in U2 Plane", 10, 0, 10),
+    numwiresV2 = new TH1F(name("hnumwiresV2"), "Number of wires triggered in V2 Plane", 10, 0, 10),
+    origin = new TH2F(name("horigin"),"Origin Y vs. X",100,-1.2,1.2,100,-.1,.1),
+    drift = new TH1F(name("hdrift"),"Drift Time", 100, 1000, 2000),
+    drift2 = new TH2F(name("hdrift2"), "Drift Time vs Num Wires in Cluster",
+                      6, 3, 9, 100, 1000, 2000),
+    driftNoise = new TH1F(name("hdriftNoise"), "Drift Time (With Noise)", 100, 1000, 2000),
+    deltaT4 = new TH1F(name("hdeltaT4"), "Relative Time (4 hits)", 200, -100, 100),
+    deltaTNoise4 = new TH1F(name("hdeltaTNoise4"), "Relative Time (4 hits w/ Noise)", 200, -100, 100),
+    deltaT5 = new TH1F(name("hdeltaT5"), "Relative Time (5 hits)", 200, -100, 100),
+    deltaTNoise5 = new TH1F(name("hdeltaTNoise5"), "Relative Time (5 hits w/ Noise)", 200, -100, 100),
+    deltaT6 = new TH1F(name("hdeltaT6"), "Relative Time (6 hits)", 200, -100, 100),
+    deltaTNoise6 = new TH1F(name("hdeltaTNoise6"), "Relative Time (6 hits w/ Noise)", 200, -100, 100),
+    numtracks = new TH1F(name("hnumtracks"), "Number of Tracks Per Event", 5, 0, 5)
+  };
+  if( private_set ) {
+    TH1::AddDirectory(add_dir);
+  } else {
+    // Histograms in the output file are deleted when the file is closed
+    all.clear();
   }
+}
+
+//______________________________________________________________________________
+VDCSimHistos::~VDCSimHistos()
+{
+  for( auto* h : all )
+    delete h;
+}
+
+//______________________________________________________________________________
+void VDCSimHistos::Add( const VDCSimHistos& rhs )
+{
+  wireU1->Add(rhs.wireU1);
+  wireV1->Add(rhs.wireV1);
+  wireU2->Add(rhs.wireU2);
+  wireV2->Add(rhs.wireV2);
+  timeV1->Add(rhs.timeV1);
+  distV1->Add(rhs.distV1);
+  numwiresU1->Add(rhs.numwiresU1);
+  numwiresV1->Add(rhs.numwiresV1);
+  numwiresU2->Add(rhs.numwiresU2);
+  numwiresV2->Add(rhs.numwiresV2);
+  origin->Add(rhs.origin);
+  drift->Add(rhs.drift);
+  drift2->Add(rhs.drift2);
+  driftNoise->Add(rhs.driftNoise);
+  deltaT4->Add(rhs.deltaT4);
+  deltaTNoise4->Add(rhs.deltaTNoise4);
+  deltaT5->Add(rhs.deltaT5);
+  deltaTNoise5->Add(rhs.deltaTNoise5);
+  deltaT6->Add(rhs.deltaT6);
+  deltaTNoise6->Add(rhs.deltaTNoise6);
+  numtracks->Add(rhs.numtracks);
+}
+
+//______________________________________________________________________________
+void VDCSimHistos::Write()
+{
+  wireU1->Write();
+  wireV1->Write();
+  wireU2->Write();
+  wireV2->Write();
+  timeV1->Write();
+  distV1->Write();
+  numwiresU1->Write();
+  numwiresV1->Write();
+  numwiresU2->Write();
+  numwiresV2->Write();
+  origin->Write();
+  drift->Write();
+  drift2->Write();
+  driftNoise->Write();
+  deltaT4->Write();
+  deltaTNoise4->Write();
+  deltaT5->Write();
+  deltaTNoise5->Write();
+  deltaT6->Write();
+  deltaTNoise6->Write();
+  numtracks->Write();
+}
+
+//______________________________________________________________________________
+class VDCSimGenerator {
+  // Detector geometry and the event generation procedure. Const, so that
+  // it can be shared by all threads.
+public:
+  VDCSimGenerator( const THaVDCSimConditions* cond, const Double_t* offsets );
+
+  void GenerateEvent( EventRandom& rnd, VDCSimHistos& h,
+                      THaVDCSimEvent* event, ostream* text ) const;
+
+private:
+  const THaVDCSimConditions* s;
+  const Double_t* timeOffsets;
+  Double_t probability;
+  Double_t wireAngle[4];
+  Double_t wireOffset[4];
+  Double_t wireSpacing[4];
+  Double_t fA1tdcCor[4];
+  Double_t fA2tdcCor[4];
+  TVector3 vdcx, vdcy, vdcz;
+  TVector3 planeOrigin[4];
+};
+
+//______________________________________________________________________________
+VDCSimGenerator::VDCSimGenerator( const THaVDCSimConditions* cond,
+                                  const Double_t* offsets )
+  : s(cond), timeOffsets(offsets)
+{
+  //calculate probability using Poisson distribution
+  probability = 1.0 - exp(-s->emissionRate*s->tdcTimeLimit);
 
   // Various constants. FIXME: should be in a database
 
   // Wire rotation angles wrt detector coordinates - this is the angle about the z-axis
   // that the u axis is rotated wrt to the x-axis.
-  const Double_t wireAngle[4] = { -TMath::Pi()/4.0, TMath::Pi()/4.0,
-				  -TMath::Pi()/4.0, TMath::Pi()/4.0 };
+  THaVDCSimConditions::set(wireAngle, -TMath::Pi()/4.0, TMath::Pi()/4.0,
+                           -TMath::Pi()/4.0, TMath::Pi()/4.0);
 
   // Wire coordinate offsets and spacings (meters). The offset is the u (v)
   // position of wire #0 of each plane.
@@ -262,544 +497,641 @@ int vdcsimgen( THaVDCSimConditions* s )
   // numbers have smaller u (v) positions than wire #0. We account for this
   // by using a negative wire spacing.
 
-  const Double_t wireOffset[4]  = { 0.77852, 0.77852, 1.02718, 1.02718 };
-  const Double_t wireSpacing[4] = { -s->cellWidth, -s->cellWidth,
-				    -s->cellWidth, -s->cellWidth };
+  THaVDCSimConditions::set(wireOffset, 0.77852, 0.77852, 1.02718, 1.02718);
+  THaVDCSimConditions::set(wireSpacing, -s->cellWidth, -s->cellWidth,
+                           -s->cellWidth, -s->cellWidth);
 
   // Polynomial coefficients used in time-to-distance conversion
-  const Double_t fA1tdcCor[4] = { 2.12e-3, 0.0, 0.0, 0.0 };
-  const Double_t fA2tdcCor[4] = { -4.20e-4, 1.3e-3, 1.06e-4, 0.0 };
+  THaVDCSimConditions::set(fA1tdcCor, 2.12e-3, 0.0, 0.0, 0.0);
+  THaVDCSimConditions::set(fA2tdcCor, -4.20e-4, 1.3e-3, 1.06e-4, 0.0);
 
-  // Define orientation of the VDC planes. 
+  // Define orientation of the VDC planes.
   // Allow an arbitrary rotation about the lab y-axis.
   const Double_t rot = 0.0; // Assume VDC exactly horizontal in lab
-  const TVector3 vdcx( TMath::Cos(rot), 0.0, TMath::Sin(rot) );
-  const TVector3 vdcy( 0.0, 1.0, 0.0 );
-  const TVector3 vdcz = vdcx.Cross(vdcy);
-  TVector3 planeOrigin[4];
+  vdcx.SetXYZ( TMath::Cos(rot), 0.0, TMath::Sin(rot) );
+  vdcy.SetXYZ( 0.0, 1.0, 0.0 );
+  vdcz = vdcx.Cross(vdcy);
   for( int j=0; j<4; j++ )
     planeOrigin[j] += vdcz * s->wireHeight[j];
+}
 
-  // Create some histograms, a profile histogram and an ntuple
-  //TH1 *hwire   = new TH1F("hwire","Wire Hit Map",100,-5,400);
-  TH1 *hwireU1 = new TH1F("hwireU1", "Wire Hit Map U1 Plane", 100, -5, 400);
-  TH1 *hwireV1 = new TH1F("hwireV1", "Wire Hit Map V1 Plane", 100, -5, 400);
-  TH1 *hwireU2 = new TH1F("hwireU2", "Wire Hit Map U2 Plane", 100, -5, 400);
-  TH1 *hwireV2 = new TH1F("hwireV2", "Wire Hit Map V2 Plane", 100, -5, 400);
-  TH1 *hnumwiresU1 = new TH1F("hnumwiresU1", "Number of wires triggered in U1 Plane", 10, 0, 10);
-  TH1 *hnumwiresV1 = new TH1F("hnumwiresV1", "Number of wires triggered in V1 Plane", 10, 0, 10);
-  TH1 *hnumwiresU2 = new TH1F("hnumwiresU2", "Number of wires triggered in U2 Plane", 10, 0, 10);
-  TH1 *hnumwiresV2 = new TH1F("hnumwiresV2", "Number of wires triggered in V2 Plane", 10, 0, 10);
-  TH1 *htimeV1 = new TH1F("htimeV1", "Drift Times for V1 Plane", 200, 0, 0.0000005);
-  TH1 *hdistV1 = new TH1F("hdistV1", "Drift Distances for V1 Plane",200, 0, 0.02);
-  TH2 *horigin = new TH2F("horigin","Origin Y vs. X",100,-1.2,1.2,100,-.1,.1);
-  TH1 *hdrift = new TH1F("hdrift","Drift Time", 100, 1000, 2000);
-  TH1 *hdriftNoise = new TH1F ("hdriftNoise", "Drift Time (With Noise)", 100, 1000, 2000);
-  TH2 *hdrift2 = new TH2F("hdrift2", "Drift Time vs Num Wires in Cluster",
-			   6, 3, 9, 100, 1000, 2000);
-  TH1 *hdeltaT4 = new TH1F ("hdeltaT4", "Relative Time (4 hits)", 200, -100, 100);
-  TH1 *hdeltaTNoise4 = new TH1F ("hdeltaTNoise4", "Relative Time (4 hits w/ Noise)", 200, -100, 100);
-  TH1 *hdeltaT5 = new TH1F ("hdeltaT5", "Relative Time (5 hits)", 200, -100, 100);
-  TH1 *hdeltaTNoise5 = new TH1F ("hdeltaTNoise5", "Relative Time (5 hits w/ Noise)", 200, -100, 100);
-  TH1 *hdeltaT6 = new TH1F ("hdeltaT6", "Relative Time (6 hits)", 200, -100, 100);
-  TH1 *hdeltaTNoise6 = new TH1F ("hdeltaTNoise6", "Relative Time (6 hits w/ Noise)", 200, -100, 100);
-  TH1 *hnumtracks = new TH1F ( "hnumtracks", "Number of Tracks Per Event", 5, 0, 5);
-
-  THaVDCSimEvent *event = new THaVDCSimEvent;
-  TTree *tree = new TTree("tree","VDC Track info");
-  //TBranch *eventBranch = tree->Branch("event", "THaVDCSimEvent", &event);
-  // avoid unused variable warning ;)
-  tree->Branch("event", "THaVDCSimEvent", &event);
-
-  //open text file to put track info into
-  bool do_text = !(s->textFile.IsNull());
-  ofstream textFile;
-  if( do_text ) {
-    textFile.open(s->textFile, ios::out);
-    if(!textFile.is_open())
-      cout << "Error Opening Text File\n";
+//______________________________________________________________________________
+void VDCSimGenerator::GenerateEvent( EventRandom& rnd, VDCSimHistos& h,
+                                     THaVDCSimEvent* event, ostream* text ) const
+{
+  // Generate the tracks and wire hits of one event. The random number
+  // sequence of the event must have been set up by the caller.
 
-    //write important sim conditions to text file
-    textFile << "******Simulation Conditions******\n"
-	     << "Output File Name = " << s->filename << endl
-	     << "Database File Read = " << s->databaseFile << endl
-	     << "Number of Trials = " << s->numTrials << endl
-	     << "Noise Sigma = " << s->noiseSigma << " ns\n"
-	     << "Wire Efficiency = " << s->wireEff << endl
-	     << "Emission Rate = " << s->emissionRate << " particle/ns\n"
-	     << "TDC Time Window = " << s->tdcTimeLimit << " ns\n"
-	     << "Probability of Random Wire Firing = " << s->probWireNoise << "\n\n";
+  //set track type and track number each time loop executes
+  Int_t tracktype = 0, tracknum = 0;
+  THaVDCSimTrack track;
+  if( text )
+    *text << "\nEvent: " << event->event_num << endl
+	  << "***************************************\n";
+
+newtrk:
+  track.Clear();
+  track.type = tracktype;
+  track.track_num = tracknum;
+
+  // create randomized origin and momentum vectors for trigger and coincident tracks
+  if(track.type >= 0 && track.type <= 2){
+    track.origin.SetXYZ(rnd.Rndm()*(s->x2-s->x1) + s->x1,
+			 rnd.Gaus(s->ymean, s->ysigma), s->z0);
+    track.momentum.SetXYZ(0,0,s->pmag0);
+    track.momentum.SetTheta(rnd.Gaus(s->pthetamean, s->pthetasigma));
+    track.momentum.SetPhi(rnd.Gaus(s->pphimean, s->pphisigma));
   }
 
-  //  Int_t numSecondTracks = 0, numThirdTracks = 0;
-  Int_t numRandomWires = 0;
-  //create numTrials simulated tracks
-  THaVDCSimTrack track;
-  for ( Int_t iev=0; iev < s->numTrials; iev++) {
+  //write track info to text file
+  if( text )
+    *text << "Track number = " << tracknum << ", type = " << tracktype << endl
+	     << "Origin = ( " << track.origin.X() << ", " << track.origin.Y() << ", "
+	     << track.origin.Z() << " )" << endl
+	     << "Momentum = ( " << track.momentum.X() << ", "
+	     << track.momentum.Y() <<", " << track.momentum.Z() << " )\n";
+
+  //Fill histogram with origin position
+  h.origin->Fill(track.X(), track.Y());
+
+  //generate a time offset for the track
+  if(track.type == 0)
+    track.timeOffset = 0.0;
+  //FIXME!! the linear approximation isn't correct!
+  else if(track.type == 1)
+    track.timeOffset = rnd.Rndm()*s->tdcTimeLimit;
+  //if it's a third track, increase the time offset by random number
+  //(i.e. must be after 2nd track)
+  else if(track.type == 2)
+    track.timeOffset += rnd.Rndm()*s->tdcTimeLimit;
+  //****Note******* 
+  //Here we use a linear approximation of the exponential 
+  //probability of s->timeOffset. 
+  //Assuming low emission rates (< 10kHz) and time windows of ~100 ms, this is acceptable.
+
+  //fill track information
+  event->tracks.push_back(track);
+
+  //run through each plane (u1, v1, u2, v2)
+  for (Int_t j=0; j < 4; j++) 
+  {
+//       //calculate time it takes to hit wire plane and the position at which it hits
+//       Double_t travelTime = (s->wireHeight[j]-track.origin.Z())/track.momentum.Z();
+//       TVector3 position = track.origin + travelTime*track.momentum;
 
-    //set track type, track number, and event number each time loop executes
-    Int_t tracktype = 0, tracknum = 0;
-    event->event_num = iev + 1;
-    if( do_text )
-      textFile << "\nEvent: " << event->event_num << endl 
-	       << "***************************************\n";
-
-  newtrk:
-    track.Clear();
-    track.type = tracktype;
-    track.track_num = tracknum;
-
-    // create randomized origin and momentum vectors for trigger and coincident tracks
-    if(track.type >= 0 && track.type <= 2){
-      track.origin.SetXYZ(gRandom->Rndm(1)*(s->x2-s->x1) + s->x1,
-			   gRandom->Gaus(s->ymean, s->ysigma), s->z0);
-      track.momentum.SetXYZ(0,0,s->pmag0);
-      track.momentum.SetTheta(gRandom->Gaus(s->pthetamean, s->pthetasigma));
-      track.momentum.SetPhi(gRandom->Gaus(s->pphimean, s->pphisigma));
+    // Calculate intersection point of track with current wire plane
+
+    Double_t pathlen;
+    TVector3 position;
+    if( !IntersectPlaneWithRay( vdcx, vdcy, planeOrigin[j],
+				track.origin, track.momentum,
+				pathlen, position ))	continue;
+
+    //Calculate TRANSPORT coordinates of the track w.r.t. the u1 plane coordinates
+    if(j == 0){
+      TVector3 v(position);
+      v -= planeOrigin[j];
+      track.ray[0] = v.Dot(vdcx);
+      track.ray[1] = v.Dot(vdcy);
+      if(track.momentum.Dot(vdcz) != 0.0){
+	track.ray[2] = track.momentum.Dot(vdcx)/track.momentum.Dot(vdcz);
+	track.ray[3] = track.momentum.Dot(vdcy)/track.momentum.Dot(vdcz);
+      } else{
+	track.ray[2] = 0.0;
+	track.ray[3] = 0.0;
+      }	
+      track.ray[4] = 0.0;  //By definition - we take the u1 plane as reference
+      if( text )
+	*text << "Position (x, y, Theta, Phi, z) = \t( "
+		 << track.ray[0] << ",\t" << track.ray[1] << ",\t"
+		 << track.ray[2] << ",\t" << track.ray[3] <<", \t"
+		 << track.ray[4] << " )\n";
+    }
+    if( text )
+      *text << "\nPlane: " << j << endl;
+
+    // compute tanThetaPrime - the angle between the VDC u(v)-axis and the
+    // projection of the track into the u(v)-z plane
+    // NB: this value can be different for each plane, so we need to recompute
+    // it here, inside the loop.
+    // FIXME: this assumes that wireAngle = +/- 45 deg
+    Double_t tanThetaPrime{sqrt(2.0)};
+    if(j%2 == 0)
+      tanThetaPrime /= (track.ray[2] - track.ray[3]);
+    else
+      tanThetaPrime /= (track.ray[2] + track.ray[3]);
+
+    // The cluster slopes are defined wrt the z-axis:
+    track.slope[j] = 1.0/tanThetaPrime;
+
+    // Get position into (u,v,z) coordinates for u plane
+    // (v,-u,z) coordinates for v plane - in the VDC coordinates, NOT lab
+    TVector3 uvpos( (position-planeOrigin[j]).Dot(vdcx),
+		    (position-planeOrigin[j]).Dot(vdcy),
+		    s->wireHeight[j] );
+    uvpos.RotateZ( -wireAngle[j] );
+
+    // Find the range of wire numbers that this track hit
+
+    // position of intercept wrt to u(v)-origin in terms of wire spacings
+    Double_t x = (uvpos.X() - wireOffset[j]) / wireSpacing[j];
+    track.xover[j] = uvpos.X();
+
+    // First and last wire number hit. Must round to the nearest integer.
+    Double_t w = s->cellHeight / 2.0 / tanThetaPrime / fabs(wireSpacing[j]);
+    Int_t wirehitFirst = lround(x - w);
+    Int_t wirehitLast  = lround(x + w);
+
+    // Parameters for time-to-distance conversion
+    Double_t a1 = 0.0, a2 = 0.0;
+
+    // Find the values of a1 and a2 by evaluating the proper polynomials
+    // a = A_3 * x^3 + A_2 * x^2 + A_1 * x + A_0
+    for (Int_t i = 3; i >= 1; i--) {
+      a1 = tanThetaPrime * (a1 + fA1tdcCor[i]);
+      a2 = tanThetaPrime * (a2 + fA2tdcCor[i]);
+    }
+    a1 += fA1tdcCor[0];
+    a2 += fA2tdcCor[0];
+
+    if( text )
+      *text << "Plane " << j << ": \n";
+
+    Int_t numwires = wirehitLast - wirehitFirst + 1;
+
+    bool aWireFailed = false;
+    bool hitOutOfBounds = false;
+    bool negativeTDC = false;
+    Int_t times[numwires];
+    Int_t noiseTimes[numwires];         //arrays to hold times (to calc. relative time)
+    Double_t distances[numwires];  //array to hold distances
+    Int_t counter = -1;
+    //initialize arrays to zero
+    for(int m = 0; m < numwires ; m++){
+      times[m] = 0;
+      noiseTimes[m] = 0;
+      distances[m] = 0.0;
     }
 
-    //write track info to text file
-    if( do_text )
-      textFile << "Track number = " << tracknum << ", type = " << tracktype << endl
-	       << "Origin = ( " << track.origin.X() << ", " << track.origin.Y() << ", "
-	       << track.origin.Z() << " )" << endl
-	       << "Momentum = ( " << track.momentum.X() << ", "
-	       << track.momentum.Y() <<", " << track.momentum.Z() << " )\n";
-
-    //Fill histogram with origin position
-    horigin->Fill(track.X(), track.Y());
-
-    //generate a time offset for the track
-    if(track.type == 0)
-      track.timeOffset = 0.0;
-    //FIXME!! the linear approximation isn't correct!
-    else if(track.type == 1)
-      track.timeOffset = gRandom->Rndm(1)*s->tdcTimeLimit;
-    //if it's a third track, increase the time offset by random number
-    //(i.e. must be after 2nd track)
-    else if(track.type == 2)
-      track.timeOffset += gRandom->Rndm(1)*s->tdcTimeLimit;
-    //****Note******* 
-    //Here we use a linear approximation of the exponential 
-    //probability of s->timeOffset. 
-    //Assuming low emission rates (< 10kHz) and time windows of ~100 ms, this is acceptable.
-
-    //fill track information
-    event->tracks.push_back(track);
-
-    //run through each plane (u1, v1, u2, v2)
-    for (Int_t j=0; j < 4; j++) 
+    //write actually hit wires to text file
+    if( text ) {
+      *text << "\n\nReal Hits:\nWires Hit: \t\t";
+      for(int m = wirehitFirst; m <= wirehitLast; m++)
+	*text << m << "\t\t";
+      *text << endl << "Hit Times (ns) = \t";
+    }
+
+    //loop through each hit wire
+    for (Int_t k=wirehitFirst; k<=wirehitLast; k++) 
     {
-//       //calculate time it takes to hit wire plane and the position at which it hits
-//       Double_t travelTime = (s->wireHeight[j]-track.origin.Z())/track.momentum.Z();
-//       TVector3 position = track.origin + travelTime*track.momentum;
+      // create a new hit
+      THaVDCSimWireHit hit;
+
+      hit.wirenum = k;
+      hit.pos = wireOffset[j] + k*wireSpacing[j];
+      counter++;
+
+      // distance from crossing point to wire "k"
+      Double_t d = (x - k) * wireSpacing[j];
+      // Actual drift distance 
+      // - perpendicular distance from wire center to track (meters)
+      Double_t d0 = TMath::Abs(d)*tanThetaPrime;
+      hit.distance = d0;
+
+      // Apply angle-dependent time correction to account for the
+      // non-linear dependence of drift time on the drift distance.
+      // Inversion of THaVDCAnalyticTTDConv::ConvertTimeToDist
+      if (d0 > a1 + a2) 
+	d0 -= a2;
+      else 
+	d0 /= (1+a2/a1);
+
+      hit.rawTime = d0/s->driftVelocities[j];
+
+      if( text )
+	*text << hit.rawTime << "\t\t";
+
+      //convert rawTime to tdctime
+      hit.rawTDCtime =
+	static_cast<Int_t>( timeOffsets[k+j*s->numWires] - 
+			    s->tdcConvertFactor*(hit.rawTime + track.timeOffset) );
+
+      // Correction for the velocity of the track
+      // This correction is negligible, because of high momentum
+
+      // Ignoring this correction permits momentum to have any
+      // magnitude with no effect on the results
+      //+ d*sqrt(pow(tanThetaPrime,2)+1)/track.momentum.Mag()
+
+      // Correction for ionization drift velocities
+
+      // reject data that the noise filter would
+      // This shouldn't affect our data at all
+      /*
+	if (d0 < -.5 * .013 ||
+	d0 > 1.5 * .013) {
+	delete hit;
+	continue;
+	}
+      */
 
-      // Calculate intersection point of track with current wire plane
-
-      Double_t pathlen;
-      TVector3 position;
-      if( !IntersectPlaneWithRay( vdcx, vdcy, planeOrigin[j],
-				  track.origin, track.momentum,
-				  pathlen, position ))	continue;
-
-      //Calculate TRANSPORT coordinates of the track w.r.t. the u1 plane coordinates
-      if(j == 0){
-	TVector3 v(position);
-	v -= planeOrigin[j];
-	track.ray[0] = v.Dot(vdcx);
-	track.ray[1] = v.Dot(vdcy);
-	if(track.momentum.Dot(vdcz) != 0.0){
-	  track.ray[2] = track.momentum.Dot(vdcx)/track.momentum.Dot(vdcz);
-	  track.ray[3] = track.momentum.Dot(vdcy)/track.momentum.Dot(vdcz);
-	} else{
-	  track.ray[2] = 0.0;
-	  track.ray[3] = 0.0;
-	}	
-	track.ray[4] = 0.0;  //By definition - we take the u1 plane as reference
-	if( do_text )
-	  textFile << "Position (x, y, Theta, Phi, z) = \t( "
-		   << track.ray[0] << ",\t" << track.ray[1] << ",\t"
-		   << track.ray[2] << ",\t" << track.ray[3] <<", \t"
-		   << track.ray[4] << " )\n";
-      }
-      if( do_text )
-	textFile << "\nPlane: " << j << endl;
-
-      // compute tanThetaPrime - the angle between the VDC u(v)-axis and the
-      // projection of the track into the u(v)-z plane
-      // NB: this value can be different for each plane, so we need to recompute
-      // it here, inside the loop.
-      // FIXME: this assumes that wireAngle = +/- 45 deg
-      Double_t tanThetaPrime{sqrt(2.0)};
-      if(j%2 == 0)
-  	tanThetaPrime /= (track.ray[2] - track.ray[3]);
-      else
-	tanThetaPrime /= (track.ray[2] + track.ray[3]);
-
-      // The cluster slopes are defined wrt the z-axis:
-      track.slope[j] = 1.0/tanThetaPrime;
-
-      // Get position into (u,v,z) coordinates for u plane
-      // (v,-u,z) coordinates for v plane - in the VDC coordinates, NOT lab
-      TVector3 uvpos( (position-planeOrigin[j]).Dot(vdcx),
-		      (position-planeOrigin[j]).Dot(vdcy),
-		      s->wireHeight[j] );
-      uvpos.RotateZ( -wireAngle[j] );
-     
-      // Find the range of wire numbers that this track hit
-      
-      // position of intercept wrt to u(v)-origin in terms of wire spacings
-      Double_t x = (uvpos.X() - wireOffset[j]) / wireSpacing[j];
-      track.xover[j] = uvpos.X();
-
-      // First and last wire number hit. Must round to the nearest integer.
-      Double_t w = s->cellHeight / 2.0 / tanThetaPrime / fabs(wireSpacing[j]);
-      Int_t wirehitFirst = lround(x - w);
-      Int_t wirehitLast  = lround(x + w);
-      
-      // Parameters for time-to-distance conversion
-      Double_t a1 = 0.0, a2 = 0.0;
-      
-      // Find the values of a1 and a2 by evaluating the proper polynomials
-      // a = A_3 * x^3 + A_2 * x^2 + A_1 * x + A_0
-      for (Int_t i = 3; i >= 1; i--) {
-	a1 = tanThetaPrime * (a1 + fA1tdcCor[i]);
-	a2 = tanThetaPrime * (a2 + fA2tdcCor[i]);
+      //time with additional noise to account for random walk nature of ions
+      hit.time =
+	static_cast <Int_t>( hit.rawTDCtime +
+			     s->tdcConvertFactor*(rnd.Gaus(s->noiseMean, s->noiseSigma)) ); 
+
+      //check to assure hit is within bounds	
+      if (hit.wirenum < 0 || hit.wirenum > s->numWires - 1){
+	hitOutOfBounds = true;
+	continue;
       }
-      a1 += fA1tdcCor[0];
-      a2 += fA2tdcCor[0];
-      
-      if( do_text )
-	textFile << "Plane " << j << ": \n";
-      
-      Int_t numwires = wirehitLast - wirehitFirst + 1;
-
-      bool aWireFailed = false;
-      bool hitOutOfBounds = false;
-      bool negativeTDC = false;
-      Int_t times[numwires];
-      Int_t noiseTimes[numwires];         //arrays to hold times (to calc. relative time)
-      Double_t distances[numwires];  //array to hold distances
-      Int_t counter = -1;
-      //initialize arrays to zero
-      for(int m = 0; m < numwires ; m++){
-	times[m] = 0;
-	noiseTimes[m] = 0;
-	distances[m] = 0.0;
+
+      //make sure hit time falls within time tdc is open
+      if (hit.time < 0){
+	negativeTDC = true;
+	continue;
       }
 
-      //write actually hit wires to text file
-      if( do_text ) {
-	textFile << "\n\nReal Hits:\nWires Hit: \t\t";
-	for(int m = wirehitFirst; m <= wirehitLast; m++)
-	  textFile << m << "\t\t";
-	textFile << endl << "Hit Times (ns) = \t";
+      //simulate efficiency of wires.
+      double workFail = rnd.Rndm();
+      if(workFail > s->wireEff){
+	hit.wireFail = true;
+	aWireFailed = true;
+	continue;
       }
 
-      //loop through each hit wire
-      for (Int_t k=wirehitFirst; k<=wirehitLast; k++) 
+      //fill arrays for times if hit still exists
+      //note: if hit doesn't exist, value will be default of 0
+      times[counter] = hit.rawTDCtime;
+      noiseTimes[counter] = hit.time;
+      distances[counter] = hit.distance;
+
+      //fill wire hit histograms for each plane
+      if(j == 0)
+	h.wireU1->Fill(k);
+      else if(j == 2)
+	h.wireU2->Fill(k);
+      else if(j == 3)
+	h.wireV2->Fill(k);
+
+      //fill histograms for v1 plane
+      if (j == 1) 
       {
-	// create a new hit
-	THaVDCSimWireHit hit;
-
-	hit.wirenum = k;
-	hit.pos = wireOffset[j] + k*wireSpacing[j];
-	counter++;
-
-	// distance from crossing point to wire "k"
-	Double_t d = (x - k) * wireSpacing[j];
-	// Actual drift distance 
-	// - perpendicular distance from wire center to track (meters)
-	Double_t d0 = TMath::Abs(d)*tanThetaPrime;
-	hit.distance = d0;
-	
-	// Apply angle-dependent time correction to account for the
-	// non-linear dependence of drift time on the drift distance.
-	// Inversion of THaVDCAnalyticTTDConv::ConvertTimeToDist
-	if (d0 > a1 + a2) 
-	  d0 -= a2;
-	else 
-	  d0 /= (1+a2/a1);
-	
-	hit.rawTime = d0/s->driftVelocities[j];
-	  
-	if( do_text )
-	  textFile << hit.rawTime << "\t\t";
-
-	//convert rawTime to tdctime
-	hit.rawTDCtime =
-	  static_cast<Int_t>( timeOffsets[k+j*s->numWires] - 
-			      s->tdcConvertFactor*(hit.rawTime + track.timeOffset) );
-
-	// Correction for the velocity of the track
-	// This correction is negligible, because of high momentum
-	
-	// Ignoring this correction permits momentum to have any
-	// magnitude with no effect on the results
-	//+ d*sqrt(pow(tanThetaPrime,2)+1)/track.momentum.Mag()
-	
-	// Correction for ionization drift velocities
-	
-	// reject data that the noise filter would
-	// This shouldn't affect our data at all
-	/*
-	  if (d0 < -.5 * .013 ||
-	  d0 > 1.5 * .013) {
-	  delete hit;
-	  continue;
+	h.timeV1->Fill(hit.rawTime * 1e-9);
+	h.drift->Fill((hit.rawTDCtime));
+	h.driftNoise->Fill((hit.time));
+	h.drift2->Fill(wirehitLast-wirehitFirst+1, hit.time);
+	h.wireV1->Fill(k);
+	h.distV1->Fill(hit.distance);
+      }
+
+      //fill wirehit information
+      event->wirehits[j].push_back(hit);
+      track.hits[j].push_back(hit);
+
+    } //closes loop going through each hit wire
+
+    //check for random noise hits and write info to text file
+    //only do it if there is actually a probability of wire noise
+    if(s->probWireNoise != 0.0){
+
+      if( text )
+	*text << "\nRandom Noise Hits: \nWires Hit: \t\t";
+
+      Int_t noiseHitTDCs[static_cast<Int_t>(s->probWireNoise*s->numWires)+1]; 
+      Int_t counter2 = -1;
+      for(int n = 0; n < s->numWires; n++){
+	//roll die to see if wire fires
+	double randomFire = rnd.Rndm();
+	if(randomFire <= s->probWireNoise){
+	  counter2++;
+
+	  //declare new hit class
+	  THaVDCSimWireHit hit;
+
+	  hit.wirenum = n;
+	  hit.pos = wireOffset[j] + n*wireSpacing[j];
+	  if( text )
+	    *text << n << "\t\t";
+	  hit.type = 1;
+
+	  //set random tdc time within time window
+	  hit.time = static_cast<Int_t>(rnd.Rndm()*s->tdcTimeLimit);
+	  noiseHitTDCs[counter2] = hit.time;
+	  //NOTE: distance, rawTime, and rawTDCtime will stay as default 0 for these hits
+
+	  //fill wire hit histograms for each plane
+	  if(j == 0)
+	    h.wireU1->Fill(n);
+	  else if(j == 2)
+	    h.wireU2->Fill(n);
+	  else if(j == 3)
+	    h.wireV2->Fill(n);
+
+	  //fill histograms for v1 plane
+	  if (j == 1) {
+	    h.drift->Fill((hit.time));
+	    h.driftNoise->Fill((hit.time));
+	    h.wireV1->Fill(n);
 	  }
-	*/
-	
-	//time with additional noise to account for random walk nature of ions
-	hit.time =
-	  static_cast <Int_t>( hit.rawTDCtime +
-			       s->tdcConvertFactor*(gRandom->Gaus(s->noiseMean, s->noiseSigma)) ); 
-
-	//check to assure hit is within bounds	
-	if (hit.wirenum < 0 || hit.wirenum > s->numWires - 1){
-	  hitOutOfBounds = true;
-	  continue;
-	}
-	
-	//make sure hit time falls within time tdc is open
-	if (hit.time < 0){
-	  negativeTDC = true;
-	  continue;
-	}
-	
-	//simulate efficiency of wires.
-	double workFail = gRandom->Rndm(1);
-	if(workFail > s->wireEff){
-	  hit.wireFail = true;
-	  aWireFailed = true;
-	  continue;
-	}
-	
-	//fill arrays for times if hit still exists
-	//note: if hit doesn't exist, value will be default of 0
-	times[counter] = hit.rawTDCtime;
-	noiseTimes[counter] = hit.time;
-	distances[counter] = hit.distance;
-
-	//fill wire hit histograms for each plane
-	if(j == 0)
-	  hwireU1->Fill(k);
-	else if(j == 2)
-	  hwireU2->Fill(k);
-	else if(j == 3)
-	  hwireV2->Fill(k);
-
-	//fill histograms for v1 plane
-	if (j == 1) 
-	{
-          htimeV1->Fill(hit.rawTime * 1e-9);
-	  hdrift->Fill((hit.rawTDCtime));
-	  hdriftNoise->Fill((hit.time));
-	  hdrift2->Fill(wirehitLast-wirehitFirst+1, hit.time);
-	  hwireV1->Fill(k);
-	  hdistV1->Fill(hit.distance);
-	}
 
-	//fill wirehit information
-        event->wirehits[j].push_back(hit);
-	track.hits[j].push_back(hit);
-
-      } //closes loop going through each hit wire
-
-      //check for random noise hits and write info to text file
-      //only do it if there is actually a probability of wire noise
-      if(s->probWireNoise != 0.0){
-
-	if( do_text )
-	  textFile << "\nRandom Noise Hits: \nWires Hit: \t\t";
-	
-	Int_t noiseHitTDCs[static_cast<Int_t>(s->probWireNoise*s->numWires)+1]; 
-	Int_t counter2 = -1;
-	for(int n = 0; n < s->numWires; n++){
-	  //roll die to see if wire fires
-	  double randomFire = gRandom->Rndm(1);
-	  if(randomFire <= s->probWireNoise){
-	    counter2++;
-	    
-	    //declare new hit class
-            THaVDCSimWireHit hit;
-	    numRandomWires++;
-	    
-	    hit.wirenum = n;
-	    hit.pos = wireOffset[j] + n*wireSpacing[j];
-	    if( do_text )
-	      textFile << n << "\t\t";
-	    hit.type = 1;
-	    
-	    //set random tdc time within time window
-	    hit.time = static_cast<Int_t>(gRandom->Rndm(1)*s->tdcTimeLimit);
-	    noiseHitTDCs[counter2] = hit.time;
-	    //NOTE: distance, rawTime, and rawTDCtime will stay as default 0 for these hits
-	  
-	    //fill wire hit histograms for each plane
-	    if(j == 0)
-	      hwireU1->Fill(n);
-	    else if(j == 2)
-	      hwireU2->Fill(n);
-	    else if(j == 3)
-	      hwireV2->Fill(n);
-	    
-	    //fill histograms for v1 plane
-	    if (j == 1) {
-	      hdrift->Fill((hit.time));
-	      hdriftNoise->Fill((hit.time));
-	      hwireV1->Fill(n);
-	    }
-	    
-	    //fill wirehit information
-	    event->wirehits[j].push_back(hit);
-	    track.hits[j].push_back(hit);
-	  }//closes if(random wire fires) loop
-	  
-	}//closes loop running through each wire
-
-	if( do_text ) {
-	  textFile << "\nTDC Times: \t\t";
-	  for( Int_t n = 0; n <= counter2; n++)
-	    textFile << noiseHitTDCs[n] << "\t\t";
-	}
-      }
+	  //fill wirehit information
+	  event->wirehits[j].push_back(hit);
+	  track.hits[j].push_back(hit);
+	}//closes if(random wire fires) loop
 
-      // Get number of good wires in this plane for this event
-      const auto& hitlist = event->wirehits[j];
-      numwires = hitlist.size();
+      }//closes loop running through each wire
 
-      if( verbose ) {
-	cout << "Plane " << j << endl;
-        for( const auto& hit : hitlist )
-          hit.Print();
+      if( text ) {
+	*text << "\nTDC Times: \t\t";
+	for( Int_t n = 0; n <= counter2; n++)
+	  *text << noiseHitTDCs[n] << "\t\t";
       }
+    }
+
+    // Get number of good wires in this plane for this event
+    const auto& hitlist = event->wirehits[j];
+    numwires = hitlist.size();
 
-      // go through tlist and get data
-      if( do_text ) {
-        textFile << "Wires Hit = \t\t";
-        for( const auto& hit : hitlist )
-          textFile << hit.wirenum << "\t\t";
-	textFile << endl << "Hit Times (ns) = \t";
-        for( const auto& hit : hitlist )
-          textFile << hit.rawTime << "\t\t";
-	textFile << endl << "Raw TDC Times = \t";
-        for( const auto& hit : hitlist )
-	  textFile << hit.rawTDCtime << "\t\t";
-	textFile << endl << "Final TDC Times = \t";
-        for( const auto& hit : hitlist )
-	  textFile << hit.time << "\t\t";
-	textFile << endl << "Drift Distances = \t";
-        for( const auto& hit : hitlist ) {
-          textFile << hit.distance << "\t";
-          if( hit.distance == 0.0 )
-            textFile << "\t";
-        }
-
-        // Print info about imperfect events
-	textFile << endl;
-	if(hitOutOfBounds)
-	  textFile << "\tHit(s) Out of Bounds\n";
-	if(negativeTDC)
-	  textFile << "\tNegative TDC Time(s)\n";
-	if(aWireFailed)
-	  textFile << "\tWire failure(s)\n";
+    if( verbose ) {
+      cout << "Plane " << j << endl;
+      for( const auto& hit : hitlist )
+	hit.Print();
+    }
+
+    // go through tlist and get data
+    if( text ) {
+      *text << "Wires Hit = \t\t";
+      for( const auto& hit : hitlist )
+	*text << hit.wirenum << "\t\t";
+      *text << endl << "Hit Times (ns) = \t";
+      for( const auto& hit : hitlist )
+	*text << hit.rawTime << "\t\t";
+      *text << endl << "Raw TDC Times = \t";
+      for( const auto& hit : hitlist )
+	*text << hit.rawTDCtime << "\t\t";
+      *text << endl << "Final TDC Times = \t";
+      for( const auto& hit : hitlist )
+	*text << hit.time << "\t\t";
+      *text << endl << "Drift Distances = \t";
+      for( const auto& hit : hitlist ) {
+	*text << hit.distance << "\t";
+	if( hit.distance == 0.0 )
+	  *text << "\t";
       }
 
-      //set the number of wires that actually were hit 
-      //(correcting for failed wires, out of bound hits, negative tdc time hits.)
-      numwires = track.hits[j].size();
+      // Print info about imperfect events
+      *text << endl;
+      if(hitOutOfBounds)
+	*text << "\tHit(s) Out of Bounds\n";
+      if(negativeTDC)
+	*text << "\tNegative TDC Time(s)\n";
+      if(aWireFailed)
+	*text << "\tWire failure(s)\n";
+    }
 
-      //fill number of wire histograms for each plane
-      if(j == 0)      
-	hnumwiresU1->Fill(numwires);
-      else if(j == 1)
-	hnumwiresV1->Fill(numwires);
-      else if(j == 2)
-	hnumwiresU2->Fill(numwires);
-      else
-	hnumwiresV2->Fill(numwires);
-
-      // calculate relative time and store in histograms for 4, 5, and 6 hits
-      // use 10^38 if a wire failed during the hit (since resolution would be completely lost!)
-      if(aWireFailed){
-        if(numwires == 4){
-	  hdeltaTNoise4->Fill(1e38);
-	  hdeltaT4->Fill(1e38);
+    //set the number of wires that actually were hit 
+    //(correcting for failed wires, out of bound hits, negative tdc time hits.)
+    numwires = track.hits[j].size();
+
+    //fill number of wire histograms for each plane
+    if(j == 0)      
+      h.numwiresU1->Fill(numwires);
+    else if(j == 1)
+      h.numwiresV1->Fill(numwires);
+    else if(j == 2)
+      h.numwiresU2->Fill(numwires);
+    else
+      h.numwiresV2->Fill(numwires);
+
+    // calculate relative time and store in histograms for 4, 5, and 6 hits
+    // use 10^38 if a wire failed during the hit (since resolution would be completely lost!)
+    if(aWireFailed){
+      if(numwires == 4){
+	h.deltaTNoise4->Fill(1e38);
+	h.deltaT4->Fill(1e38);
+      }
+      else if(numwires == 5){
+	h.deltaTNoise5->Fill(1e38);
+	h.deltaT5->Fill(1e38);
+      }
+      else if(numwires == 6){
+	h.deltaTNoise6->Fill(1e38);
+	h.deltaT6->Fill(1e38);
+      }
+    } else {
+      if(numwires == 4)
+	{
+	  h.deltaTNoise4->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[3] - noiseTimes[2]));
+	  h.deltaT4->Fill((times[0] - times[1]) - (times[3] - times[2]));
 	}
-        else if(numwires == 5){
-          hdeltaTNoise5->Fill(1e38);
-	  hdeltaT5->Fill(1e38);
-        }
-        else if(numwires == 6){
-	  hdeltaTNoise6->Fill(1e38);
-	  hdeltaT6->Fill(1e38);
+      else if(numwires == 5)
+	{
+	  h.deltaTNoise5->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[4] - noiseTimes[3]));
+	  h.deltaT5->Fill((times[0] - times[1]) - (times[4] - times[3]));
 	}
-      } else {
-	if(numwires == 4)
-	  {
-	    hdeltaTNoise4->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[3] - noiseTimes[2]));
-	    hdeltaT4->Fill((times[0] - times[1]) - (times[3] - times[2]));
-	  }
-	else if(numwires == 5)
-	  {
-	    hdeltaTNoise5->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[4] - noiseTimes[3]));
-	    hdeltaT5->Fill((times[0] - times[1]) - (times[4] - times[3]));
-	  }
-	else if(numwires == 6)
-	  {
-	    hdeltaTNoise6->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[5] - noiseTimes[4]));
-	    hdeltaT6->Fill((times[0] - times[1]) - (times[5] - times[4]));
-	  }
-       }
+      else if(numwires == 6)
+	{
+	  h.deltaTNoise6->Fill((noiseTimes[0] - noiseTimes[1]) - (noiseTimes[5] - noiseTimes[4]));
+	  h.deltaT6->Fill((times[0] - times[1]) - (times[5] - times[4]));
+	}
+     }
 
-    }//closes loop going through each plane
+  }//closes loop going through each plane
 
-    //if target track , decide if there will be coincident track
-    if(track.type == 0){
-       double secondTrack = gRandom->Rndm(1);
-       if( secondTrack <= probability ){
-	tracktype = 1;
-	tracknum++;
-	//numSecondTracks++;
-	goto newtrk;  //go back to where new tracks are created, still within the same event
+  //if target track , decide if there will be coincident track
+  if(track.type == 0){
+     double secondTrack = rnd.Rndm();
+     if( secondTrack <= probability ){
+      tracktype = 1;
+      tracknum++;
+      //numSecondTracks++;
+      goto newtrk;  //go back to where new tracks are created, still within the same event
 
-       }
+     }
+  }
+  //if it's a secondary track, decide if there will be tertiary track
+  else if(track.type == 1){
+    double thirdTrack = rnd.Rndm();
+    if( thirdTrack <= probability){
+      tracktype = 2;
+      tracknum++;
+      //numThirdTracks++;
+      goto newtrk;   //go back to where new tracks are created, still within same event
     }
-    //if it's a secondary track, decide if there will be tertiary track
-    else if(track.type == 1){
-      double thirdTrack = gRandom->Rndm(1);
-      if( thirdTrack <= probability){
-	tracktype = 2;
-	tracknum++;
-	//numThirdTracks++;
-	goto newtrk;   //go back to where new tracks are created, still within same event
+  }
+
+  //*******all tracks for the single event have now been generated*******
+
+  if( verbose ) {
+    for( const auto& trk : event->tracks )
+      trk.Print();
+  }
+
+  //fill histogram of number of tracks per event
+  h.numtracks->Fill(tracknum + 1);
+}
+
+//______________________________________________________________________________
+struct VDCSimChunk {
+  // Consecutive events generated by one thread, waiting to be written
+  vector<THaVDCSimEvent> events;
+  ostringstream text;
+};
+
+//______________________________________________________________________________
+int vdcsimgen( THaVDCSimConditions* s )
+{
+  // Verbose output goes directly to the terminal, so keep it in order
+  if( nthreads == 0 )
+    nthreads = max(thread::hardware_concurrency(), 1U);
+  if( verbose )
+    nthreads = 1;
+  if( nthreads > 1 )
+    ROOT::EnableThreadSafety();
+
+  // Create a new ROOT binary machine independent file.
+  // This file is now becoming the current directory.
+  TFile hfile(s->filename,"RECREATE","ROOT file for VDC simulation");
+
+  // Define the z-positions of the wire planes
+  THaVDCSimConditions::set(s->wireHeight,
+                           0.0, 0.026, 0.3348, 0.3609);
+
+  //hardcode prefixes for wire planes.
+  s->Prefixes[0] = "L.vdc.u1";
+  s->Prefixes[1] = "L.vdc.v1";
+  s->Prefixes[2] = "L.vdc.u2";
+  s->Prefixes[3] = "L.vdc.v2";
+
+  vector<Double_t> timeOffsets(4*s->numWires);
+
+  //get time offsets and drift velocities from the file (default is 20030415/L.vdc.dat)
+  Int_t getoffset = s->ReadDatabase(timeOffsets.data());
+  if(getoffset != 0) {
+    cout << "Error Reading Database file: " << s->databaseFile << endl;
+    exit(1);
+  }
+
+  const VDCSimGenerator gen(s, timeOffsets.data());
+
+  // Create some histograms, a profile histogram and an ntuple
+  VDCSimHistos histos;
+
+  THaVDCSimEvent *event = new THaVDCSimEvent;
+  TTree *tree = new TTree("tree","VDC Track info");
+  tree->Branch("event", "THaVDCSimEvent", &event);
+
+  //open text file to put track info into
+  bool do_text = !(s->textFile.IsNull());
+  ofstream textFile;
+  if( do_text ) {
+    textFile.open(s->textFile, ios::out);
+    if(!textFile.is_open())
+      cout << "Error Opening Text File\n";
+
+    //write important sim conditions to text file
+    textFile << "******Simulation Conditions******\n"
+	     << "Output File Name = " << s->filename << endl
+	     << "Database File Read = " << s->databaseFile << endl
+	     << "Number of Trials = " << s->numTrials << endl
+	     << "Random Seed = " << s->seed << endl
+	     << "Noise Sigma = " << s->noiseSigma << " ns\n"
+	     << "Wire Efficiency = " << s->wireEff << endl
+	     << "Emission Rate = " << s->emissionRate << " particle/ns\n"
+	     << "TDC Time Window = " << s->tdcTimeLimit << " ns\n"
+	     << "Probability of Random Wire Firing = " << s->probWireNoise << "\n\n";
+  }
+
+  // Split the events into chunks. Threads take the next chunk to work on
+  // from a shared counter. Finished chunks are written in order by the
+  // main thread. To limit memory use, threads do not run more than a
+  // few chunks ahead of the writer.
+  const Int_t chunksize = 1000;
+  const Int_t nchunks = (s->numTrials + chunksize - 1) / chunksize;
+  const Int_t maxahead = 4 * nthreads;
+  atomic<Int_t> nextchunk{0};
+  Int_t nwritten = 0;   // Number of chunks written
+  map<Int_t, unique_ptr<VDCSimChunk>> done;
+  mutex mtx;
+  condition_variable cv_done, cv_written;
+
+  auto worker = [&]( VDCSimHistos* h ) {
+    EventRandom rnd(s->seed);
+    Int_t ic;
+    while( (ic = nextchunk++) < nchunks ) {
+      {
+        unique_lock<mutex> lock(mtx);
+        cv_written.wait(lock, [&]{ return ic < nwritten + maxahead; });
       }
+      auto chunk = unique_ptr<VDCSimChunk>(new VDCSimChunk);
+      Int_t first = ic * chunksize;
+      Int_t last  = min(first + chunksize, s->numTrials);
+      chunk->events.resize(last - first);
+      for( Int_t iev = first; iev < last; iev++ ) {
+        THaVDCSimEvent* ev = &chunk->events[iev - first];
+        ev->event_num = iev + 1;
+        rnd.SetEvent(iev);
+        gen.GenerateEvent(rnd, *h, ev, do_text ? &chunk->text : nullptr);
+      }
+      {
+        lock_guard<mutex> lock(mtx);
+        done[ic] = std::move(chunk);
+      }
+      cv_done.notify_one();
     }
+  };
 
-    //*******all tracks for the single event have now been generated*******
-   
-    if( verbose ) {
-      for( const auto& trk : event->tracks )
-        trk.Print();
+  vector<unique_ptr<VDCSimHistos>> thread_histos;
+  vector<thread> threads;
+  for( UInt_t i = 0; i < nthreads; i++ ) {
+    thread_histos.emplace_back(new VDCSimHistos(Form("_t%u", i)));
+    threads.emplace_back(worker, thread_histos.back().get());
+  }
+
+  const auto t0 = chrono::steady_clock::now();
+  Int_t nevwritten = 0, nextprint = 100000;
+  for( Int_t ic = 0; ic < nchunks; ic++ ) {
+    unique_ptr<VDCSimChunk> chunk;
+    {
+      unique_lock<mutex> lock(mtx);
+      cv_done.wait(lock, [&]{ return done.find(ic) != done.end(); });
+      chunk = std::move(done[ic]);
+      done.erase(ic);
+      ++nwritten;
     }
+    cv_written.notify_all();
 
-    //fill histogram of number of tracks per event
-    hnumtracks->Fill(tracknum + 1);
-    
     //fill the tree with event information
-    //    eventBranch->Fill();
-    tree->Fill();
-
-    //clean up
-    //clear wirehits[j]
-    event->Clear();
-
-    //    cout << "I got here\t" << i << endl;
-   } //closes loop going through all the trials
+    for( auto& ev : chunk->events ) {
+      event->event_num = ev.event_num;
+      event->tracks.swap(ev.tracks);
+      for( Int_t j = 0; j < 4; j++ )
+        event->wirehits[j].swap(ev.wirehits[j]);
+      tree->Fill();
+    }
+    if( do_text )
+      textFile << chunk->text.str();
 
-  //cout << numSecondTracks << " second tracks\n" << numThirdTracks << " third tracks\n";
-  //  cout << numRandomWires << " random wires fired\n";
+    nevwritten += chunk->events.size();
+    if( nevwritten >= nextprint ) {
+      double t = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+      cout << nevwritten << " events, " << nevwritten/t << " events/s" << endl;
+      nextprint += 100000;
+    }
+  }
+  for( auto& t : threads )
+    t.join();
+  double elapsed = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+  cout << progname << ": " << nevwritten << " events in " << elapsed << " s";
+  if( elapsed > 0 )
+    cout << " (" << nevwritten/elapsed << " events/s)";
+  cout << " using " << nthreads << " thread" << (nthreads > 1 ? "s" : "")
+       << endl;
+
+  for( const auto& h : thread_histos )
+    histos.Add(*h);
+  thread_histos.clear();
 
   //close text file
   if( do_text ) {
@@ -811,32 +1143,10 @@ int vdcsimgen( THaVDCSimConditions* s )
   // Save objects in this file
   tree->Write();
   s->Write("s");
+  histos.Write();
 
-  hwireU1->Write();
-  hwireV1->Write();
-  hwireU2->Write();
-  hwireV2->Write();
-  htimeV1->Write();
-  hdistV1->Write();
-  hnumwiresU1->Write();
-  hnumwiresV1->Write();
-  hnumwiresU2->Write();
-  hnumwiresV2->Write();
-  horigin->Write();
-  hdrift->Write();
-  hdrift2->Write();
-  hdriftNoise->Write();
-  hdeltaT4->Write();
-  hdeltaTNoise4->Write();
-  hdeltaT5->Write();
-  hdeltaTNoise5->Write();
-  hdeltaT6->Write();
-  hdeltaTNoise6->Write();
-  hnumtracks->Write();
- 
   // Close the file.
   hfile.Close();
-  delete [] timeOffsets;
 
   return 0;
 }